@@ -0,0 +1,171 @@
+// MultiExchangeGateway book-update contention: 10 exchanges x 200 symbols, one writer
+// thread per exchange pushing books through a stub connector, with and without threads
+// reading the published snapshots. Reports writes/s and per-update latency.
+// Ten venues exceed ConsolidatedLevel::MAX_VENUES, so two stay out of the merged depth.
+#include "multi_exchange_gateway.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace moneybot;
+
+namespace {
+
+constexpr size_t EXCHANGES = 10;
+constexpr size_t SYMBOLS = 200;
+constexpr auto RUN_TIME = std::chrono::seconds(3);
+constexpr size_t SAMPLE_EVERY = 16;
+
+// Keeps the readers' loads from being optimized away
+volatile double read_sink = 0.0;
+
+// Hands the gateway whatever the writer pushes; nothing else is exercised
+class StubConnector : public ExchangeConnector {
+public:
+    StubConnector(std::string name, std::shared_ptr<Logger> logger)
+        : name_(std::move(name)), logger_(std::move(logger)) {}
+
+    void connect() override { connected_ = true; }
+    void disconnect() override { connected_ = false; }
+    bool isConnected() const override { return connected_; }
+
+    std::string placeOrder(const Order&) override { return {}; }
+    bool cancelOrder(const std::string&) override { return true; }
+    ChildExecution executeOrder(const Order&) override { return {}; }
+
+    OrderBook getOrderBook(const std::string&) const override { return OrderBook(logger_); }
+    ExchangeBalance getBalance(const std::string& asset) const override { return ExchangeBalance{asset}; }
+    std::vector<ExchangeBalance> getBalances() const override { return {}; }
+    std::vector<std::string> getAvailableSymbols() const override { return {}; }
+
+    void setOrderBookCallback(std::function<void(const std::string&, const OrderBook&)> callback) override {
+        book_callback_ = std::move(callback);
+    }
+    void setTradeCallback(std::function<void(const Trade&)>) override {}
+
+    double getLatency() const override { return 1.0; }
+    std::string getExchangeName() const override { return name_; }
+
+    void push(const std::string& symbol, const OrderBook& book) { book_callback_(symbol, book); }
+
+private:
+    std::string name_;
+    std::shared_ptr<Logger> logger_;
+    std::atomic<bool> connected_{false};
+    std::function<void(const std::string&, const OrderBook&)> book_callback_;
+};
+
+// Five levels a side around 100, spread widened per venue so venues never cross
+void fillBook(OrderBook& book, size_t venue, double size) {
+    auto side = [&](double top, double step) {
+        auto levels = nlohmann::json::array();
+        for (int i = 0; i < 5; ++i) {
+            levels.push_back(nlohmann::json::array({std::to_string(top + step * i), std::to_string(size)}));
+        }
+        return levels;
+    };
+    double half_spread = 0.01 * (venue + 1);
+    book.update({{"s", "BENCH"}, {"E", 0}, {"bids", side(100.0 - half_spread, -0.01)},
+                 {"asks", side(100.0 + half_spread, 0.01)}});
+}
+
+void run(std::shared_ptr<Logger> logger, const std::vector<std::string>& symbols, size_t readers) {
+    MultiExchangeGateway gateway({}, logger);
+    std::vector<StubConnector*> venues;
+    for (size_t v = 0; v < EXCHANGES; ++v) {
+        auto connector = std::make_unique<StubConnector>("EX" + std::to_string(v), logger);
+        venues.push_back(connector.get());
+        gateway.setConnector("EX" + std::to_string(v), std::move(connector));
+    }
+    gateway.start();
+
+    // Two books per venue alternated so every update changes the sizes
+    std::vector<std::unique_ptr<OrderBook>> books;
+    for (size_t v = 0; v < EXCHANGES; ++v) {
+        for (double size : {1.0, 2.0}) {
+            books.push_back(std::make_unique<OrderBook>(logger));
+            fillBook(*books.back(), v, size);
+        }
+    }
+    // Every venue lists every symbol before timing starts
+    for (size_t v = 0; v < EXCHANGES; ++v) {
+        for (const auto& symbol : symbols) venues[v]->push(symbol, *books[v * 2]);
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<size_t> writes(EXCHANGES, 0);
+    std::vector<std::vector<double>> latencies(EXCHANGES);
+    std::vector<size_t> reads(readers, 0);
+    std::vector<std::thread> threads;
+    for (size_t v = 0; v < EXCHANGES; ++v) {
+        threads.emplace_back([&, v]() {
+            latencies[v].reserve(1 << 20);
+            size_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const OrderBook& book = *books[v * 2 + (n / SYMBOLS) % 2];
+                const std::string& symbol = symbols[n % SYMBOLS];
+                if (n % SAMPLE_EVERY == 0) {
+                    auto start = std::chrono::steady_clock::now();
+                    venues[v]->push(symbol, book);
+                    latencies[v].push_back(
+                        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+                } else {
+                    venues[v]->push(symbol, book);
+                }
+                ++n;
+            }
+            writes[v] = n;
+        });
+    }
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            size_t n = 0;
+            double sink = 0.0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const std::string& symbol = symbols[(n + r * 37) % SYMBOLS];
+                if (auto book = gateway.getConsolidatedBook(symbol); book && !book->bids.empty()) {
+                    sink += book->bids.front().price;
+                }
+                if (auto snapshot = gateway.getAggregatedOrderBookSnapshot(symbol)) sink += snapshot->best_ask_price;
+                ++n;
+            }
+            reads[r] = n;
+            read_sink = read_sink + sink;
+        });
+    }
+
+    std::this_thread::sleep_for(RUN_TIME);
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    gateway.stop();
+
+    size_t total_writes = 0, total_reads = 0;
+    for (size_t n : writes) total_writes += n;
+    for (size_t n : reads) total_reads += n;
+    std::vector<double> all;
+    for (const auto& samples : latencies) all.insert(all.end(), samples.begin(), samples.end());
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) { return all.empty() ? 0.0 : all[static_cast<size_t>(p * (all.size() - 1))]; };
+    double seconds = std::chrono::duration<double>(RUN_TIME).count();
+    std::printf("%zu readers: %8.0fk writes/s, update p50 %6.0f ns p99 %7.0f ns, %8.0fk reads/s\n",
+                readers, total_writes / seconds / 1000.0, percentile(0.50), percentile(0.99),
+                total_reads / seconds / 1000.0);
+}
+
+} // namespace
+
+int main() {
+    auto logger = std::make_shared<Logger>();
+    std::vector<std::string> symbols;
+    for (size_t s = 0; s < SYMBOLS; ++s) symbols.push_back("BENCH" + std::to_string(s) + "USDT");
+
+    std::printf("gateway contention: %zu exchanges x %zu symbols, one writer per exchange, %llds per run\n",
+                EXCHANGES, SYMBOLS, static_cast<long long>(RUN_TIME.count()));
+    run(logger, symbols, 0);
+    run(logger, symbols, 4);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Pre-trade risk check latency: RiskManager::checkOrderRisk on passing orders spread
+// over many symbols, with and without the SymbolRegistry lookup. Target: < 100 ns.
+#include "risk_manager.h"
+#include "symbol_registry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace moneybot;
+
+namespace {
+
+constexpr size_t SYMBOLS = 300;
+constexpr size_t ITERATIONS = 2'000'000;
+constexpr int RUNS = 5;
+constexpr double TARGET_NS = 100.0;
+
+nlohmann::json benchConfig() {
+    // Limits loose enough that every order passes; only the check itself is timed
+    return {{"risk", {
+        {"max_position_size", 1e9},
+        {"max_order_size", 1.0},
+        {"max_daily_loss", -1e9},
+        {"max_drawdown", -1e9},
+        {"max_orders_per_minute", 1'000'000'000},
+        {"min_spread", 0.0},
+        {"max_slippage", 1.0},
+        {"rate_limits", {{"symbol", {{{"window_ms", 1000}, {"max", 1'000'000'000}}}}}},
+        {"stress", {{"threads", 1}}}
+    }}};
+}
+
+template <typename Check>
+double bestNsPerCheck(const char* name, Check check) {
+    double best = 1e300;
+    size_t passed = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        passed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i) passed += check(i % SYMBOLS);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / ITERATIONS);
+    }
+    std::printf("%-28s %8.1f ns/check  (%zu/%zu passed)\n", name, best, passed, ITERATIONS);
+    return best;
+}
+
+} // namespace
+
+int main() {
+    auto logger = std::make_shared<Logger>();
+    RiskManager risk(logger, benchConfig());
+
+    std::vector<Order> orders(SYMBOLS);
+    std::vector<uint32_t> ids(SYMBOLS);
+    for (size_t s = 0; s < SYMBOLS; ++s) {
+        orders[s].symbol = "BENCH" + std::to_string(s) + "USDT";
+        orders[s].side = s % 2 ? OrderSide::SELL : OrderSide::BUY;
+        orders[s].type = OrderType::LIMIT;
+        orders[s].price = 100.0;
+        orders[s].quantity = 0.01;
+        ids[s] = SymbolRegistry::getInstance().getOrRegister(orders[s].symbol);
+    }
+
+    std::printf("risk check: %zu symbols, %zu checks per run, best of %d\n", SYMBOLS, ITERATIONS, RUNS);
+    double by_id = bestNsPerCheck("checkOrderRisk(id, order)", [&](size_t s) {
+        return risk.checkOrderRisk(ids[s], orders[s]);
+    });
+    bestNsPerCheck("checkOrderRisk(order)", [&](size_t s) {
+        return risk.checkOrderRisk(orders[s]);
+    });
+    std::printf("target < %.0f ns by id: %s\n", TARGET_NS, by_id < TARGET_NS ? "met" : "MISSED");
+    return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+namespace moneybot {
+
+// Top levels of one side of a book, best first. Fixed capacity, so a ladder is
+// refreshed in place on every update and never allocates.
+struct BookLadder {
+    static constexpr size_t MAX_LEVELS = 20;
+    std::array<double, MAX_LEVELS> price{};
+    std::array<double, MAX_LEVELS> size{};
+    size_t depth = 0;
+};
+
+// Executable size of a cross: buy on one venue's asks, sell into another's bids
+struct ArbitrageSize {
+    double size = 0.0;              // Profit-maximizing quantity; 0 if no level clears fees
+    double buy_vwap = 0.0;          // Average fill price of each leg, before fees
+    double sell_vwap = 0.0;
+    double buy_cost = 0.0;          // Quote paid, including the buy venue's taker fee
+    double sell_proceeds = 0.0;     // Quote received, net of the sell venue's taker fee
+    double profit = 0.0;            // sell_proceeds - buy_cost
+    size_t buy_levels = 0;          // Ask levels consumed (the last possibly partially)
+    size_t sell_levels = 0;         // Bid levels consumed
+};
+
+// Walks both ladders together, level pair by level pair. Asks only get dearer and bids
+// only cheaper, so the per-unit edge after fees,
+//   bid * (1 - sell_fee) - ask * (1 + buy_fee),
+// never increases; filling every level pair while it is positive therefore maximizes
+// total profit. O(buy levels + sell levels), no allocation.
+ArbitrageSize sizeArbitrage(const BookLadder& asks, double buy_fee,
+                            const BookLadder& bids, double sell_fee,
+                            double max_size = std::numeric_limits<double>::infinity());
+
+} // namespace moneybot
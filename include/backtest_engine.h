@@ -5,6 +5,7 @@
 #include <memory>
 #include "strategy.h"
 #include "order_book.h"
+#include "quote_model.h"
 
 namespace moneybot {
 
@@ -18,11 +19,25 @@ struct BacktestResult {
     std::vector<double> equity_curve;
 };
 
+// Per-model outcome of a quote-model replay
+struct QuoteModelStats {
+    std::string model;
+    double pnl = 0.0;              // Cash + inventory marked at the final mid
+    double final_inventory = 0.0;
+    double max_abs_inventory = 0.0;
+    int fills = 0;
+    double avg_spread_bps = 0.0;
+    double avg_quote_ns = 0.0;     // Model update + quote computation per event
+};
+
 class BacktestEngine {
 public:
     BacktestEngine(const nlohmann::json& config);
     void setStrategy(std::shared_ptr<Strategy> strategy);
     BacktestResult run(const std::string& symbol, const std::string& data_path);
+    // Replay the data through each market-making quote model with a touch-fill
+    // simulator (depth lines or trade lines) and compare them on the same events
+    std::vector<QuoteModelStats> compareQuoteModels(const std::string& data_path);
     void setLogger(std::shared_ptr<Logger> logger);
 private:
     nlohmann::json config_;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "arbitrage_sizer.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+struct ConsolidatedVenue {
+    std::string exchange;
+    double taker_fee = 0.0;
+};
+
+// One price on one side of the consolidated book and what each venue shows there.
+// Per-venue quantities are a fixed array, so a book holds at most MAX_VENUES venues;
+// venues added after that are left out of it (MultiExchangeGateway logs it once per
+// symbol) but still trade through the gateway's ranking and routing.
+struct ConsolidatedLevel {
+    static constexpr size_t MAX_VENUES = 8;
+
+    double price = 0.0;
+    double quantity = 0.0;                      // Summed over venues
+    double effective_price = 0.0;               // Best fee-adjusted price among the venues quoting here
+    std::array<double, MAX_VENUES> venue_quantity{};
+};
+
+// All venues' ladders for a symbol merged into one price-sorted book. Immutable once
+// published: readers share it through a shared_ptr and never lock.
+struct ConsolidatedBook {
+    std::string symbol;
+    std::shared_ptr<const std::vector<ConsolidatedVenue>> venues;   // Indexes venue_quantity
+    std::vector<ConsolidatedLevel> bids;        // Highest first
+    std::vector<ConsolidatedLevel> asks;        // Lowest first
+
+    size_t venueCount() const { return venues ? venues->size() : 0; }
+    // Received per unit selling into a bid, or paid per unit lifting an ask, after the venue's fee
+    double effectivePrice(const ConsolidatedLevel& level, size_t venue, bool is_bid) const;
+    // One venue's ladder for a side, rebuilt from the merged levels (no allocation)
+    void venueLadder(size_t venue, bool is_bid, BookLadder& ladder) const;
+    nlohmann::json toJson(size_t levels = 10) const;
+};
+
+// Writer side of a ConsolidatedBook. Keeps every venue's last ladder and, when a venue
+// updates, applies only the prices whose quantity changed to the full-depth book (or
+// re-merges that side in one pass when most of the ladder moved); a snapshot of the top
+// levels is published for readers. Not thread-safe (one writer).
+class ConsolidatedBookBuilder {
+public:
+    static constexpr size_t NO_VENUE = static_cast<size_t>(-1);
+
+    explicit ConsolidatedBookBuilder(std::string symbol = "", size_t publish_depth = BookLadder::MAX_LEVELS);
+
+    // Venue ids are handed out in order of addition; NO_VENUE once MAX_VENUES are in
+    // (the venue is not merged, and callers should say so)
+    size_t addVenue(const std::string& exchange, double taker_fee);
+    size_t venueCount() const { return bid_ladders_.size(); }
+
+    void update(size_t venue, const BookLadder& bids, const BookLadder& asks);
+
+    // Latest ladders and fee of one venue, as last passed to update()
+    const BookLadder& venueBids(size_t venue) const { return bid_ladders_[venue]; }
+    const BookLadder& venueAsks(size_t venue) const { return ask_ladders_[venue]; }
+    double takerFee(size_t venue) const { return fees_[venue]; }
+
+    const ConsolidatedBook& book() const { return book_; }   // Full depth, writer only
+    std::shared_ptr<const ConsolidatedBook> publish() const;
+
+private:
+    static constexpr size_t PATCH_LIMIT = 4;     // More changed prices than this: merge the side
+
+    void applySide(std::vector<ConsolidatedLevel>& side, bool is_bid, size_t venue,
+                   const BookLadder& previous, const BookLadder& next);
+    void mergeSide(std::vector<ConsolidatedLevel>& side, bool is_bid, size_t venue, const BookLadder& next);
+    void setQuantity(std::vector<ConsolidatedLevel>& side, bool is_bid, size_t venue,
+                     double price, double quantity);
+    bool refreshLevel(ConsolidatedLevel& level, bool is_bid) const;   // Totals; false if now empty
+
+    ConsolidatedBook book_;
+    std::vector<BookLadder> bid_ladders_;
+    std::vector<BookLadder> ask_ladders_;
+    std::array<double, ConsolidatedLevel::MAX_VENUES> fees_{};
+    std::vector<ConsolidatedLevel> merged_;     // Scratch for mergeSide, swapped with a side
+    size_t publish_depth_;
+};
+
+} // namespace moneybot
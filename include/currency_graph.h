@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace moneybot {
+
+// One conversion in a cycle: sell `from` for `to` on a venue's book
+struct CycleLeg {
+    std::string exchange;
+    std::string symbol;
+    bool is_buy = false;            // Buy base with quote at the ask; else sell base at the bid
+    std::string from_asset;
+    std::string to_asset;
+    double price = 0.0;             // Book price used (ask or bid)
+    double rate = 0.0;              // to_asset received per from_asset, after the taker fee
+    double capacity = 0.0;          // Top-of-book size in from_asset units
+};
+
+// A negative cycle in the currency graph: converting around it returns more than it started with
+struct ArbitrageCycle {
+    std::vector<CycleLeg> legs;     // In execution order; the last leg's to_asset is the first's from_asset
+    double gross_return = 0.0;      // Product of leg rates - 1 (fees included)
+    double max_start_amount = 0.0;  // Top-of-book capacity in units of the starting asset
+    std::chrono::steady_clock::time_point detected;
+
+    const std::string& startAsset() const { return legs.front().from_asset; }
+    double profitBps() const { return gross_return * 10000.0; }
+    // Rotates the legs to start (and end) at `asset`, rescaling max_start_amount; false if not on the cycle
+    bool startFrom(const std::string& asset);
+};
+
+struct CurrencyGraphParams {
+    // Quote assets tried as suffixes when a symbol has no separator (BTCUSDT -> BTC/USDT)
+    std::vector<std::string> quote_assets = {"USDT", "USDC", "BUSD", "FDUSD", "TUSD", "DAI", "USD", "EUR",
+                                             "GBP", "BTC", "ETH", "BNB"};
+    double min_return = 0.0;        // Cycles returning less than this (after fees) aren't reported
+    size_t min_legs = 3;            // Two-leg cycles are plain cross-venue crosses, reported elsewhere
+};
+
+// Assets as nodes; every venue's bid and ask for every market as weighted edges,
+//   base -> quote at the bid:  w = -log(bid * (1 - fee))
+//   quote -> base at the ask:  w = -log((1 - fee) / ask)
+// so a cycle of negative total weight converts to more than it started with.
+//
+// Detection is incremental. The graph keeps potentials (shortest-path labels from a
+// virtual source that reaches every asset at 0) with dist[to] <= dist[from] + w on every
+// active edge, i.e. every reduced cost w + dist[from] - dist[to] is non-negative. A
+// price update only re-weights its market's two edges. A rise can't break that; a fall
+// leaves the edge (a -> b) short by some slack. Then a Dijkstra search over reduced
+// costs from b, cut off at the slack, either reaches a, closing a negative cycle, or
+// yields exactly the labels that drop and by how much. The search only visits assets
+// the tick could actually move, and when it reaches a, the cycle it found is the most
+// profitable one through the updated edge.
+//
+// A cycle found this way is reported and its updated edge is set aside. That breaks
+// every cycle through the edge and keeps the labels valid. The edge rejoins, and is
+// checked again, the next time its market updates.
+// Not thread-safe; the owner serializes update() and the queries.
+class CurrencyGraph {
+public:
+    explicit CurrencyGraph(CurrencyGraphParams params = {});
+
+    // Applies one venue's top of book for a symbol. Cycles confirmed by this update
+    // (new, or with a changed return) are appended to `found`. Returns false if the
+    // symbol couldn't be split into base and quote.
+    bool update(const std::string& exchange, const std::string& symbol, double fee,
+                double bid_price, double bid_size, double ask_price, double ask_size,
+                std::vector<ArbitrageCycle>& found);
+
+    // Registers a market whose symbol doesn't follow the naming rules
+    void addMarket(const std::string& exchange, const std::string& symbol,
+                   const std::string& base, const std::string& quote);
+
+    // Reported cycles still negative at the current prices, best first
+    std::vector<ArbitrageCycle> activeCycles() const;
+
+    bool splitSymbol(const std::string& symbol, std::string& base, std::string& quote) const;
+
+    size_t assetCount() const { return assets_.size(); }
+    size_t edgeCount() const { return edges_.size(); }
+    uint64_t assetsSearched() const { return searched_; }   // Dijkstra pops, all updates
+
+private:
+    struct Edge {
+        uint32_t from, to;
+        uint32_t market;
+        bool is_buy;
+        double price = 0.0;
+        double rate = 0.0;
+        double capacity = 0.0;      // In from_asset units
+        double weight;              // -log(rate); +inf while the side is empty
+        bool set_aside = false;     // Closed a negative cycle; skipped until its market updates
+        std::vector<uint32_t> cycle;    // The reported cycle it was set aside for
+        double cycle_weight = 0.0;
+    };
+    struct Market {
+        uint32_t exchange;
+        std::string symbol;
+        uint32_t bid_edge;          // base -> quote
+        uint32_t ask_edge;          // quote -> base
+    };
+
+    uint32_t assetId(const std::string& asset);
+    uint32_t exchangeId(const std::string& exchange);
+    uint32_t marketId(uint32_t exchange, const std::string& symbol, const std::string& base, const std::string& quote);
+    void setEdge(uint32_t edge, double price, double rate, double capacity);
+    void insertEdge(uint32_t edge, std::vector<ArbitrageCycle>& found);
+    double cycleWeight(const std::vector<uint32_t>& cycle) const;
+    void setAside(uint32_t edge, const std::vector<uint32_t>& cycle, double weight, std::vector<ArbitrageCycle>& found);
+    ArbitrageCycle describe(const std::vector<uint32_t>& cycle, double weight) const;
+
+    CurrencyGraphParams params_;
+    double min_log_return_;
+
+    std::unordered_map<std::string, uint32_t> asset_ids_;
+    std::vector<std::string> assets_;
+    std::vector<std::string> exchanges_;
+    std::vector<std::unordered_map<std::string, uint32_t>> market_ids_;   // Per exchange: symbol -> market
+    std::vector<Market> markets_;
+    std::vector<Edge> edges_;
+    std::vector<std::vector<uint32_t>> out_edges_;                      // Per asset
+
+    std::vector<double> dist_;      // Potentials, one per asset
+
+    // Search scratch, reset after each search
+    std::vector<double> reach_;     // Reduced distance from the updated edge's head, +inf if unreached
+    std::vector<uint32_t> via_;     // Edge the search reached each asset by
+    std::vector<uint32_t> touched_;
+    std::vector<std::pair<double, uint32_t>> heap_;
+    std::vector<uint32_t> cycle_scratch_;
+
+    uint64_t searched_ = 0;
+};
+
+} // namespace moneybot
@@ -16,10 +16,12 @@ public:
     virtual void connect() override;
     virtual void disconnect() override;
     virtual bool isConnected() const override;
+    virtual void setIoRuntime(std::shared_ptr<IoRuntime> runtime) override { io_runtime_ = std::move(runtime); }
     virtual std::vector<std::string> getAvailableSymbols() const override;
     virtual std::string placeOrder(const Order& order) override;
     virtual bool cancelOrder(const std::string& order_id) override;
     virtual ExchangeBalance getBalance(const std::string& asset) const override;
+    virtual std::vector<ExchangeBalance> getBalances() const override;
     virtual OrderBook getOrderBook(const std::string& symbol) const override;
     virtual std::string getExchangeName() const override;
     virtual void setOrderBookCallback(std::function<void(const std::string&, const OrderBook&)> callback) override;
@@ -32,7 +34,10 @@ protected:
     std::shared_ptr<Network> network_;
     std::atomic<bool> connected_;
     std::atomic<bool> should_stop_;
-    std::thread ws_thread_;
+    std::thread ws_thread_;                 // Only without an I/O runtime
+    std::shared_ptr<IoRuntime> io_runtime_;
+    IoRuntime::Lease io_lease_;
+    std::unique_ptr<boost::asio::steady_timer> poll_timer_;
     
     std::function<void(const std::string&, const OrderBook&)> orderbook_callback_;
     std::function<void(const Trade&)> trade_callback_;
@@ -55,6 +60,7 @@ protected:
     
 private:
     void webSocketLoop();
+    void schedulePoll();
 };
 
 // Binance connector implementation
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+struct FeedStats {
+    size_t feed = 0;
+    uint64_t messages = 0;
+    uint64_t wins = 0;              // Copies applied: this feed was first
+    uint64_t duplicates = 0;        // Copies dropped: another feed was first
+    uint64_t unsequenced = 0;       // No update id to arbitrate on; applied as they come
+    // How far this feed's wins were ahead of the next copy of the same update
+    double lead_avg_us = 0.0;       // EWMA
+    double lead_max_us = 0.0;
+};
+
+// Arbitration state for one stream, shared by every feed carrying it. Callers hold the
+// mutex from the ordering decision until the update has been applied, so updates
+// arriving on different threads are applied in id order.
+struct FeedSequence {
+    std::mutex mutex;
+    uint64_t last_id = 0;
+    bool seen = false;
+    size_t winner = 0;
+    std::chrono::steady_clock::time_point won_at;
+};
+
+// First-arrival arbitration across redundant copies of the same streams (A/B feeds).
+// Each update is identified by its exchange update id; the first copy to arrive is
+// applied and later copies of it, or of anything older, are dropped. Feeds that lose
+// consistently show up in the stats as duplicates with no wins.
+class FeedArbiter {
+public:
+    explicit FeedArbiter(size_t feeds);
+
+    // True if this copy should be applied; call with sequence.mutex held
+    bool accept(FeedSequence& sequence, size_t feed, const nlohmann::json& data,
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+    // The same ordering rule for a single feed, without stats; sequence.mutex held
+    static bool advance(FeedSequence& sequence, const nlohmann::json& data);
+
+    // Binance ids: "u" (diff depth), "lastUpdateId" (partial depth), "t" (trade), "a" (agg trade)
+    static std::optional<uint64_t> updateId(const nlohmann::json& data);
+
+    size_t feeds() const { return counters_.size(); }
+    std::vector<FeedStats> stats() const;
+    nlohmann::json toJson() const;
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> wins{0};
+        std::atomic<uint64_t> duplicates{0};
+        std::atomic<uint64_t> unsequenced{0};
+        std::atomic<double> lead_avg_us{0.0};
+        std::atomic<double> lead_max_us{0.0};
+    };
+
+    void recordLead(size_t feed, double lead_us);
+
+    std::vector<std::unique_ptr<Counters>> counters_;
+};
+
+} // namespace moneybot
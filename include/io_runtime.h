@@ -0,0 +1,113 @@
+#pragma once
+
+#include "logger.h"
+#include <atomic>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+struct IoContextStats {
+    size_t index = 0;
+    int core = -1;                  // -1 if not pinned
+    size_t connections = 0;
+    double load = 0.0;              // Summed weights of the connections assigned here
+    // How late the loop ran a timer due now: time spent behind other handlers
+    double lag_last_us = 0.0;
+    double lag_avg_us = 0.0;        // EWMA
+    double lag_max_us = 0.0;
+    uint64_t probes = 0;
+};
+
+// Shared I/O threads for every connection: N io_contexts, each run by one thread
+// (optionally pinned to a core). A connection leases a context for its lifetime and is
+// placed on the least loaded one; all of its handlers then run there, in order. A probe
+// timer on each context measures event-loop lag.
+//
+// Config:
+//   "io": {"contexts": 2, "pin_threads": true, "first_core": 0, "lag_probe_ms": 100}
+// contexts 0 means one per hardware thread.
+class IoRuntime {
+public:
+    // A connection's place on one context; returns its load when released or destroyed.
+    // The runtime must outlive its leases.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease() { release(); }
+
+        explicit operator bool() const { return runtime_ != nullptr; }
+        boost::asio::io_context& context() const;
+        size_t index() const { return index_; }
+        void release();
+
+    private:
+        friend class IoRuntime;
+        Lease(IoRuntime* runtime, size_t index, double weight)
+            : runtime_(runtime), index_(index), weight_(weight) {}
+
+        IoRuntime* runtime_ = nullptr;
+        size_t index_ = 0;
+        double weight_ = 0.0;
+    };
+
+    IoRuntime(std::shared_ptr<Logger> logger, const nlohmann::json& config);
+    ~IoRuntime();
+
+    IoRuntime(const IoRuntime&) = delete;
+    IoRuntime& operator=(const IoRuntime&) = delete;
+
+    void start();
+    // Stops the contexts, then runs the handlers already due (completed cancellations,
+    // posted closes) so connections let go of what they hold before the runtime does
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    // Least loaded context (ties: lower average lag). `weight` is the connection's
+    // expected share of work, e.g. its stream count.
+    Lease acquire(const std::string& name, double weight = 1.0);
+
+    size_t size() const { return contexts_.size(); }
+    std::vector<IoContextStats> stats() const;
+    nlohmann::json toJson() const;
+
+private:
+    struct Context {
+        boost::asio::io_context ioc{1};     // Hint: a single thread runs it
+        std::optional<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work;
+        boost::asio::steady_timer probe{ioc};
+        std::thread thread;
+        int core = -1;
+        double load = 0.0;                  // Guarded by assign_mutex_
+        size_t connections = 0;
+        std::atomic<double> lag_last_us{0.0};
+        std::atomic<double> lag_avg_us{0.0};
+        std::atomic<double> lag_max_us{0.0};
+        std::atomic<uint64_t> probes{0};
+    };
+
+    void release(size_t index, double weight);
+    void armProbe(Context& context);
+    void pinThread(Context& context);
+
+    // Declared before contexts_: leases released by handlers destroyed with a context use them
+    std::shared_ptr<Logger> logger_;
+    mutable std::mutex assign_mutex_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> destroying_{false};
+    std::vector<std::unique_ptr<Context>> contexts_;
+    std::chrono::milliseconds probe_interval_;
+};
+
+} // namespace moneybot
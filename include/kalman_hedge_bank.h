@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace moneybot {
+
+struct KalmanHedgeParams {
+    bool intercept = true;              // 2-state (intercept, hedge ratio); false: ratio only
+    double process_noise = 1e-5;        // Random-walk variance added to each state per step
+    double observation_noise = 1e-3;    // Measurement variance
+    double initial_variance = 1.0;      // Prior variance of each state
+};
+
+// Kalman filters for the hedge regressions of many pairs,
+//   y = intercept + hedge_ratio * x + e,   states following random walks,
+// stored structure-of-arrays and advanced together: observe() stages each pair's
+// (y, x) and step() runs predict + update for every filter in one pass, four lanes at
+// a time. Filters without a staged observation only predict (their variance grows).
+//
+// With intercept = false the intercept is pinned at 0; observing (ratio, 1.0) then
+// reproduces a scalar filter that tracks an observed ratio directly.
+class KalmanHedgeBank {
+public:
+    explicit KalmanHedgeBank(KalmanHedgeParams params = {});
+
+    size_t addFilter(double hedge_ratio = 1.0, double intercept = 0.0);
+    void reset(size_t filter, double hedge_ratio, double intercept = 0.0);
+
+    void observe(size_t filter, double y, double x) {
+        if (filter >= count_ || !std::isfinite(y) || !std::isfinite(x)) return;
+        y_[filter] = y;
+        x_[filter] = x;
+        mask_[filter] = 1.0;
+    }
+    void step();
+
+    double hedgeRatio(size_t filter) const { return ratio_[filter]; }
+    double intercept(size_t filter) const { return intercept_[filter]; }
+    double ratioVariance(size_t filter) const { return p11_[filter]; }
+    // Prediction error and its variance from the last step (0 if it had no observation)
+    double innovation(size_t filter) const { return innovation_[filter]; }
+    double innovationVariance(size_t filter) const { return variance_[filter]; }
+    double zScore(size_t filter) const;
+
+    size_t size() const { return count_; }
+    const KalmanHedgeParams& params() const { return params_; }
+
+private:
+    static constexpr size_t LANES = 4;
+
+    void initialize(size_t filter, double hedge_ratio, double intercept);
+
+    KalmanHedgeParams params_;
+    size_t count_ = 0;
+
+    // One entry per filter, padded to whole lanes; padding lanes never observe
+    std::vector<double> intercept_, ratio_;
+    std::vector<double> p00_, p01_, p11_;       // State covariance (symmetric)
+    std::vector<double> y_, x_, mask_;          // Staged observations; mask 1 when staged
+    std::vector<double> innovation_, variance_;
+};
+
+} // namespace moneybot
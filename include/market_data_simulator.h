@@ -8,6 +8,7 @@
 #include <functional>
 #include "types.h"
 #include "order_book.h"
+#include "timer_wheel.h"
 
 namespace moneybot {
 
@@ -34,7 +35,7 @@ public:
     bool isRunning() const { return running_; }
     
     // Configuration
-    void setUpdateInterval(std::chrono::milliseconds interval) { update_interval_ = interval; }
+    void setUpdateInterval(std::chrono::milliseconds interval);
     void addSymbol(const std::string& symbol, double base_price = 50000.0);
     void addExchange(const std::string& exchange_name);
     
@@ -57,7 +58,8 @@ public:
     std::shared_ptr<OrderBook> getOrderBook(const std::string& symbol, const std::string& exchange) const;
     
 private:
-    void simulationLoop();
+    void scheduleUpdates();
+    void printStatus();
     void updatePrices();
     void updateOrderBooks();
     void generateTick(const std::string& symbol, const std::string& exchange);
@@ -67,7 +69,8 @@ private:
     double applyNewsImpact(double price, const std::string& symbol);
     
     std::atomic<bool> running_;
-    std::thread simulation_thread_;
+    TimerService timers_;
+    TimerWheel::TimerId update_timer_ = TimerWheel::INVALID_TIMER;
     std::chrono::milliseconds update_interval_;
     
     // Market data storage
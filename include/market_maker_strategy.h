@@ -4,11 +4,18 @@
 #include "strategy.h"
 #include "order_book.h"
 #include "order_manager.h"
+#include "order_intent_manager.h"
+#include "quote_model.h"
 #include "risk_manager.h"
+#include "rolling_stats.h"
+#include "speculative_quote_table.h"
+#include "timer_wheel.h"
 #include "types.h"
 #include <memory>
 #include <unordered_map>
 #include <chrono>
+#include <random>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace moneybot {
@@ -23,15 +30,60 @@ struct MarketMakerConfig {
     int volatility_window = 100;           // Ticks to calculate volatility
     double volatility_multiplier = 1.5;    // Spread adjustment based on volatility
     int refresh_interval_ms = 1000;        // Order refresh interval
+    int min_requote_interval_ms = 100;     // Minimum gap between requotes driven by book moves
     double min_profit_bps = 0.5;           // Minimum profit target per trade
     double rebalance_threshold = 0.5;      // Position rebalance threshold
     double max_slippage_bps = 10.0;        // Maximum slippage tolerance
     bool aggressive_rebalancing = false;   // Whether to use aggressive rebalancing
+    double quote_tolerance_bps = 1.0;      // Leave resting quotes within this distance of target
+    double quote_size_tolerance = 0.1;     // Leave resting quotes within this relative size of target
+    bool amend_supported = true;           // Use cancel-replace instead of cancel + new
+    double tick_size = 0.01;               // Price increment of the traded symbol
+    bool speculative_quotes = true;        // Precompute quotes for the next likely book states
+    int snapshot_interval_ms = 100;        // Minimum gap between published snapshots
+    int order_timeout_ms = 0;              // Cancel quotes not reconfirmed within this (0: 2x refresh, <0: off)
+    
+    // Quoting model ("heuristic" or "avellaneda_stoikov")
+    QuoteModelType quote_model = QuoteModelType::HEURISTIC;
+    double as_gamma = 0.01;                // Risk aversion (per bps)
+    double as_horizon_sec = 60.0;          // Inventory horizon
+    double as_initial_k = 0.5;             // Arrival decay (1/bps) before trades are seen
+    double as_min_trade_distance_bps = 0.1;
+    int as_trade_window = 200;             // Trades in the arrival-intensity estimator
+    double as_volatility_halflife_sec = 60.0;
     
     MarketMakerConfig() = default;
     MarketMakerConfig(const nlohmann::json& j);
+    
+    HeuristicQuoteParams heuristicParams() const;
+    AvellanedaStoikovParams avellanedaStoikovParams() const;
+};
+
+// Read-only state for the GUI/CLI. Published as a whole and never mutated afterwards.
+struct MarketMakerSnapshot {
+    std::string symbol;
+    double position = 0.0;
+    double mid_price = 0.0;
+    double best_bid = 0.0;
+    double best_ask = 0.0;
+    double bid_quote = 0.0;
+    double ask_quote = 0.0;
+    double spread_bps = 0.0;
+    double volatility = 0.0;
+    double total_pnl = 0.0;
+    double realized_pnl = 0.0;
+    double unrealized_pnl = 0.0;
+    int total_trades = 0;
+    size_t active_orders = 0;
+    double speculative_latency_ns = 0.0;
+    double full_latency_ns = 0.0;
+    std::vector<std::pair<double, double>> bids;  // Top levels, best first
+    std::vector<std::pair<double, double>> asks;
+    std::chrono::system_clock::time_point timestamp;
 };
 
+// Single-threaded: every call must come from the owning thread (a StrategyActor in the
+// live engine), so strategy state is unlocked. Other threads read published snapshots.
 class MarketMakerStrategy : public Strategy {
 public:
     MarketMakerStrategy(std::shared_ptr<Logger> logger,
@@ -49,15 +101,27 @@ public:
     
     void initialize() override;
     void shutdown() override;
+    void setTimerWheel(TimerWheel* timers) override { timers_ = timers; }
     
     std::string getName() const override { return "MarketMaker"; }
     void updateConfig(const nlohmann::json& config) override;
+    
+    // Thread-safe reads of the last published state
+    nlohmann::json getSnapshot() const override;
+    std::shared_ptr<const MarketMakerSnapshot> getMarketSnapshot() const;
 
 private:
     // Enhanced market making logic
     void calculateQuotes();
     void placeQuotes();
-    void cancelStaleOrders();
+    void sendQuotes(double bid_size, double ask_size, bool speculative);
+    
+    // Speculative quoting: quotes for the next likely states, ready to send
+    QuotePrices modelQuote(double mid, double position) const;
+    SpeculativeQuote buildQuote(double best_bid, double best_ask, double position) const;
+    void precomputeQuotes();
+    bool reactFromTable(double best_bid, double best_ask);
+    void cancelStaleOrders();  // Scan for hosts without a timer wheel; see armOrderTimeout
     void rebalancePosition();
     
     // Advanced spread calculation
@@ -65,6 +129,7 @@ private:
     double calculateInventorySkew() const;
     double calculateVolatility() const;
     std::pair<double, double> calculateOrderSizes() const;
+    std::pair<double, double> orderSizesFor(double position) const;
     
     // Order management
     void placeBidOrder(double price, double quantity);
@@ -80,6 +145,7 @@ private:
     // Risk management
     bool isWithinRiskLimits(double price, double size, bool is_buy) const;
     void updateMetrics();
+    void publishSnapshot(const OrderBook* order_book);
     void logStrategyState() const;
     
     // Utility functions
@@ -88,6 +154,7 @@ private:
     double calculateOrderSize();
     bool shouldPlaceOrders();
     bool shouldRefreshOrders() const;
+    bool requoteIntervalElapsed() const;
     bool isOrderStale(const std::string& order_id);
     
     // Configuration
@@ -105,7 +172,10 @@ private:
     std::shared_ptr<Logger> logger_;
     std::shared_ptr<OrderManager> order_manager_;
     std::shared_ptr<RiskManager> risk_manager_;
+    std::unique_ptr<OrderIntentManager> intent_manager_;
     MarketMakerConfig config_;
+    HeuristicQuoteModel heuristic_model_;
+    AvellanedaStoikovModel as_model_;
     
     // State tracking
     std::string symbol_;
@@ -114,11 +184,19 @@ private:
     double current_ask_price_;
     double mid_price_;
     
-    // Enhanced market data tracking
-    std::deque<double> recent_prices_;
-    std::deque<double> recent_spreads_;
+    // Rolling market data windows (O(1) per book update)
+    RollingVolatility price_volatility_;
+    RollingStats spread_stats_;
     double current_volatility_;
     double current_spread_bps_;
+    double best_bid_;
+    double best_ask_;
+    
+    // Precomputed reactions and event-to-send latency per path (ns)
+    SpeculativeQuoteTable speculative_quotes_;
+    std::chrono::steady_clock::time_point event_received_;
+    RollingStats speculative_latency_ns_{1000};
+    RollingStats full_latency_ns_{1000};
     
     // Order tracking
     struct ActiveOrder {
@@ -130,9 +208,22 @@ private:
     };
     std::unordered_map<std::string, ActiveOrder> active_orders_;
     
-    // Thread safety
-    mutable std::mutex state_mutex_;
-    mutable std::mutex orders_mutex_;
+    // Stale-quote timeouts, one timer per resting order, re-armed when a refresh keeps it
+    void trackOrder(const ActiveOrder& order);
+    void untrackOrder(const std::string& order_id);
+    void armOrderTimeout(const std::string& order_id);
+    void onOrderTimeout(const std::string& order_id);
+    TimerWheel* timers_ = nullptr;
+    std::unordered_map<std::string, TimerWheel::TimerId> order_timers_;
+    
+    // Published state (the only members touched by other threads)
+    static constexpr size_t SNAPSHOT_LEVELS = 10;
+    std::shared_ptr<const MarketMakerSnapshot> snapshot_;
+    std::chrono::steady_clock::time_point last_snapshot_;
+    
+    std::mt19937 size_rng_;
+    uint64_t client_order_counter_ = 0;
+    uint64_t metrics_updates_ = 0;
     
     // Timing
     std::chrono::system_clock::time_point last_quote_time_;
@@ -143,8 +234,6 @@ private:
     double realized_pnl_;
     double unrealized_pnl_;
     int total_trades_;
-    double avg_spread_;
-    int spread_samples_;
     bool strategy_active_;
 };
 
@@ -4,13 +4,20 @@
 #include <cstddef>
 #include <cstdint>
 #include <climits>
+#include "io_runtime.h"
 #include "logger.h"
 #include "network.h"
 #include "order_book.h"
 #include "strategy.h"
 #include "order_manager.h"
+#include "pair_discovery.h"
 #include "risk_manager.h"
 #include "market_maker_strategy.h"
+#include "multi_exchange_gateway.h"
+#include "multi_symbol_market_maker.h"
+#include "strategy_actor.h"
+#include "stream_subscription_manager.h"
+#include "timer_wheel.h"
 #include <nlohmann/json.hpp>
 #include <memory>
 #include <thread>
@@ -35,28 +42,45 @@ namespace moneybot {
         void updateConfig(const nlohmann::json& config);
         
         // --- Live status helpers ---
+        // With a market maker running, its book lives on the actor thread; read the snapshot
         std::pair<double, double> getBestBidAsk() const {
+            if (market_maker_) {
+                auto snapshot = market_maker_->getMarketSnapshot();
+                return snapshot ? std::make_pair(snapshot->best_bid, snapshot->best_ask) : std::make_pair(0.0, 0.0);
+            }
             if (order_book_) return order_book_->getBestBidAsk();
             return {0.0, 0.0};
         }
-        double getBestBid() const {
-            if (order_book_) return order_book_->getBestBid();
-            return 0.0;
-        }
-        double getBestAsk() const {
-            if (order_book_) return order_book_->getBestAsk();
-            return 0.0;
-        }
+        double getBestBid() const { return getBestBidAsk().first; }
+        double getBestAsk() const { return getBestBidAsk().second; }
 
-        // Expose top N bids/asks for GUI
+        // Expose top N bids/asks for GUI. With the multi-venue gateway running this is the
+        // consolidated book (quantity summed over at most ConsolidatedLevel::MAX_VENUES
+        // venues); otherwise the strategy's single-venue book.
         std::vector<std::pair<double, double>> getTopBids(size_t n = 10) const {
+            if (auto book = getConsolidatedBook()) return topLevels(book->bids, n);
+            if (market_maker_) {
+                auto snapshot = market_maker_->getMarketSnapshot();
+                if (!snapshot) return {};
+                return {snapshot->bids.begin(), snapshot->bids.begin() + std::min(n, snapshot->bids.size())};
+            }
             if (order_book_) return order_book_->getTopBids(n);
             return {};
         }
         std::vector<std::pair<double, double>> getTopAsks(size_t n = 10) const {
+            if (auto book = getConsolidatedBook()) return topLevels(book->asks, n);
+            if (market_maker_) {
+                auto snapshot = market_maker_->getMarketSnapshot();
+                if (!snapshot) return {};
+                return {snapshot->asks.begin(), snapshot->asks.begin() + std::min(n, snapshot->asks.size())};
+            }
             if (order_book_) return order_book_->getTopAsks(n);
             return {};
         }
+        // Merged book of every venue for the depth view's symbol; null without the gateway
+        std::shared_ptr<const ConsolidatedBook> getConsolidatedBook() const {
+            return gateway_ && !depth_symbol_.empty() ? gateway_->getConsolidatedBook(depth_symbol_) : nullptr;
+        }
         std::string getLastEvent() const { return last_event_; }
         void setLastEvent(const std::string& evt) { last_event_ = evt; }
         bool isWsConnected() const { return ws_connected_; }
@@ -64,6 +88,13 @@ namespace moneybot {
         // --- End live status helpers ---
         
     private:
+        static std::vector<std::pair<double, double>> topLevels(const std::vector<ConsolidatedLevel>& side, size_t n) {
+            std::vector<std::pair<double, double>> levels;
+            levels.reserve(std::min(n, side.size()));
+            for (size_t i = 0; i < side.size() && i < n; ++i) levels.emplace_back(side[i].price, side[i].quantity);
+            return levels;
+        }
+
         // Event handlers
         void onOrderBookUpdate(const OrderBook& order_book);
         void onTrade(const Trade& trade);
@@ -76,8 +107,8 @@ namespace moneybot {
         void shutdownComponents();
         
         // Thread management
-        void networkThread();
-        void strategyThread();
+        void startMarketDataStream();
+        void scheduleStressTest();
         
         // Configuration
         void loadConfig(const nlohmann::json& config);
@@ -85,17 +116,26 @@ namespace moneybot {
         // Core components
         std::shared_ptr<Logger> logger_;
         std::shared_ptr<OrderBook> order_book_;
-        std::shared_ptr<Network> network_;
+        std::shared_ptr<IoRuntime> io_runtime_;                // Outlives the connections leasing it
+        std::shared_ptr<StreamSubscriptionManager> stream_manager_;    // Market data streams
+        std::shared_ptr<Network> network_;                     // User data stream
         std::shared_ptr<OrderManager> order_manager_;
         std::shared_ptr<RiskManager> risk_manager_;
         std::shared_ptr<Strategy> strategy_;
+        std::shared_ptr<MultiSymbolMarketMaker> multi_symbol_; // Set in multi_asset mode
+        std::shared_ptr<StrategyActor> actor_;                 // Set in market_maker mode
+        std::shared_ptr<MarketMakerStrategy> market_maker_;
+        std::shared_ptr<MultiExchangeGateway> gateway_;        // Set when multi_asset is enabled
+        std::string depth_symbol_;                             // Symbol the depth view shows
+        // Periodic pair scan over the recorded ticks; set when statistical_arbitrage.discovery is on
+        std::unique_ptr<PairDiscoveryJob> pair_discovery_;
+        nlohmann::json last_discovery_;                        // Guarded by status_mutex_
         
         // Configuration
         nlohmann::json config_;
         
         // Threading
-        std::thread network_thread_;
-        std::thread strategy_thread_;
+        TimerService timers_;                                  // Periodic engine work
         std::atomic<bool> running_;
         std::atomic<bool> emergency_stop_;
         
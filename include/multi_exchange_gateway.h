@@ -5,13 +5,23 @@
 #include <mutex>
 #include <chrono>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
 #include "order_book.h"
 #include "types.h"
 #include "logger.h"
+#include "timer_wheel.h"
+#include "venue_ranking.h"
+#include "arbitrage_sizer.h"
+#include "consolidated_book.h"
+#include "currency_graph.h"
+#include "smart_order_router.h"
 #include <nlohmann/json.hpp>
 
 namespace moneybot {
 
+class IoRuntime;
+
 struct ExchangeConfig {
     std::string name;
     std::string rest_url;
@@ -26,9 +36,12 @@ struct ExchangeConfig {
     double latency_threshold_ms = 100.0;
 };
 
+using ExchangeBookMap = std::unordered_map<std::string, std::shared_ptr<OrderBook>>; // exchange_name -> OrderBook
+
 struct CrossExchangeOrderBook {
     std::string symbol;
-    std::unordered_map<std::string, std::shared_ptr<OrderBook>> exchange_books; // exchange_name -> OrderBook
+    // Immutable and shared between snapshots; replaced only when an exchange joins
+    std::shared_ptr<const ExchangeBookMap> exchange_books;
     double best_bid_price = 0.0;
     double best_ask_price = 0.0;
     std::string best_bid_exchange;
@@ -37,6 +50,7 @@ struct CrossExchangeOrderBook {
     double best_ask_size = 0.0;
     std::chrono::steady_clock::time_point last_update;
     double latency_ms = 0.0;
+    std::shared_ptr<const ConsolidatedBook> consolidated;   // All venues' top levels merged
 };
 
 struct ArbitrageOpportunity {
@@ -46,8 +60,10 @@ struct ArbitrageOpportunity {
     double buy_price;
     double sell_price;
     double profit_bps;
-    double max_size;
-    double profit_usd;
+    double max_size;        // Profit-maximizing size over both books' top levels, after taker fees
+    double profit_usd;      // Net of taker fees at max_size
+    double buy_vwap = 0.0;  // Average fill price of each leg at max_size
+    double sell_vwap = 0.0;
     double confidence_score; // 0.0 - 1.0 based on book depth and latency
     std::chrono::steady_clock::time_point timestamp;
     std::chrono::milliseconds time_to_execute{0};
@@ -81,6 +97,10 @@ public:
 
     // Market data aggregation
     CrossExchangeOrderBook getAggregatedOrderBook(const std::string& symbol) const;
+    // Latest published book for the symbol without copying (nullptr if unknown); never blocks writers
+    std::shared_ptr<const CrossExchangeOrderBook> getAggregatedOrderBookSnapshot(const std::string& symbol) const;
+    // Every venue's ladder for the symbol merged by price (nullptr if unknown); lock-free
+    std::shared_ptr<const ConsolidatedBook> getConsolidatedBook(const std::string& symbol) const;
     std::vector<std::string> getAvailableSymbols() const;
     std::unordered_map<std::string, CrossExchangeOrderBook> getAllAggregatedBooks() const;
     
@@ -92,15 +112,26 @@ public:
     std::string placeOrder(const std::string& exchange, const Order& order);
     bool cancelOrder(const std::string& exchange, const std::string& order_id);
     bool cancelAllOrders(const std::string& exchange, const std::string& symbol = "");
+    // Splits a parent order across the connected venues by consolidated depth, taker fees,
+    // latency and balances, sends the children concurrently and reports the fills and
+    // slippage against the book at arrival. A LIMIT parent's price bounds the levels taken.
+    RouteReport routeOrder(const Order& parent, const RouteParams& params = {});
     
     // Account information
     ExchangeBalance getBalance(const std::string& exchange, const std::string& asset) const;
     std::unordered_map<std::string, ExchangeBalance> getAllBalances(const std::string& exchange) const;
     double getTotalBalance(const std::string& asset) const; // Across all exchanges
+    void onBalanceUpdate(const std::string& exchange, const ExchangeBalance& balance); // Push from account streams
     
     // Arbitrage opportunities
     std::vector<ArbitrageOpportunity> findArbitrageOpportunities(double min_profit_bps = 10.0) const;
+    // Multi-leg cycles through base_asset, as opportunities: buy/sell exchange are the first
+    // and last legs' venues, max_size and profit_usd are in base_asset units
     std::vector<ArbitrageOpportunity> findTriangularArbitrage(const std::string& base_asset = "BTC") const;
+    // Negative cycles in the currency graph still open at current prices, best first
+    std::vector<ArbitrageCycle> findArbitrageCycles() const;
+    // Crosses at or above this are pushed to the arbitrage callback as book updates land
+    void setArbitrageThreshold(double min_profit_bps) { arbitrage_min_profit_bps_ = min_profit_bps; }
     
     // Risk and performance metrics
     double getExchangeLatency(const std::string& exchange) const;
@@ -110,12 +141,19 @@ public:
     // Configuration and status
     void updateExchangeConfig(const std::string& exchange, const ExchangeConfig& config);
     ExchangeConfig getExchangeConfig(const std::string& exchange) const;
+    // Replaces (or adds) an exchange's connector, e.g. with a stub; call before start()
+    void setConnector(const std::string& exchange, std::unique_ptr<class ExchangeConnector> connector);
+    // Connectors run on this runtime's threads; call before start(). Without one, start()
+    // creates a single-context runtime and stop() stops it.
+    void setIoRuntime(std::shared_ptr<IoRuntime> runtime);
     nlohmann::json getStatus() const;
 
     // Callbacks for real-time updates
     void setOrderBookUpdateCallback(std::function<void(const std::string&, const std::string&, const OrderBook&)> callback);
     void setTradeCallback(std::function<void(const std::string&, const Trade&)> callback);
     void setArbitrageCallback(std::function<void(const ArbitrageOpportunity&)> callback);
+    // Runs on the gateway's graph worker thread
+    void setArbitrageCycleCallback(std::function<void(const ArbitrageCycle&)> callback);
 
 private:
     // Configuration and state
@@ -126,9 +164,40 @@ private:
     // Exchange connectors (one per exchange)
     std::unordered_map<std::string, std::unique_ptr<class ExchangeConnector>> connectors_;
     
-    // Aggregated market data
-    mutable std::mutex books_mutex_;
-    std::unordered_map<std::string, CrossExchangeOrderBook> aggregated_books_;
+    // Aggregated market data, one slot per symbol. A slot's mutex serializes only the
+    // writers of that symbol; each update publishes an immutable snapshot that readers
+    // pick up with an atomic load, RCU style.
+    // One venue's top of book waiting to be applied to the currency graph
+    struct GraphQuote {
+        std::string exchange;
+        double taker_fee = 0.0;
+        double bid_price = 0.0, bid_size = 0.0;
+        double ask_price = 0.0, ask_size = 0.0;
+    };
+    struct SymbolSlot {
+        std::string symbol;
+        std::mutex mutex;
+        CrossExchangeOrderBook book;           // Writer's working copy
+        VenueRanking ranking;                  // Venues ranked by bid and ask
+        std::shared_ptr<const CrossExchangeOrderBook> snapshot;
+        ConsolidatedBookBuilder consolidated;  // Venue ids match the ranking's indexes
+        std::vector<GraphQuote> graph_pending; // Newest per venue, under mutex
+        std::atomic<bool> graph_queued{false}; // On the dirty stack
+        SymbolSlot* graph_next = nullptr;      // Dirty stack link, owned by whoever queued the slot
+        bool venue_cap_logged = false;         // A venue past ConsolidatedLevel::MAX_VENUES was reported
+    };
+    // Open-addressed symbol -> slot table. Entries are only ever added, so lookups probe
+    // without locking; when half full it is copied at twice the size and the old table
+    // is retired (kept until destruction) in case a reader is still probing it.
+    struct SlotTable {
+        explicit SlotTable(size_t capacity);
+        size_t mask;
+        std::unique_ptr<std::atomic<SymbolSlot*>[]> entries;
+    };
+    std::atomic<SlotTable*> slot_table_{nullptr};
+    std::mutex slots_mutex_;                               // Slot creation only
+    std::vector<std::unique_ptr<SymbolSlot>> slots_;
+    std::vector<std::unique_ptr<SlotTable>> slot_tables_;  // Current table last
     
     // Balance tracking
     mutable std::mutex balances_mutex_;
@@ -143,22 +212,52 @@ private:
     std::function<void(const std::string&, const std::string&, const OrderBook&)> orderbook_callback_;
     std::function<void(const std::string&, const Trade&)> trade_callback_;
     std::function<void(const ArbitrageOpportunity&)> arbitrage_callback_;
+    std::atomic<double> arbitrage_min_profit_bps_{15.0};
+    std::atomic<uint64_t> arbitrage_signals_{0};
+    
+    // Every venue's top of book as one currency graph, searched for cycles per update.
+    // Book updates only park their quote on the symbol's slot and push the slot onto a
+    // lock-free dirty stack; one worker applies the quotes and runs the searches, so
+    // the book path never waits on the graph. graph_mutex_ is between the worker and
+    // findArbitrageCycles() only.
+    mutable std::mutex graph_mutex_;
+    CurrencyGraph currency_graph_;
+    std::atomic<SymbolSlot*> graph_dirty_{nullptr};
+    std::mutex graph_wake_mutex_;          // Taken only when the dirty stack turns non-empty
+    std::condition_variable graph_wake_cv_;
+    bool graph_stopping_ = false;          // Under graph_wake_mutex_
+    std::thread graph_thread_;
+    std::function<void(const ArbitrageCycle&)> cycle_callback_;
+    std::atomic<uint64_t> cycle_signals_{0};
+    
+    // Periodic work (balance reconciliation) runs on one timer thread
+    TimerService timers_;
     
-    // Threading
-    std::vector<std::thread> worker_threads_;
+    // Shared I/O threads for the connectors
+    std::shared_ptr<IoRuntime> io_runtime_;
+    bool owns_io_runtime_ = false;
     
     // Internal methods
-    void updateAggregatedBook(const std::string& symbol);
+    SymbolSlot* findSlot(const std::string& symbol) const;
+    SymbolSlot& slotFor(const std::string& symbol);
+    template <typename Fn>
+    void forEachSlot(Fn fn) const;
+    void updateAggregatedBook(SymbolSlot& slot);
     void onOrderBookUpdate(const std::string& exchange, const std::string& symbol, const OrderBook& book);
+    void queueGraphUpdate(SymbolSlot& slot);
+    void graphLoop();
     void onTradeUpdate(const std::string& exchange, const Trade& trade);
-    void scanArbitrageOpportunities();
     void updateBalances(const std::string& exchange);
     void updateLatency(const std::string& exchange, double latency_ms);
     
     // Arbitrage calculation helpers
     double calculateArbitrageProfit(const std::string& symbol, const std::string& buy_exchange, 
                                    const std::string& sell_exchange) const;
-    double calculateMaxArbitrageSize(const ArbitrageOpportunity& opp) const;
+    bool isUsableVenue(const VenueQuote& venue) const { return isExchangeConnected(venue.exchange); }
+    double takerFee(const std::string& exchange) const;
+    ArbitrageSize sizeCross(const SymbolSlot& slot, const VenueCross& cross) const;
+    ArbitrageOpportunity makeOpportunity(const SymbolSlot& slot, const VenueCross& cross,
+                                         const ArbitrageSize& sized) const;
     double calculateConfidenceScore(const ArbitrageOpportunity& opp) const;
     
     // Utility methods
@@ -176,12 +275,24 @@ public:
     virtual void connect() = 0;
     virtual void disconnect() = 0;
     virtual bool isConnected() const = 0;
+    // Runtime whose threads run the connection; set before connect(). Connectors that
+    // ignore it run their own.
+    virtual void setIoRuntime(std::shared_ptr<IoRuntime>) {}
     
     virtual std::string placeOrder(const Order& order) = 0;
     virtual bool cancelOrder(const std::string& order_id) = 0;
+    // Places an order and returns the fills the venue reported in its response. Venues that
+    // only report fills on the user stream leave them empty.
+    virtual ChildExecution executeOrder(const Order& order) {
+        ChildExecution execution;
+        execution.order_id = placeOrder(order);
+        return execution;
+    }
     
     virtual OrderBook getOrderBook(const std::string& symbol) const = 0;
     virtual ExchangeBalance getBalance(const std::string& asset) const = 0;
+    // Every asset the account holds on the venue; empty if the venue can't list them
+    virtual std::vector<ExchangeBalance> getBalances() const { return {}; }
     virtual std::vector<std::string> getAvailableSymbols() const = 0;
     
     virtual void setOrderBookCallback(std::function<void(const std::string&, const OrderBook&)> callback) = 0;
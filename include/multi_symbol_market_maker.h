@@ -0,0 +1,91 @@
+#pragma once
+
+#include "logger.h"
+#include "market_maker_strategy.h"
+#include "order_manager.h"
+#include "risk_manager.h"
+#include "strategy.h"
+#include "strategy_actor.h"
+#include "symbol_registry.h"
+#include "types.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+// Runs one MarketMakerStrategy per symbol, sharded across StrategyActor threads by
+// symbol id. Each shard owns its symbols' books and strategies; market data and
+// execution reports are routed to the owning shard. The order manager and the risk
+// manager are the account's and shared by every shard, so there is one REST mirror and
+// position, loss and rate limits hold for the account as a whole.
+//
+// Config:
+//   "multi_symbol": {"threads": 2, "pin_threads": true, "first_core": 1,
+//                    "symbols": ["BTCUSDT", {"symbol": "ETHUSDT", "config": {...overrides}}]}
+class MultiSymbolMarketMaker : public Strategy {
+public:
+    // The owner starts and stops the order manager
+    MultiSymbolMarketMaker(std::shared_ptr<Logger> logger,
+                           std::shared_ptr<OrderManager> order_manager,
+                           std::shared_ptr<RiskManager> risk_manager,
+                           const nlohmann::json& config);
+    ~MultiSymbolMarketMaker();
+
+    // Symbol-aware entry points (called from the network threads)
+    void onStreamMessage(const std::string& stream, const nlohmann::json& data);
+    void onUserData(const nlohmann::json& message);
+
+    // Strategy interface. Book updates carry no symbol and are not routable; ack,
+    // reject and fill events are broadcast and ignored by strategies that don't own the order.
+    void onOrderBookUpdate(const OrderBook& order_book) override;
+    void onTrade(const Trade& trade) override;
+    void onOrderAck(const OrderAck& ack) override;
+    void onOrderReject(const OrderReject& reject) override;
+    void onOrderFill(const OrderFill& fill) override;
+
+    void initialize() override;
+    void shutdown() override;
+
+    std::string getName() const override { return "MultiSymbolMarketMaker"; }
+    void updateConfig(const nlohmann::json& config) override;
+    nlohmann::json getSnapshot() const override;
+
+    // Combined depth + trade stream path for every hosted symbol
+    std::string streamEndpoint() const;
+    std::vector<std::string> getSymbols() const;
+
+    nlohmann::json getStatus() const;
+
+private:
+    struct Shard {
+        std::unique_ptr<StrategyActor> actor;
+    };
+
+    struct HostedSymbol {
+        std::string symbol;
+        nlohmann::json overrides;
+        std::shared_ptr<MarketMakerStrategy> strategy;
+        size_t shard;
+    };
+
+    nlohmann::json symbolConfig(const nlohmann::json& config, const HostedSymbol& hosted) const;
+    StrategyActor* route(uint32_t symbol_id) const;
+
+    std::shared_ptr<Logger> logger_;
+    std::shared_ptr<OrderManager> order_manager_;
+    std::shared_ptr<RiskManager> risk_manager_;
+    nlohmann::json config_;
+
+    std::vector<Shard> shards_;
+    std::vector<HostedSymbol> symbols_;
+    // Routing table indexed by symbol id; written before the actors start
+    std::vector<int> shard_of_;
+
+    mutable std::atomic<uint64_t> unrouted_{0};
+    bool running_ = false;
+};
+
+} // namespace moneybot
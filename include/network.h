@@ -1,5 +1,6 @@
 #pragma once
 
+#include "io_runtime.h"
 #include "logger.h"
 #include "order_book.h"
 #include "order_manager.h"
@@ -9,8 +10,15 @@
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/beast.hpp>
 #include <boost/beast/ssl.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <random>
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace moneybot {
@@ -18,32 +26,142 @@ namespace moneybot {
     namespace beast = boost::beast;
     using json = nlohmann::json;
 
+    // Streams reconnect on their own after a failure, with jittered exponential backoff.
+    // Reconnects reuse cached DNS results (refreshed in the background), resume the TLS
+    // session and, with "standby", take a connection whose TCP and TLS are already up.
+    //
+    // Config:
+    //   "reconnect": {"initial_ms": 250, "max_ms": 10000, "jitter": 0.5,
+    //                 "dns_refresh_sec": 60, "standby": false, "standby_refresh_sec": 20}
     class Network : public std::enable_shared_from_this<Network> {
     public:
-        Network(std::shared_ptr<Logger> logger, std::shared_ptr<OrderBook> order_book, const json& config);
+        // With a lease the streams run on the shared I/O runtime and run()/runUserDataStream()
+        // return at once; without one Network owns an io_context and they block running it
+        Network(std::shared_ptr<Logger> logger, std::shared_ptr<OrderBook> order_book, const json& config,
+                IoRuntime::Lease lease = {});
         ~Network();
         void pingExchange(const std::string& url);
         void run(const std::string& host, const std::string& port,
                  const std::string& endpoint);
+        // Returns at once; the close runs on the connection's context, and nothing read
+        // after this call is delivered
         void stop();
-        // Connect to user data WebSocket
+        // Connect to user data WebSocket. With an order manager set the listenKey is kept
+        // alive every 30 minutes and each reconnect asks for a fresh one, so an expired key
+        // doesn't leave the stream reconnecting to a dead endpoint
         void runUserDataStream(const std::string& listenKey);
-        // Set order manager for user data event routing
+        // Set order manager for user data event routing and listenKey renewal
         void setOrderManager(std::shared_ptr<OrderManager> order_manager) { order_manager_ = order_manager; }
+        // Optional routing hooks: combined-stream payloads (stream name + data) and
+        // user data execution reports go here instead of the default handlers
+        using StreamHandler = std::function<void(const std::string&, const json&)>;
+        using UserDataHandler = std::function<void(const json&)>;
+        void setStreamHandler(StreamHandler handler) { stream_handler_ = std::move(handler); }
+        void setUserDataHandler(UserDataHandler handler) { user_data_handler_ = std::move(handler); }
+        // Streams to subscribe every time the market data connection comes up, in place of
+        // the configured websocket_subscription, so a reconnect restores the current set
+        using SubscriptionProvider = std::function<std::vector<std::string>()>;
+        void setSubscriptionProvider(SubscriptionProvider provider) { subscription_provider_ = std::move(provider); }
+        // Called on the connection's thread when the market data stream fails; it reconnects itself
+        using DisconnectHandler = std::function<void(const std::string&)>;
+        void setDisconnectHandler(DisconnectHandler handler) { disconnect_handler_ = std::move(handler); }
+        // Changes the live subscription. Requests made while connecting are held and sent
+        // after the initial subscribe; those older than the provider's snapshot are dropped
+        // on connect, as the snapshot already has them
+        void subscribe(const std::vector<std::string>& streams);
+        void unsubscribe(const std::vector<std::string>& streams);
+        // Market data stream up and subscribed
+        bool isConnected() const { return stream_open_.load(); }
+        // Reconnects, session resumption, standby use, DNS cache and reconnect-to-first-message time
+        json getStats() const;
 
     private:
+        using WsStream = beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+        using Clock = std::chrono::steady_clock;
+        static constexpr std::chrono::seconds CLOSE_TIMEOUT{2};    // Bounds stop()'s closing handshake
+
         static net::awaitable<void>
         connectWebSocket(std::shared_ptr<Network> self, const std::string& host, const std::string& port,
                          const std::string& endpoint);
+        // Up to and including the WebSocket handshake, from the standby if there is one
+        static net::awaitable<std::unique_ptr<WsStream>>
+        openStream(std::shared_ptr<Network> self, const std::string& host, const std::string& port,
+                   const std::string& endpoint, const std::string& user_agent);
+        // TCP connect and TLS handshake
+        static net::awaitable<std::unique_ptr<WsStream>>
+        connectTls(std::shared_ptr<Network> self, const std::string& host, const std::string& port);
+        static net::awaitable<net::ip::tcp::resolver::results_type>
+        resolve(std::shared_ptr<Network> self, const std::string& host, const std::string& port);
+        static net::awaitable<void> keepStandby(std::shared_ptr<Network> self, std::string host, std::string port);
+        static net::awaitable<void> keepListenKey(std::shared_ptr<Network> self);
+        void scheduleDnsRefresh();
+        void onFirstMessage(WsStream& stream, const std::string& host, const std::string& port,
+                            std::optional<Clock::time_point>& down_since);
+        std::chrono::milliseconds backoff(int attempt);
         void processMessage(const json& message);
+        void send(std::string message);
+        void writeNext();
         std::shared_ptr<Logger> logger_;
         std::shared_ptr<OrderBook> order_book_;
         std::shared_ptr<OrderManager> order_manager_;
+        StreamHandler stream_handler_;
+        UserDataHandler user_data_handler_;
+        SubscriptionProvider subscription_provider_;
+        DisconnectHandler disconnect_handler_;
         const json& config_;
-        net::io_context ioc_;
+        std::unique_ptr<net::io_context> own_ioc_;     // Only without a lease
+        IoRuntime::Lease lease_;
+        net::io_context& ioc_;
         net::ssl::context ssl_ctx_;
         std::unique_ptr<beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>>> ws_;
         beast::multi_buffer buffer_;
+
+        std::chrono::milliseconds backoff_initial_;
+        std::chrono::milliseconds backoff_max_;
+        double backoff_jitter_;
+        std::chrono::seconds dns_refresh_;
+        bool standby_enabled_;
+        std::chrono::seconds standby_refresh_;
+        std::mt19937 jitter_rng_{std::random_device{}()};
+        std::atomic<bool> stopping_{false};
+        net::steady_timer retry_timer_;             // Market data backoff
+        net::steady_timer user_data_retry_timer_;   // User data backoff
+        // Resolved endpoints, refreshed in the background so reconnects skip DNS
+        net::ip::tcp::resolver resolver_;
+        net::steady_timer dns_timer_;
+        std::string resolved_host_, resolved_port_;
+        net::ip::tcp::resolver::results_type resolved_;
+        // Last TLS session, offered on the next handshake with the same host
+        std::shared_ptr<SSL_SESSION> session_;
+        std::string session_host_;
+        // Connected and TLS-ready, waiting to be upgraded when the live stream fails
+        std::unique_ptr<WsStream> standby_;
+        std::string standby_host_, standby_port_;
+        Clock::time_point standby_at_;
+        net::steady_timer standby_timer_;
+        bool standby_running_ = false;
+        // User data stream key; renewed through the order manager's REST calls, which run
+        // on rest_pool_ so they don't hold up other connections sharing the I/O thread
+        std::string listen_key_;
+        net::steady_timer listen_key_timer_;
+        net::thread_pool rest_pool_{1};
+        std::atomic<bool> user_data_open_{false};
+
+        std::atomic<uint64_t> connects_{0};
+        std::atomic<uint64_t> reconnects_{0};
+        std::atomic<uint64_t> sessions_resumed_{0};
+        std::atomic<uint64_t> standby_used_{0};
+        std::atomic<uint64_t> dns_cache_hits_{0};
+        std::atomic<uint64_t> dns_refreshes_{0};
+        std::atomic<double> recovery_last_ms_{0.0};     // Failure to first message after reconnecting
+        std::atomic<double> recovery_avg_ms_{0.0};      // EWMA
+        std::atomic<double> recovery_max_ms_{0.0};
+        // Control messages, written one at a time on the strand once the stream is open
+        std::deque<std::string> outbox_;
+        bool writing_ = false;
+        uint64_t outbox_epoch_ = 0;     // Bumped per connection; a write to an older one is ignored
+        std::atomic<bool> stream_open_{false};
+        int request_id_ = 1;
         net::strand<net::any_io_executor> strand_;
     };
 } // namespace moneybot
\ No newline at end of file
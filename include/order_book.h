@@ -24,6 +24,9 @@ namespace moneybot {
         // Expose top N bids/asks for GUI
         std::vector<std::pair<double, double>> getTopBids(size_t n = 10) const;
         std::vector<std::pair<double, double>> getTopAsks(size_t n = 10) const;
+        // Copy up to n levels (best first) into caller-owned arrays; returns the count. No allocation.
+        size_t copyTopBids(double* prices, double* sizes, size_t n) const;
+        size_t copyTopAsks(double* prices, double* sizes, size_t n) const;
     private:
         struct Tick {
             int64_t timestamp;
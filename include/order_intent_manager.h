@@ -0,0 +1,91 @@
+#pragma once
+
+#include "logger.h"
+#include "order_manager.h"
+#include "types.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace moneybot {
+
+// A quote the strategy wants resting in the book
+struct QuoteIntent {
+    OrderSide side;
+    double price = 0.0;
+    double quantity = 0.0; // zero means "no quote on this side"
+};
+
+// A quote we currently have resting in the book
+struct LiveQuote {
+    std::string order_id;
+    OrderSide side;
+    double price = 0.0;
+    double quantity = 0.0;
+    std::chrono::system_clock::time_point timestamp;
+};
+
+enum class QuoteActionType {
+    KEEP,    // Live quote is within tolerance, leave it alone
+    PLACE,   // New quote
+    AMEND,   // Cancel-replace of a live quote in a single request
+    CANCEL   // Live quote no longer wanted
+};
+
+struct QuoteAction {
+    QuoteActionType type;
+    std::string order_id;     // Live order for KEEP/AMEND/CANCEL
+    OrderSide side;
+    double price = 0.0;       // Target price for PLACE/AMEND
+    double quantity = 0.0;    // Target size for PLACE/AMEND
+};
+
+struct QuoteActionResult {
+    QuoteAction action;
+    bool success = false;
+    std::string new_order_id; // Set for successful PLACE/AMEND
+};
+
+struct QuoteTolerance {
+    double price_bps = 1.0;     // Leave quotes within this distance of the target
+    double size_ratio = 0.1;    // Leave quotes within this relative size of the target
+    bool amend_supported = true; // Venue supports atomic cancel-replace
+};
+
+// Order-intent layer: the strategy declares the quotes it wants per side and this
+// computes and sends the minimal set of actions to get there.
+class OrderIntentManager {
+public:
+    OrderIntentManager(std::shared_ptr<Logger> logger,
+                       std::shared_ptr<OrderManager> order_manager,
+                       const QuoteTolerance& tolerance = QuoteTolerance());
+
+    // Diff live quotes against desired quotes (pure, no I/O)
+    std::vector<QuoteAction> plan(const std::vector<LiveQuote>& live,
+                                  const std::vector<QuoteIntent>& desired) const;
+
+    // Send actions: cancels first (one batch per symbol), then amends, then new quotes,
+    // so exposure never exceeds the old or the new quotes while they change over
+    std::vector<QuoteActionResult> execute(const std::string& symbol,
+                                           const std::vector<QuoteAction>& actions);
+
+    void setTolerance(const QuoteTolerance& tolerance) { tolerance_ = tolerance; }
+    const QuoteTolerance& getTolerance() const { return tolerance_; }
+
+    // Message accounting
+    uint64_t getMessagesSent() const { return messages_sent_; }
+    uint64_t getQuotesKept() const { return quotes_kept_; }
+
+private:
+    bool withinTolerance(const LiveQuote& live, const QuoteIntent& desired) const;
+
+    std::shared_ptr<Logger> logger_;
+    std::shared_ptr<OrderManager> order_manager_;
+    QuoteTolerance tolerance_;
+
+    uint64_t messages_sent_ = 0;
+    uint64_t quotes_kept_ = 0;
+};
+
+} // namespace moneybot
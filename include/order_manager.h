@@ -2,10 +2,16 @@
 #define ORDER_MANAGER_H
 
 #include "logger.h"
+#include "order_mirror.h"
+#include "rate_limiter.h"
 #include "types.h"
 #include <boost/asio.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <nlohmann/json.hpp>
@@ -26,11 +32,20 @@ public:
                           RejectCallback reject_cb = nullptr, FillCallback fill_cb = nullptr);
     bool cancelOrder(const std::string& order_id);
     bool cancelAllOrders(const std::string& symbol);
+    std::string replaceOrder(const std::string& order_id, const Order& order);
+    // One batch per symbol: a single cancel-all when the ids are all its open orders,
+    // otherwise the per-order cancels sent concurrently
+    std::vector<bool> cancelOrders(const std::string& symbol, const std::vector<std::string>& order_ids,
+                                   int* requests_sent = nullptr);
     
-    // Account information
+    // Account information (served from the local mirror)
     std::vector<Balance> getBalances();
     std::vector<Position> getPositions();
     std::vector<Order> getOpenOrders(const std::string& symbol = "");
+    const OrderMirror& getMirror() const { return mirror_; }
+    
+    // Reconcile the mirror against REST
+    bool reconcile();
     
     // Lifecycle
     void start();
@@ -39,8 +54,14 @@ public:
     // Configuration
     void updateConfig(const nlohmann::json& config);
     
-    // User data stream
+    // Share the risk manager's limiter so REST request weight and order rates
+    // are accounted against the same budget
+    void setRateLimiter(std::shared_ptr<RateLimiter> rate_limiter) { rate_limiter_ = rate_limiter; }
+    
+    // User data stream: a new (or the still valid) listenKey, empty on failure
     std::string createUserDataStream();
+    // Extends the key's 60 minute validity; false when it has expired and a new one is needed
+    bool keepAliveUserDataStream(const std::string& listen_key);
 
     // WebSocket handlers (made public for event routing)
     void handleOrderUpdate(const nlohmann::json& data);
@@ -51,6 +72,13 @@ private:
     nlohmann::json makeRequest(const std::string& endpoint, const std::string& method = "GET", 
                               const nlohmann::json& data = {});
     std::string signRequest(const std::string& query_string);
+    // POST creates a listenKey, PUT keeps one alive; nullopt when the request failed
+    std::optional<nlohmann::json> userDataStreamRequest(boost::beast::http::verb method,
+                                                        const std::string& listen_key);
+    // nullopt when the request failed, as opposed to an empty account
+    std::optional<std::vector<Balance>> fetchBalances();
+    std::optional<std::vector<Order>> fetchOpenOrders(const std::string& symbol = "");
+    void reconcileLoop();
     
     // Internal helpers
     std::string generateClientOrderId();
@@ -73,6 +101,17 @@ private:
     };
     std::unordered_map<std::string, OrderCallbacks> callbacks_;
     
+    // Client order ids; generateClientOrderId is called from every shard thread
+    std::string client_id_prefix_;
+    std::atomic<uint64_t> next_client_id_{0};
+    
+    // Local order/account mirror
+    OrderMirror mirror_;
+    int reconcile_interval_ms_;
+    
+    // Request weight budget (VENUE scope)
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    
     // HTTP client
     boost::asio::io_context ioc_;
     std::unique_ptr<boost::asio::ip::tcp::resolver> resolver_;
@@ -82,8 +121,10 @@ private:
     mutable std::mutex config_mutex_;
     
     // State
-    bool running_;
+    std::atomic<bool> running_;
     std::thread worker_thread_;
+    std::mutex reconcile_mutex_;
+    std::condition_variable reconcile_cv_;
 };
 
 } // namespace moneybot
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "types.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace moneybot {
+
+// Immutable view of the account published by OrderMirror
+struct AccountSnapshot {
+    std::unordered_map<std::string, Order> open_orders;   // order_id -> order
+    std::unordered_map<std::string, Balance> balances;    // asset -> balance
+    std::unordered_map<std::string, Position> positions;  // symbol -> position
+    std::chrono::system_clock::time_point last_reconcile;
+    uint64_t version = 0;
+};
+
+// In-memory mirror of open orders, balances and positions.
+// Kept current from the user data stream; REST is only used to seed and reconcile it.
+// Writers copy-on-write under a mutex, readers load the published snapshot without locking.
+class OrderMirror {
+public:
+    OrderMirror();
+
+    // Reads (lock-free)
+    std::shared_ptr<const AccountSnapshot> snapshot() const;
+    std::vector<Order> getOpenOrders(const std::string& symbol = "") const;
+    std::vector<Balance> getBalances() const;
+    std::vector<Position> getPositions() const;
+    Balance getBalance(const std::string& asset) const;
+    size_t getOpenOrderCount() const;
+    bool isSeeded() const { return seeded_.load(std::memory_order_acquire); }
+
+    // Stream updates
+    void applyOrder(const Order& order);
+    void removeOrder(const std::string& order_id);
+    void removeOrders(const std::string& symbol); // empty symbol removes all
+    void applyBalance(const Balance& balance);
+    void applyFill(const std::string& symbol, OrderSide side, double quantity, double price);
+
+    // Reconciliation against REST. beginReconcile() marks when the fetch started;
+    // reconcile() takes the REST view of every order and balance except those the
+    // mirror changed after that mark, which are newer than the snapshot. It returns
+    // false only for a fetch older than one already merged.
+    uint64_t beginReconcile() const;
+    bool reconcile(uint64_t token, const std::vector<Order>& open_orders,
+                   const std::vector<Balance>& balances);
+
+private:
+    template<typename Fn>
+    void modify(Fn&& fn);
+
+    std::shared_ptr<const AccountSnapshot> snapshot_;
+    std::mutex write_mutex_;
+    std::atomic<uint64_t> stream_events_{0};
+    // Event number of the last change per key, kept under write_mutex_ until a
+    // reconcile that started later has merged past it
+    std::unordered_map<std::string, uint64_t> order_changed_;    // order_id
+    std::unordered_map<std::string, uint64_t> symbol_cleared_;   // removeOrders(symbol)
+    std::unordered_map<std::string, uint64_t> balance_changed_;  // asset
+    uint64_t clear_all_event_ = 0;                               // removeOrders("")
+    uint64_t reconciled_through_ = 0;
+    std::atomic<bool> seeded_{false};
+};
+
+} // namespace moneybot
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "logger.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+// Mid-price bars for a universe, aligned on a common clock. Series are stored
+// symbol-major (log_prices[s * bars + t]); gaps are forward-filled.
+struct BarMatrix {
+    std::vector<std::string> symbols;
+    std::vector<int64_t> timestamps;   // Bar open times (ms)
+    int64_t bar_ms = 60000;
+    std::vector<double> log_prices;
+
+    size_t bars() const { return timestamps.size(); }
+    const double* series(size_t s) const { return log_prices.data() + s * bars(); }
+};
+
+struct PairDiscoveryParams {
+    int64_t bar_ms = 60000;
+    double lookback_days = 30.0;
+    double min_coverage = 0.9;          // Share of bars a symbol must have traded in
+    double min_correlation = 0.7;       // Return correlation to become a candidate
+    size_t max_candidates = 5000;       // Highest correlations kept for cointegration
+    int adf_lags = 1;                   // Augmented lags in the ADF regression
+    double adf_critical = -3.34;        // Engle-Granger 5% critical value, two variables
+    double min_half_life_minutes = 30.0;
+    double max_half_life_minutes = 1440.0;
+    size_t max_pairs = 20;              // Length of the ranked output
+    size_t threads = 0;                 // 0: hardware concurrency
+
+    PairDiscoveryParams() = default;
+    PairDiscoveryParams(const nlohmann::json& j);
+};
+
+struct PairCandidate {
+    std::string base_symbol;
+    std::string hedge_symbol;
+    double correlation = 0.0;           // Of bar returns
+    double hedge_ratio = 0.0;           // OLS of log(base) on log(hedge)
+    double adf_stat = 0.0;              // Engle-Granger t-stat on the residuals
+    double half_life_minutes = 0.0;     // 0 when the residual is not mean reverting
+    bool cointegrated = false;
+};
+
+struct PairDiscoveryReport {
+    size_t symbols = 0;
+    size_t bars = 0;
+    size_t candidates = 0;              // Pairs through the correlation screen
+    size_t cointegrated = 0;
+    std::vector<PairCandidate> pairs;   // Ranked, best first
+    double correlation_ms = 0.0;
+    double cointegration_ms = 0.0;
+
+    // Ranked pairs in the shape of strategies.statistical_arbitrage.pairs, for hot-loading
+    nlohmann::json toConfigPairs() const;
+    nlohmann::json toJson() const;
+};
+
+// Universe-wide pair discovery: return-correlation screen over every symbol pair,
+// then Engle-Granger cointegration (OLS + ADF on the residuals) and half-life on the
+// candidates, ranked by ADF statistic.
+//
+// The correlation matrix is a blocked R'R over standardized returns: a 4x8 register
+// tile of float accumulators walks the bar-major return matrix, so the inner loop is
+// fixed-width multiply-adds the compiler vectorizes, and tiles are flushed into double
+// sums every 128 bars to bound rounding. Row blocks and candidates are spread
+// over worker threads.
+class PairDiscovery {
+public:
+    explicit PairDiscovery(PairDiscoveryParams params = {}, std::shared_ptr<Logger> logger = nullptr);
+
+    // Mid-price bars from the tick store over [end_ms - lookback, end_ms)
+    // (end_ms = 0: up to the newest tick). Symbols below min_coverage are dropped.
+    BarMatrix loadBars(const std::string& db_path, int64_t end_ms = 0) const;
+
+    PairDiscoveryReport run(const BarMatrix& bars) const;
+
+    // Return correlations, symbols x symbols (row-major, full matrix)
+    std::vector<double> correlationMatrix(const BarMatrix& bars) const;
+
+    // Engle-Granger test of base on hedge
+    PairCandidate testPair(const BarMatrix& bars, size_t base, size_t hedge) const;
+
+    const PairDiscoveryParams& params() const { return params_; }
+
+private:
+    size_t threadCount() const;
+
+    PairDiscoveryParams params_;
+    std::shared_ptr<Logger> logger_;
+};
+
+// Reruns discovery on an interval on its own thread (a run takes seconds to minutes,
+// too long for a timer callback). Each ranked list is written to output_path and
+// handed to the callback for hot-loading, e.g. through
+// strategy->updateConfig({{"pairs", report.toConfigPairs()}}), which a StrategyActor
+// delivers on its own thread.
+class PairDiscoveryJob {
+public:
+    using Callback = std::function<void(const PairDiscoveryReport&)>;
+
+    PairDiscoveryJob(PairDiscoveryParams params, std::string db_path, std::string output_path,
+                     std::chrono::minutes interval, std::shared_ptr<Logger> logger);
+    ~PairDiscoveryJob();
+
+    void setCallback(Callback callback) { callback_ = std::move(callback); }
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    PairDiscoveryReport runOnce();
+
+private:
+    void loop();
+
+    PairDiscovery discovery_;
+    std::string db_path_;
+    std::string output_path_;
+    std::chrono::minutes interval_;
+    std::shared_ptr<Logger> logger_;
+    Callback callback_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace moneybot
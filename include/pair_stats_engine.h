@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace moneybot {
+
+struct PairStatsParams {
+    size_t window = 200;              // Samples in the regression window
+    size_t recompute_interval = 0;    // Exact rebuild every N samples (0: once per window)
+    double sample_interval_sec = 1.0; // Time between sample() calls, for half-lives
+};
+
+// Rolling statistics for one pair, regressing base on hedge in log prices:
+// log(base) = intercept + hedge_ratio * log(hedge) + spread
+struct PairStats {
+    bool ready = false;               // Both series have a full window
+    size_t samples = 0;
+    double hedge_ratio = 0.0;         // OLS beta
+    double intercept = 0.0;
+    double correlation = 0.0;
+    double spread = 0.0;              // Latest log(base) - hedge_ratio * log(hedge)
+    double spread_mean = 0.0;         // Window mean of the same (equals the intercept)
+    double spread_std = 0.0;          // Residual std
+    double z_score = 0.0;
+    double ar_coefficient = 0.0;      // lambda in d(spread) = lambda * spread[t-1] + c
+    double half_life_sec = 0.0;       // 0 when the spread is not mean reverting
+};
+
+// Rolling correlation, OLS hedge ratio, z-score and mean-reversion half-life for many
+// pairs at O(1) per pair per sample.
+//
+// Prices arrive at any rate through onPrice(); sample() closes a bar, pushing the
+// latest price of every symbol (carried forward if it didn't trade) and updating every
+// pair. Per-symbol window sums (levels, lagged levels, differences) are shared by all
+// pairs on the symbol; each pair keeps only its four cross sums. The spread moments
+// and the AR(1) fit for the half-life are expanded in those sums, so they hold for the
+// current hedge ratio without revisiting the window.
+//
+// Values are stored shifted by a per-symbol reference log price to keep the sums small,
+// and every sum is rebuilt exactly from the rings every recompute_interval samples,
+// re-centring as it goes, so subtraction drift stays bounded.
+class PairStatsEngine {
+public:
+    explicit PairStatsEngine(PairStatsParams params = {});
+
+    // Registration is idempotent and returns the dense index
+    size_t addSymbol(const std::string& symbol);
+    size_t addPair(const std::string& base, const std::string& hedge);
+    int findSymbol(const std::string& symbol) const;   // -1 if unknown
+
+    void onPrice(size_t symbol, double price);
+    void onPrice(const std::string& symbol, double price);
+
+    // Closes the current bar and updates every pair
+    void sample();
+
+    const PairStats& stats(size_t pair) const { return pairs_[pair].stats; }
+    size_t pairCount() const { return pairs_.size(); }
+    size_t symbolCount() const { return series_.size(); }
+    uint64_t sampleCount() const { return samples_; }
+    const PairStatsParams& params() const { return params_; }
+
+    // Exact rebuild of every sum from the rings (also run on the recompute interval)
+    void recompute();
+
+private:
+    struct Series {
+        std::string symbol;
+        double latest_log = 0.0;
+        bool has_price = false;
+        double shift = 0.0;            // Reference log price the ring values are relative to
+        std::vector<double> ring;      // window + 1 shifted log prices
+        uint64_t pushed = 0;
+
+        // Levels over the last n samples
+        size_t n = 0;
+        double sx = 0.0, sxx = 0.0;
+        // Lag terms over the last m steps: x' = x[t-1], d = x[t] - x[t-1]
+        size_t m = 0;
+        double sl = 0.0, sll = 0.0, sd = 0.0, sdl = 0.0;
+
+        double at(size_t ago) const { return ring[(pushed - 1 - ago) % ring.size()]; }
+    };
+
+    struct Pair {
+        size_t base;
+        size_t hedge;
+        // Cross sums, aligned from the bar both series were first sampled together
+        size_t n = 0;
+        size_t m = 0;
+        double sxy = 0.0;              // base * hedge
+        double sl_xy = 0.0;            // base' * hedge'
+        double sd_x_l_y = 0.0;         // d(base) * hedge'
+        double sd_y_l_x = 0.0;         // d(hedge) * base'
+        PairStats stats;
+    };
+
+    void pushSeries(Series& s);
+    void updatePair(Pair& p);
+    void computeStats(Pair& p);
+    void rebuildSeries(Series& s);
+    void rebuildPair(Pair& p);
+
+    PairStatsParams params_;
+    std::vector<Series> series_;
+    std::vector<Pair> pairs_;
+    std::unordered_map<std::string, size_t> symbol_index_;
+    uint64_t samples_ = 0;
+};
+
+} // namespace moneybot
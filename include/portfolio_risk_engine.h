@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+struct PortfolioRiskConfig {
+    double lambda = 0.94;               // EWMA decay per sample (RiskMetrics)
+    double confidence = 0.99;
+    int sample_interval_ms = 1000;      // Return sampling interval
+    int64_t horizon_ms = 86400000;      // VaR horizon, scaled by sqrt(time)
+    size_t max_symbols = 512;
+    // Portfolio VaR limit in quote currency enforced on every pre-trade check; 0 disables it
+    double max_var = 0.0;
+
+    PortfolioRiskConfig() = default;
+    PortfolioRiskConfig(const nlohmann::json& j);
+};
+
+struct PortfolioRiskSnapshot {
+    double var = 0.0;
+    double expected_shortfall = 0.0;
+    double gross_exposure = 0.0;
+    double net_exposure = 0.0;
+    double max_var = 0.0;
+    size_t symbols = 0;
+    uint64_t samples = 0;
+};
+
+// Streaming parametric VaR/ES on an EWMA covariance matrix of symbol returns.
+// Returns are sampled on a fixed interval and folded in with a rank-1 update, after
+// which the cached covariance-exposure product is rebuilt (both O(n^2), contiguous
+// rows). A single price or position change only moves one exposure, so VaR is
+// kept current in O(n) and a what-if position check costs O(1).
+class PortfolioRiskEngine {
+public:
+    explicit PortfolioRiskEngine(const PortfolioRiskConfig& config = PortfolioRiskConfig());
+
+    // Tick stream and position feed (keyed by SymbolRegistry id)
+    void onPrice(uint32_t symbol_id, double price, int64_t now_ms);
+    void setPosition(uint32_t symbol_id, double quantity);
+
+    // Portfolio VaR if symbol_id held new_quantity, everything else unchanged
+    double varWithPosition(uint32_t symbol_id, double new_quantity) const;
+    bool isPositionAllowed(uint32_t symbol_id, double new_quantity) const;
+
+    double getPrice(uint32_t symbol_id) const;
+    void setMaxVaR(double max_var);             // 0 disables the limit
+    bool hasLimit() const { return has_limit_.load(std::memory_order_relaxed); }  // Lock-free
+    PortfolioRiskSnapshot snapshot() const;
+    nlohmann::json getReport() const;
+
+private:
+    int32_t slotFor(uint32_t symbol_id);
+    void sampleReturns();
+    void rebuildExposureProduct();
+    void setExposure(size_t slot, double exposure);
+    double varFromVariance(double variance) const;
+    double varWithPositionLocked(uint32_t symbol_id, double new_quantity) const;
+
+    PortfolioRiskConfig config_;
+    double z_score_;
+    double es_factor_;       // phi(z) / (1 - confidence)
+    double horizon_scale_;   // sqrt(horizon / sample interval)
+
+    size_t capacity_;
+    size_t count_ = 0;
+    std::vector<int32_t> slot_of_;      // symbol id -> slot, -1 if untracked
+    std::vector<double> covariance_;    // capacity x capacity, row-major
+    std::vector<double> price_;
+    std::vector<double> sample_price_;  // Price at the last return sample
+    std::vector<double> quantity_;
+    std::vector<double> exposure_;      // quantity * price
+    std::vector<double> cov_exposure_;  // covariance * exposure
+    std::vector<double> returns_;       // Scratch for the rank-1 update
+    double variance_ = 0.0;             // exposure' * covariance * exposure
+
+    int64_t last_sample_ms_ = -1;
+    uint64_t samples_ = 0;
+    std::atomic<bool> has_limit_{false};
+
+    mutable std::mutex mutex_;
+};
+
+} // namespace moneybot
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "symbol_registry.h"
+#include "types.h"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace moneybot {
+
+// Mutex-free pre-trade risk check on the order path.
+// Per-symbol state lives in a flat array indexed by SymbolRegistry id. Positions and
+// limits have a single writer (RiskManager under its own lock) and are published
+// through relaxed atomics, so readers never block and never see a torn value.
+class PreTradeRiskGate {
+public:
+    // Rejection reasons, OR-ed together in the check result (0 = pass)
+    static constexpr uint32_t PASS = 0;
+    static constexpr uint32_t REJECT_EMERGENCY_STOP = 1u << 0;
+    static constexpr uint32_t REJECT_ORDER_SIZE = 1u << 1;
+    static constexpr uint32_t REJECT_POSITION = 1u << 2;
+    static constexpr uint32_t REJECT_ORDER_RATE = 1u << 3;
+    static constexpr uint32_t REJECT_UNKNOWN_SYMBOL = 1u << 4;
+    static constexpr uint32_t REJECT_PORTFOLIO_VAR = 1u << 5;   // Set by RiskManager, not check()
+
+    PreTradeRiskGate() {
+        for (auto& state : symbols_) {
+            state.position.store(0.0, std::memory_order_relaxed);
+            state.max_position.store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    // Hot path: size and position limits in one pass (rates live in RateLimiter)
+    uint32_t check(uint32_t symbol_id, OrderSide side, double quantity) const {
+        if (symbol_id >= SymbolRegistry::MAX_SYMBOLS) return REJECT_UNKNOWN_SYMBOL;
+        const SymbolState& state = symbols_[symbol_id];
+
+        double signed_qty = side == OrderSide::BUY ? quantity : -quantity;
+        double new_position = state.position.load(std::memory_order_relaxed) + signed_qty;
+        double symbol_max = state.max_position.load(std::memory_order_relaxed);
+        double max_position = symbol_max > 0.0 ? symbol_max : max_position_.load(std::memory_order_relaxed);
+
+        return (static_cast<uint32_t>(emergency_stopped_.load(std::memory_order_relaxed)) * REJECT_EMERGENCY_STOP) |
+            (static_cast<uint32_t>(quantity > max_order_size_.load(std::memory_order_relaxed)) * REJECT_ORDER_SIZE) |
+            (static_cast<uint32_t>(std::abs(new_position) > max_position) * REJECT_POSITION);
+    }
+
+    bool isPositionAllowed(uint32_t symbol_id, double new_position) const {
+        if (symbol_id >= SymbolRegistry::MAX_SYMBOLS) return false;
+        double symbol_max = symbols_[symbol_id].max_position.load(std::memory_order_relaxed);
+        double max_position = symbol_max > 0.0 ? symbol_max : max_position_.load(std::memory_order_relaxed);
+        return !emergency_stopped_.load(std::memory_order_relaxed) && std::abs(new_position) <= max_position;
+    }
+
+    // Single-writer updates
+    void setPosition(uint32_t symbol_id, double position) {
+        if (symbol_id < SymbolRegistry::MAX_SYMBOLS) {
+            symbols_[symbol_id].position.store(position, std::memory_order_relaxed);
+        }
+    }
+
+    void setSymbolMaxPosition(uint32_t symbol_id, double max_position) {
+        if (symbol_id < SymbolRegistry::MAX_SYMBOLS) {
+            symbols_[symbol_id].max_position.store(max_position, std::memory_order_relaxed);
+        }
+    }
+
+    void setLimits(double max_order_size, double max_position) {
+        max_order_size_.store(max_order_size, std::memory_order_relaxed);
+        max_position_.store(max_position, std::memory_order_relaxed);
+    }
+
+    void setEmergencyStop(bool stopped) { emergency_stopped_.store(stopped, std::memory_order_release); }
+    bool isEmergencyStopped() const { return emergency_stopped_.load(std::memory_order_acquire); }
+
+    double getPosition(uint32_t symbol_id) const {
+        return symbol_id < SymbolRegistry::MAX_SYMBOLS ?
+            symbols_[symbol_id].position.load(std::memory_order_relaxed) : 0.0;
+    }
+
+private:
+    // One cache line per symbol so checks on different symbols never false-share
+    struct alignas(64) SymbolState {
+        std::atomic<double> position;
+        std::atomic<double> max_position;   // <= 0 means use the global limit
+    };
+
+    std::array<SymbolState, SymbolRegistry::MAX_SYMBOLS> symbols_;
+    alignas(64) std::atomic<double> max_order_size_{0.0};
+    std::atomic<double> max_position_{0.0};
+    std::atomic<bool> emergency_stopped_{false};
+};
+
+} // namespace moneybot
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace moneybot {
+
+enum class QuoteModelType {
+    HEURISTIC,          // Base spread + volatility multiplier + linear inventory skew
+    AVELLANEDA_STOIKOV  // Reservation price + optimal spread from gamma, sigma and k
+};
+
+QuoteModelType parseQuoteModelType(const std::string& name);
+std::string quoteModelName(QuoteModelType type);
+
+struct QuotePrices {
+    double bid = 0.0;
+    double ask = 0.0;
+    double spread_bps = 0.0;
+    double skew_bps = 0.0;   // Shift of the quote centre away from mid
+};
+
+struct HeuristicQuoteParams {
+    double base_spread_bps = 5.0;
+    double min_spread_bps = 1.0;
+    double max_spread_bps = 50.0;
+    double volatility_multiplier = 1.5;
+    double max_position = 0.01;
+    double inventory_skew_factor = 2.0;
+};
+
+// The original MarketMakerStrategy rules, kept stateless so the backtester can
+// run them side by side with other models
+class HeuristicQuoteModel {
+public:
+    explicit HeuristicQuoteModel(const HeuristicQuoteParams& params = HeuristicQuoteParams()) : params_(params) {}
+
+    double spreadBps(double volatility, double position) const;
+    double skewBps(double position) const;
+    QuotePrices quote(double mid, double position, double volatility) const;
+
+    const HeuristicQuoteParams& params() const { return params_; }
+
+private:
+    HeuristicQuoteParams params_;
+};
+
+struct AvellanedaStoikovParams {
+    double gamma = 0.01;                  // Risk aversion (per bps)
+    double horizon_sec = 60.0;            // Rolling inventory horizon tau
+    double initial_k = 0.5;               // Order arrival decay (1/bps) until trades arrive
+    double min_trade_distance_bps = 0.1;  // Floor for trade distance from mid
+    int trade_window = 200;               // Trades in the k estimator's EWMA
+    double volatility_halflife_sec = 60.0;
+    double order_size = 0.001;            // Inventory is measured in lots of this size
+    double min_spread_bps = 1.0;
+    double max_spread_bps = 50.0;
+};
+
+// Avellaneda-Stoikov inventory-risk quoting, all terms in bps of mid:
+//   reservation = mid - q * gamma * sigma^2 * tau
+//   spread      = gamma * sigma^2 * tau + (2 / gamma) * ln(1 + gamma / k)
+// sigma^2 is an EWMA of squared mid returns per second and k = 1 / E[trade distance
+// from mid] (MLE for exponential arrival intensity A * exp(-k * delta)). Both are
+// updated per event and the derived terms cached, so quote() is a few flops.
+class AvellanedaStoikovModel {
+public:
+    explicit AvellanedaStoikovModel(const AvellanedaStoikovParams& params = AvellanedaStoikovParams());
+
+    void onMid(double mid, int64_t timestamp_ms);
+    void onTrade(double price, double mid, int64_t timestamp_ms);
+    QuotePrices quote(double mid, double position) const;
+
+    void reset();
+    void setParams(const AvellanedaStoikovParams& params);
+    const AvellanedaStoikovParams& params() const { return params_; }
+
+    double sigmaBps() const;                   // Per sqrt(second)
+    double arrivalDecay() const { return k_; } // k, 1/bps
+    double arrivalRate() const;                // A, trades per second
+
+private:
+    void refreshTerms();
+
+    AvellanedaStoikovParams params_;
+
+    double last_mid_ = 0.0;
+    int64_t last_mid_ms_ = 0;
+    double variance_rate_ = 0.0;     // bps^2 per second
+    bool variance_seeded_ = false;
+
+    double mean_distance_bps_;
+    double k_;
+    double mean_interarrival_sec_ = 0.0;
+    int64_t last_trade_ms_ = 0;
+
+    // Cached per-event terms
+    double inventory_term_bps_ = 0.0; // gamma * sigma^2 * tau
+    double spread_bps_ = 0.0;
+};
+
+} // namespace moneybot
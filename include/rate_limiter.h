@@ -0,0 +1,257 @@
+#pragma once
+
+#include "symbol_registry.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+enum class RateScope {
+    SYMBOL,   // Orders per symbol (keyed by SymbolRegistry id)
+    ACCOUNT,  // Orders per account
+    VENUE     // REST request weight per venue
+};
+
+struct RateWindowLimit {
+    int window_ms;
+    int max_count;
+};
+
+// Sliding-window rate limiter on a bucketed time ring.
+// Every key owns a ring of fixed-size buckets covering the longest window plus a
+// running sum per window. Advancing time subtracts the buckets that fall out of
+// each window, so updates and queries are O(1) amortized and never allocate after
+// configure(). One instance is shared by RiskManager (orders) and OrderManager
+// (REST requests) so both sides see the same budget.
+class RateLimiter {
+public:
+    static constexpr int MAX_WINDOWS = 4;
+    static constexpr uint32_t MAX_ACCOUNTS = 8;
+    static constexpr uint32_t MAX_VENUES = 16;
+
+    explicit RateLimiter(int bucket_ms = 100, int horizon_ms = 60000)
+        : bucket_ms_(bucket_ms), ring_size_(std::max(1, horizon_ms / bucket_ms)) {}
+
+    // Configure windows for a scope (startup only, allocates the rings)
+    void configure(RateScope scope, const std::vector<RateWindowLimit>& limits) {
+        ScopeState& state = scopes_[static_cast<int>(scope)];
+        state.window_count = 0;
+        for (const auto& limit : limits) {
+            if (state.window_count >= MAX_WINDOWS) break;
+            Window& window = state.windows[state.window_count++];
+            window.buckets = std::clamp(limit.window_ms / bucket_ms_, 1, ring_size_);
+            window.max_count.store(limit.max_count, std::memory_order_relaxed);
+        }
+        state.counters = std::vector<Counter>(scopeCapacity(scope));
+        for (auto& counter : state.counters) {
+            counter.buckets.assign(ring_size_, 0);
+        }
+    }
+
+    // Load {"symbol": [{"window_ms": 1000, "max": 10}, ...], "account": [...], "venue": [...]}
+    void configure(const nlohmann::json& j) {
+        static const std::pair<const char*, RateScope> names[] = {
+            {"symbol", RateScope::SYMBOL}, {"account", RateScope::ACCOUNT}, {"venue", RateScope::VENUE}};
+        for (const auto& [name, scope] : names) {
+            if (!j.contains(name)) continue;
+            std::vector<RateWindowLimit> limits;
+            for (const auto& w : j[name]) {
+                limits.push_back({w.value("window_ms", 60000), w.value("max", 0)});
+            }
+            configure(scope, limits);
+        }
+    }
+
+    // Change the cap of an existing window at runtime (no reallocation)
+    void setMaxCount(RateScope scope, int window_ms, int max_count) {
+        ScopeState& state = scopes_[static_cast<int>(scope)];
+        for (int w = 0; w < state.window_count; ++w) {
+            if (state.windows[w].buckets * bucket_ms_ == window_ms) {
+                state.windows[w].max_count.store(max_count, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool isConfigured(RateScope scope) const {
+        return scopes_[static_cast<int>(scope)].window_count > 0;
+    }
+
+    // Check every window of one key and record the event if all pass
+    bool tryAcquire(RateScope scope, uint32_t key, int64_t now_ms, int weight = 1) {
+        Counter* counter = lookup(scope, key);
+        if (!counter) return true; // Scope not configured
+        const ScopeState& state = scopes_[static_cast<int>(scope)];
+
+        SpinLock lock(counter->lock);
+        advance(*counter, state, now_ms / bucket_ms_);
+        if (!fits(*counter, state, weight)) return false;
+        record(*counter, state, weight);
+        return true;
+    }
+
+    // Acquire an order against the symbol and account scopes together; nothing is
+    // recorded unless both have room. VENUE (request weight) is not included: callers
+    // peek it with canAcquire and spend it when the request is sent
+    bool tryAcquireOrder(uint32_t symbol_id, uint32_t account_id, int64_t now_ms, int weight = 1) {
+        Counter* account = lookup(RateScope::ACCOUNT, account_id);
+        Counter* symbol = lookup(RateScope::SYMBOL, symbol_id);
+        const ScopeState& account_state = scopes_[static_cast<int>(RateScope::ACCOUNT)];
+        const ScopeState& symbol_state = scopes_[static_cast<int>(RateScope::SYMBOL)];
+        int64_t bucket = now_ms / bucket_ms_;
+
+        // Fixed lock order (account, symbol) keeps concurrent callers deadlock-free
+        SpinLock account_lock(account ? &account->lock : nullptr);
+        SpinLock symbol_lock(symbol ? &symbol->lock : nullptr);
+        if (account) advance(*account, account_state, bucket);
+        if (symbol) advance(*symbol, symbol_state, bucket);
+        if ((account && !fits(*account, account_state, weight)) ||
+            (symbol && !fits(*symbol, symbol_state, weight))) {
+            return false;
+        }
+        if (account) record(*account, account_state, weight);
+        if (symbol) record(*symbol, symbol_state, weight);
+        return true;
+    }
+
+    // Peek without recording
+    bool canAcquire(RateScope scope, uint32_t key, int64_t now_ms, int weight = 1) {
+        Counter* counter = lookup(scope, key);
+        if (!counter) return true;
+        const ScopeState& state = scopes_[static_cast<int>(scope)];
+        SpinLock lock(counter->lock);
+        advance(*counter, state, now_ms / bucket_ms_);
+        return fits(*counter, state, weight);
+    }
+
+    // Events counted in one window of a key
+    int getCount(RateScope scope, uint32_t key, int window_index, int64_t now_ms) {
+        Counter* counter = lookup(scope, key);
+        const ScopeState& state = scopes_[static_cast<int>(scope)];
+        if (!counter || window_index >= state.window_count) return 0;
+        SpinLock lock(counter->lock);
+        advance(*counter, state, now_ms / bucket_ms_);
+        return counter->sums[window_index];
+    }
+
+    nlohmann::json getStatus(int64_t now_ms) {
+        nlohmann::json status;
+        static const std::pair<const char*, RateScope> names[] = {
+            {"symbol", RateScope::SYMBOL}, {"account", RateScope::ACCOUNT}, {"venue", RateScope::VENUE}};
+        for (const auto& [name, scope] : names) {
+            const ScopeState& state = scopes_[static_cast<int>(scope)];
+            for (int w = 0; w < state.window_count; ++w) {
+                status[name].push_back({{"window_ms", state.windows[w].buckets * bucket_ms_},
+                                        {"max", state.windows[w].max_count.load(std::memory_order_relaxed)}});
+            }
+        }
+        status["account_used"] = getCount(RateScope::ACCOUNT, 0, 0, now_ms);
+        status["venue_used"] = getCount(RateScope::VENUE, 0, 0, now_ms);
+        return status;
+    }
+
+    static int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static constexpr int64_t NO_HEAD = std::numeric_limits<int64_t>::min();
+
+    struct Window {
+        int buckets = 0;
+        std::atomic<int> max_count{0};
+    };
+
+    struct Counter {
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        int64_t head = NO_HEAD;            // Absolute index of the newest bucket
+        std::array<int, MAX_WINDOWS> sums{};
+        std::vector<uint16_t> buckets;
+
+        Counter() = default;
+        Counter(Counter&& other) noexcept : head(other.head), sums(other.sums), buckets(std::move(other.buckets)) {}
+    };
+
+    struct ScopeState {
+        std::array<Window, MAX_WINDOWS> windows;
+        int window_count = 0;
+        std::vector<Counter> counters;
+    };
+
+    class SpinLock {
+    public:
+        explicit SpinLock(std::atomic_flag* flag) : flag_(flag) {
+            if (flag_) while (flag_->test_and_set(std::memory_order_acquire)) {}
+        }
+        explicit SpinLock(std::atomic_flag& flag) : SpinLock(&flag) {}
+        ~SpinLock() { if (flag_) flag_->clear(std::memory_order_release); }
+    private:
+        std::atomic_flag* flag_;
+    };
+
+    static uint32_t scopeCapacity(RateScope scope) {
+        switch (scope) {
+            case RateScope::SYMBOL: return SymbolRegistry::MAX_SYMBOLS;
+            case RateScope::ACCOUNT: return MAX_ACCOUNTS;
+            case RateScope::VENUE: return MAX_VENUES;
+        }
+        return 0;
+    }
+
+    Counter* lookup(RateScope scope, uint32_t key) {
+        ScopeState& state = scopes_[static_cast<int>(scope)];
+        if (state.window_count == 0 || key >= state.counters.size()) return nullptr;
+        return &state.counters[key];
+    }
+
+    // Ring position of an absolute bucket index; early or negative indexes wrap too
+    size_t slot(int64_t bucket) const {
+        int64_t index = bucket % ring_size_;
+        return static_cast<size_t>(index < 0 ? index + ring_size_ : index);
+    }
+
+    // Roll the ring forward to `bucket`, dropping buckets that leave each window
+    void advance(Counter& counter, const ScopeState& state, int64_t bucket) const {
+        if (counter.head == NO_HEAD || bucket - counter.head >= ring_size_) {
+            std::fill(counter.buckets.begin(), counter.buckets.end(), 0);
+            counter.sums.fill(0);
+            counter.head = bucket;
+            return;
+        }
+        while (counter.head < bucket) {
+            ++counter.head;
+            for (int w = 0; w < state.window_count; ++w) {
+                int64_t leaving = counter.head - state.windows[w].buckets;
+                counter.sums[w] -= counter.buckets[slot(leaving)];
+            }
+            counter.buckets[slot(counter.head)] = 0;
+        }
+    }
+
+    static bool fits(const Counter& counter, const ScopeState& state, int weight) {
+        bool ok = true;
+        for (int w = 0; w < state.window_count; ++w) {
+            ok &= counter.sums[w] + weight <= state.windows[w].max_count.load(std::memory_order_relaxed);
+        }
+        return ok;
+    }
+
+    void record(Counter& counter, const ScopeState& state, int weight) const {
+        counter.buckets[slot(counter.head)] += static_cast<uint16_t>(weight);
+        for (int w = 0; w < state.window_count; ++w) {
+            counter.sums[w] += weight;
+        }
+    }
+
+    int bucket_ms_;
+    int ring_size_;
+    std::array<ScopeState, 3> scopes_;
+};
+
+} // namespace moneybot
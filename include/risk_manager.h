@@ -2,6 +2,10 @@
 #define RISK_MANAGER_H
 
 #include "logger.h"
+#include "portfolio_risk_engine.h"
+#include "pre_trade_risk_gate.h"
+#include "rate_limiter.h"
+#include "stress_scenario_engine.h"
 #include "types.h"
 #include <memory>
 #include <string>
@@ -29,8 +33,10 @@ public:
     RiskManager(std::shared_ptr<Logger> logger, const nlohmann::json& config);
     ~RiskManager() = default;
     
-    // Risk checks
+    // Risk checks (checkOrderRate is mutex-free; so are checkOrderRisk and checkPositionRisk
+    // unless a portfolio VaR limit is configured, which both also enforce)
     bool checkOrderRisk(const Order& order);
+    bool checkOrderRisk(uint32_t symbol_id, const Order& order);
     bool checkPositionRisk(const std::string& symbol, double new_position);
     bool checkDailyLoss(double current_pnl);
     bool checkDrawdown(double current_drawdown);
@@ -38,6 +44,7 @@ public:
     
     // Position tracking
     void updatePosition(const std::string& symbol, double quantity, double price);
+    void onPrice(const std::string& symbol, double price);
     void updatePnL(const std::string& symbol, double pnl);
     
     // Limits management
@@ -49,6 +56,13 @@ public:
     void resume();
     bool isEmergencyStopped() const;
     
+    // Order/request rate budget, shared with OrderManager's REST path
+    std::shared_ptr<RateLimiter> getRateLimiter() const { return rate_limiter_; }
+    void setRateLimiter(std::shared_ptr<RateLimiter> rate_limiter) { rate_limiter_ = rate_limiter; }
+    
+    // Revalue current positions under the stress scenario library (cached for the report)
+    nlohmann::json runStressTest();
+    
     // Reporting
     nlohmann::json getRiskReport() const;
 
@@ -61,11 +75,6 @@ private:
         std::chrono::system_clock::time_point last_update;
     };
     
-    struct OrderRateInfo {
-        int order_count;
-        std::chrono::system_clock::time_point window_start;
-    };
-    
     // Risk calculations
     double calculateDrawdown() const;
     double calculateDailyPnL() const;
@@ -75,17 +84,24 @@ private:
     
     // State tracking
     std::unordered_map<std::string, PositionInfo> positions_;
-    std::unordered_map<std::string, OrderRateInfo> order_rates_;
     double total_realized_pnl_;
     double peak_equity_;
     double current_equity_;
     
-    // Emergency state
-    bool emergency_stopped_;
+    // Lock-free pre-trade state (limits, positions, emergency stop)
+    PreTradeRiskGate gate_;
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    
+    // Correlation-aware portfolio VaR/ES
+    PortfolioRiskEngine var_engine_;
+    
+    // Scenario revaluation
+    std::unique_ptr<StressScenarioEngine> stress_engine_;
+    nlohmann::json last_stress_;
+    mutable std::mutex stress_mutex_;
     
-    // Thread safety
+    // Thread safety (slow path only)
     mutable std::mutex positions_mutex_;
-    mutable std::mutex rates_mutex_;
     mutable std::mutex limits_mutex_;
     
     // Timestamps
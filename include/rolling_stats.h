@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace moneybot {
+
+// Fixed-capacity rolling window with O(1) statistics.
+// Samples live in a ring allocated once at construction. Mean/variance use Welford's
+// update with removal of the evicted sample, min/max use monotonic index queues, and
+// an EWMA runs alongside. The moments are recomputed exactly once per `capacity`
+// pushes so rounding error cannot build up (amortized O(1)).
+class RollingStats {
+public:
+    explicit RollingStats(size_t capacity = 100, double ewma_alpha = 0.0)
+        : capacity_(std::max<size_t>(capacity, 1)),
+          alpha_(ewma_alpha > 0.0 ? ewma_alpha : 2.0 / (static_cast<double>(capacity_) + 1.0)),
+          values_(capacity_), max_queue_(capacity_), min_queue_(capacity_) {}
+
+    void push(double x) {
+        if (count_ < capacity_) {
+            ++count_;
+            double delta = x - mean_;
+            mean_ += delta / static_cast<double>(count_);
+            m2_ += delta * (x - mean_);
+        } else {
+            // Replace the oldest sample in one step
+            double old = values_[head_ % capacity_];
+            double old_mean = mean_;
+            mean_ += (x - old) / static_cast<double>(count_);
+            m2_ += (x - old) * (x - mean_ + old - old_mean);
+        }
+        values_[head_ % capacity_] = x;
+
+        ewma_ = head_ == 0 ? x : alpha_ * x + (1.0 - alpha_) * ewma_;
+
+        pushMonotonic(max_queue_, max_front_, max_back_, x, [](double a, double b) { return a <= b; });
+        pushMonotonic(min_queue_, min_front_, min_back_, x, [](double a, double b) { return a >= b; });
+
+        ++head_;
+        if (head_ % capacity_ == 0 && full()) recompute();
+    }
+
+    void clear() {
+        count_ = 0;
+        head_ = 0;
+        mean_ = m2_ = ewma_ = 0.0;
+        max_front_ = max_back_ = min_front_ = min_back_ = 0;
+    }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == capacity_; }
+
+    double mean() const { return mean_; }
+    double variance() const { return count_ > 0 ? std::max(0.0, m2_ / static_cast<double>(count_)) : 0.0; }
+    double sampleVariance() const {
+        return count_ > 1 ? std::max(0.0, m2_ / static_cast<double>(count_ - 1)) : 0.0;
+    }
+    double stddev() const { return std::sqrt(variance()); }
+    double ewma() const { return ewma_; }
+    double min() const { return count_ > 0 ? values_[min_queue_[min_front_ % capacity_] % capacity_] : 0.0; }
+    double max() const { return count_ > 0 ? values_[max_queue_[max_front_ % capacity_] % capacity_] : 0.0; }
+    double last() const { return count_ > 0 ? values_[(head_ - 1) % capacity_] : 0.0; }
+
+    // i = 0 is the oldest sample in the window
+    double operator[](size_t i) const { return values_[(head_ - count_ + i) % capacity_]; }
+
+private:
+    // Queue of sample indices whose values are monotonic; the front is the extreme.
+    // Indices older than the window are dropped from the front, dominated ones from the back.
+    template <typename Dominated>
+    void pushMonotonic(std::vector<uint64_t>& queue, uint64_t& front, uint64_t& back, double x, Dominated dominated) {
+        while (back > front && dominated(values_[queue[(back - 1) % capacity_] % capacity_], x)) {
+            --back;
+        }
+        if (back > front && queue[front % capacity_] + capacity_ <= head_) {
+            ++front;
+        }
+        queue[back % capacity_] = head_;
+        ++back;
+    }
+
+    void recompute() {
+        double sum = 0.0;
+        for (double v : values_) sum += v;
+        mean_ = sum / static_cast<double>(count_);
+        double m2 = 0.0;
+        for (double v : values_) m2 += (v - mean_) * (v - mean_);
+        m2_ = m2;
+    }
+
+    size_t capacity_;
+    double alpha_;
+    std::vector<double> values_;
+    std::vector<uint64_t> max_queue_;
+    std::vector<uint64_t> min_queue_;
+    uint64_t max_front_ = 0, max_back_ = 0;
+    uint64_t min_front_ = 0, min_back_ = 0;
+
+    uint64_t head_ = 0;   // Total samples pushed
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double ewma_ = 0.0;
+};
+
+// Realized volatility over a rolling window of simple returns
+class RollingVolatility {
+public:
+    explicit RollingVolatility(size_t window = 100) : returns_(window > 1 ? window - 1 : 1) {}
+
+    void push(double price) {
+        if (last_price_ > 0.0 && price > 0.0) {
+            returns_.push((price - last_price_) / last_price_);
+        }
+        if (price > 0.0) last_price_ = price;
+    }
+
+    void clear() {
+        returns_.clear();
+        last_price_ = 0.0;
+    }
+
+    double volatility() const { return returns_.stddev(); }
+    size_t samples() const { return returns_.size(); }
+    const RollingStats& returns() const { return returns_; }
+
+private:
+    RollingStats returns_;
+    double last_price_ = 0.0;
+};
+
+} // namespace moneybot
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "consolidated_book.h"
+#include "types.h"
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+// What the router knows about one venue, indexed like the consolidated book's venues
+struct RouteVenue {
+    bool enabled = true;            // Connected and allowed to trade
+    double latency_ms = 0.0;        // Order round trip
+    // Spendable balance: quote asset for a buy, base asset for a sell
+    double available = std::numeric_limits<double>::infinity();
+};
+
+struct RouteParams {
+    // Expected adverse move per millisecond a child spends in flight; makes a slow venue
+    // take flow only when it is cheaper by more than that
+    double latency_cost_bps_per_ms = 0.05;
+    double min_child_quantity = 0.0;        // Smaller children are dropped and re-routed
+};
+
+// One venue's share of a parent order
+struct ChildRoute {
+    size_t venue = 0;
+    std::string exchange;
+    double quantity = 0.0;
+    double limit_price = 0.0;       // Deepest level planned on the venue; caps the child's sweep
+    double expected_vwap = 0.0;     // Before fees
+    double taker_fee = 0.0;
+    size_t levels = 0;
+};
+
+struct RoutePlan {
+    OrderSide side = OrderSide::BUY;
+    double requested = 0.0;
+    double routed = 0.0;            // Less than requested when depth or balances run out
+    double expected_vwap = 0.0;     // Before fees, over all children
+    double expected_fees = 0.0;     // Quote
+    double arrival_mid = 0.0;       // Consolidated book the plan was made from
+    double arrival_touch = 0.0;     // Best price on the side being taken
+    std::vector<ChildRoute> children;
+};
+
+// What a venue did with one child order
+struct ChildExecution {
+    std::string exchange;
+    std::string order_id;
+    double requested = 0.0;
+    std::vector<OrderFill> fills;
+    std::string error;              // Empty if the venue accepted the order
+    double latency_ms = 0.0;
+
+    double filledQuantity() const;
+};
+
+struct RouteReport {
+    std::string symbol;
+    RoutePlan plan;
+    std::vector<ChildExecution> children;
+    double filled_quantity = 0.0;
+    double average_price = 0.0;     // Volume-weighted over all fills, before fees
+    double commission = 0.0;        // As reported by the venues
+    // Realized slippage in bps, positive when the fills were worse than the reference
+    double slippage_bps = 0.0;      // Against the arrival mid
+    double touch_slippage_bps = 0.0;    // Against the arrival best price
+    double plan_slippage_bps = 0.0;     // Against the planned VWAP
+    double elapsed_ms = 0.0;        // Dispatch until the last child returned
+
+    nlohmann::json toJson() const;
+};
+
+// Splits `quantity` across the venues of a consolidated book. Each (level, venue) slice
+// costs its price after the venue's taker fee and latency penalty; slices are taken
+// cheapest first until the quantity, the venue's balance or the parent's limit price (if
+// > 0) runs out. Per venue the cheapest slices are also the shallowest, so that greedy
+// fill is the cost-minimizing split of the visible depth.
+RoutePlan planRoute(const ConsolidatedBook& book, OrderSide side, double quantity, double limit_price,
+                    const std::vector<RouteVenue>& venues, const RouteParams& params = {});
+
+// Plans a parent order against a consolidated book, sends the children to their venues
+// concurrently and aggregates what filled. Sending goes through a callback so the same
+// router drives live connectors or stubs.
+class SmartOrderRouter {
+public:
+    using ChildSender = std::function<ChildExecution(const std::string& exchange, const Order& child)>;
+
+    explicit SmartOrderRouter(ChildSender sender, RouteParams params = {});
+
+    RouteReport route(const Order& parent, const ConsolidatedBook& book, const std::vector<RouteVenue>& venues) const;
+    // Sends an existing plan; children are limit orders at their planned limit price
+    RouteReport execute(const Order& parent, const RoutePlan& plan) const;
+
+    const RouteParams& params() const { return params_; }
+
+private:
+    ChildSender sender_;
+    RouteParams params_;
+};
+
+} // namespace moneybot
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace moneybot {
+
+// Book/position states the strategy prepares quotes for ahead of time
+enum class SpeculativeState : uint8_t {
+    TOUCH_UP,    // Bid and ask both up one tick
+    TOUCH_DOWN,
+    BID_UP,      // One side of the touch moves
+    BID_DOWN,
+    ASK_UP,
+    ASK_DOWN,
+    BID_FILLED,  // Our bid filled in full, touch unchanged
+    ASK_FILLED,
+    COUNT
+};
+
+struct SpeculativeQuote {
+    // State key
+    double best_bid = 0.0;
+    double best_ask = 0.0;
+    double position = 0.0;
+    // Ready-to-send quote for that state
+    double mid = 0.0;
+    double bid = 0.0;
+    double ask = 0.0;
+    double bid_size = 0.0;
+    double ask_size = 0.0;
+    double spread_bps = 0.0;
+    bool valid = false;
+};
+
+// Small fixed table of quotes for the next likely states. It is refilled after every
+// event from the current touch and position; when the next event lands on one of the
+// states the reaction is a lookup instead of a full recompute. Entries are built with
+// the statistics of the previous event, so the slow path catches up right after the send.
+class SpeculativeQuoteTable {
+public:
+    static constexpr size_t STATES = static_cast<size_t>(SpeculativeState::COUNT);
+
+    explicit SpeculativeQuoteTable(double tick_size = 0.01) : tick_size_(tick_size) {}
+
+    void setTickSize(double tick_size) {
+        tick_size_ = tick_size;
+        invalidate();
+    }
+    double tickSize() const { return tick_size_; }
+
+    // build(best_bid, best_ask, position) -> SpeculativeQuote with the price/size fields set
+    template <typename Builder>
+    void precompute(double best_bid, double best_ask, double position,
+                    double bid_fill, double ask_fill, Builder&& build) {
+        const double t = tick_size_;
+        set(SpeculativeState::TOUCH_UP, best_bid + t, best_ask + t, position, build);
+        set(SpeculativeState::TOUCH_DOWN, best_bid - t, best_ask - t, position, build);
+        set(SpeculativeState::BID_UP, best_bid + t, best_ask, position, build);
+        set(SpeculativeState::BID_DOWN, best_bid - t, best_ask, position, build);
+        set(SpeculativeState::ASK_UP, best_bid, best_ask + t, position, build);
+        set(SpeculativeState::ASK_DOWN, best_bid, best_ask - t, position, build);
+        set(SpeculativeState::BID_FILLED, best_bid, best_ask, position + bid_fill, build);
+        set(SpeculativeState::ASK_FILLED, best_bid, best_ask, position - ask_fill, build);
+    }
+
+    // Prices match within half a tick; position must match exactly up to rounding
+    const SpeculativeQuote* lookup(double best_bid, double best_ask, double position) {
+        const double price_tolerance = tick_size_ * 0.5;
+        for (const auto& entry : entries_) {
+            if (entry.valid &&
+                std::abs(entry.best_bid - best_bid) < price_tolerance &&
+                std::abs(entry.best_ask - best_ask) < price_tolerance &&
+                std::abs(entry.position - position) < 1e-12) {
+                hits_++;
+                return &entry;
+            }
+        }
+        misses_++;
+        return nullptr;
+    }
+
+    void invalidate() {
+        for (auto& entry : entries_) entry.valid = false;
+    }
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    template <typename Builder>
+    void set(SpeculativeState state, double best_bid, double best_ask, double position, Builder& build) {
+        auto& entry = entries_[static_cast<size_t>(state)];
+        if (best_bid <= 0 || best_ask <= best_bid) {
+            entry.valid = false;
+            return;
+        }
+        entry = build(best_bid, best_ask, position);
+        entry.best_bid = best_bid;
+        entry.best_ask = best_ask;
+        entry.position = position;
+        entry.valid = true;
+    }
+
+    double tick_size_;
+    std::array<SpeculativeQuote, STATES> entries_{};
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace moneybot
@@ -1,12 +1,15 @@
 #pragma once
 #include "strategy.h"
 #include "multi_exchange_gateway.h"
+#include "kalman_hedge_bank.h"
+#include "pair_stats_engine.h"
+#include "rolling_stats.h"
+#include "timer_wheel.h"
 #include <deque>
 #include <memory>
 #include <vector>
 #include <unordered_map>
 #include <chrono>
-#include <mutex>
 
 namespace moneybot {
 
@@ -37,6 +40,7 @@ struct StatArbConfig {
     double exit_threshold = 0.5;       // Z-score threshold to exit
     double stop_loss_threshold = 4.0;  // Emergency exit z-score
     int lookback_periods = 200;        // Periods for cointegration
+    int sample_interval_ms = 60000;    // Length of one period (bar) for the pair statistics
     double max_position_size = 0.01;   // Max position per pair (BTC)
     int rebalance_frequency_ms = 5000; // How often to check positions
     double correlation_threshold = 0.7; // Minimum correlation to trade
@@ -44,6 +48,9 @@ struct StatArbConfig {
     double max_half_life_minutes = 1440.0; // Maximum mean reversion speed (24h)
     double transaction_cost_bps = 10.0;  // Estimated transaction costs
     bool use_kalman_filter = true;      // Use Kalman filter for hedge ratio
+    bool kalman_intercept = true;       // 2-state filter (intercept + hedge ratio)
+    double kalman_process_noise = 1e-5; // State random-walk variance per bar
+    double kalman_observation_noise = 1e-3; // Log-price measurement variance
     double volatility_threshold = 0.05; // Don't trade in high volatility
 };
 
@@ -64,6 +71,7 @@ public:
     void shutdown() override;
     std::string getName() const override { return "StatisticalArbitrage"; }
     void updateConfig(const nlohmann::json& config) override;
+    void setTimerWheel(TimerWheel* timers) override;  // Samples pair_stats_ every sample_interval_ms
 
     // Statistical analysis methods
     void updatePairStatistics();
@@ -97,14 +105,14 @@ private:
     std::shared_ptr<MultiExchangeGateway> gateway_;
     std::shared_ptr<Logger> logger_;
     
-    // Price history for statistical calculations (symbol -> price history)
-    std::unordered_map<std::string, std::deque<double>> price_history_;
-    std::unordered_map<std::string, std::deque<double>> return_history_;
-    std::unordered_map<std::string, std::deque<std::chrono::steady_clock::time_point>> time_history_;
-    
-    // Spread history for each pair
-    std::unordered_map<std::string, std::deque<double>> spread_history_; // pair_id -> spread history
+    // Rolling correlation, hedge ratio, z-score and half-life for every pair, O(1) per
+    // pair per bar. Prices feed onPrice(); a timer closes each bar with sample().
+    PairStatsEngine pair_stats_;
+    std::unordered_map<std::string, size_t> pair_stats_index_;       // pair_id -> pair_stats_ pair
+    std::unordered_map<std::string, RollingStats> return_stats_;     // symbol -> rolling return stats
     std::unordered_map<std::string, std::deque<double>> zscore_history_; // pair_id -> z-score history
+    TimerWheel* timers_ = nullptr;
+    TimerWheel::TimerId sample_timer_ = TimerWheel::INVALID_TIMER;
     
     // Active positions
     std::vector<CryptoPair> active_pairs_;
@@ -135,12 +143,11 @@ private:
     double peak_pnl_ = 0.0;
     std::deque<double> daily_returns_;
     
-    // Threading
-    mutable std::mutex strategy_mutex_;
+    // No internal locking: run under a StrategyActor, which delivers events on one thread
     
     // Helper methods
-    void updatePriceHistory(const std::string& symbol, double price);
-    void updateSpreadHistory(const std::string& pair_id, double spread);
+    void samplePairStatistics();  // Closes a bar and copies the stats into active_pairs_
+    const PairStats* getPairStats(const CryptoPair& pair) const;
     double getLatestPrice(const std::string& symbol) const;
     double calculateSpread(const CryptoPair& pair) const;
     std::string getPairId(const CryptoPair& pair) const;
@@ -152,20 +159,11 @@ private:
     void onOrderCompleted(const std::string& order_id, bool success);
     void cleanupStaleOrders();
     
-    // Statistical calculations
-    double calculateMean(const std::deque<double>& data) const;
-    double calculateStdDev(const std::deque<double>& data) const;
-    double calculateCorrelation(const std::deque<double>& x, const std::deque<double>& y) const;
-    
-    // Kalman filter for dynamic hedge ratio estimation
-    struct KalmanState {
-        double x = 1.0;     // hedge ratio estimate
-        double P = 1.0;     // error covariance
-        double Q = 0.01;    // process noise
-        double R = 0.1;     // measurement noise
-    };
-    std::unordered_map<std::string, KalmanState> kalman_states_;
-    double updateKalmanFilter(const std::string& pair_id, double observed_ratio);
+    // Kalman hedge ratio (and intercept) on log prices for every pair, stored
+    // structure-of-arrays and stepped for all pairs in one batched pass per bar
+    KalmanHedgeBank kalman_;
+    std::unordered_map<std::string, size_t> kalman_index_;  // pair_id -> kalman_ filter
+    void updateKalmanFilters();  // Observes every pair's latest log prices, then steps kalman_
     
     // Logging helpers
     void logInfo(const std::string& message) const;
@@ -8,6 +8,8 @@
 
 namespace moneybot {
 
+class TimerWheel;
+
 class Strategy {
 public:
     virtual ~Strategy() = default;
@@ -26,6 +28,13 @@ public:
     // Configuration
     virtual std::string getName() const = 0;
     virtual void updateConfig(const nlohmann::json& config) = 0;
+    
+    // State for readers on other threads (GUI/CLI); must be safe to call concurrently
+    virtual nlohmann::json getSnapshot() const { return nlohmann::json::object(); }
+    
+    // Timers on the thread that delivers this strategy's events (set by StrategyActor).
+    // Strategies without one fall back to checking on market data.
+    virtual void setTimerWheel(TimerWheel* timers) { (void)timers; }
 };
 
 } // namespace moneybot
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "logger.h"
+#include "order_book.h"
+#include "order_manager.h"
+#include "strategy.h"
+#include "symbol_registry.h"
+#include "timer_wheel.h"
+#include "types.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+// Runs a set of strategies as a single-threaded actor. Producers on any thread post
+// events to the inbox; the actor thread delivers them in order, so strategy code
+// owns its state outright and needs no locks. Each hosted strategy gets its own
+// OrderBook, fed from raw stream payloads on the actor thread, and shares the actor's
+// TimerWheel, which the loop drives between batches. State for readers on other
+// threads goes out through the strategies' published snapshots.
+class StrategyActor : public Strategy {
+public:
+    using Task = std::function<void()>;
+
+    explicit StrategyActor(std::shared_ptr<Logger> logger, size_t index = 0);
+    ~StrategyActor();
+
+    StrategyActor(const StrategyActor&) = delete;
+    StrategyActor& operator=(const StrategyActor&) = delete;
+
+    // Setup, before initialize()
+    void addStrategy(uint32_t symbol_id, const std::string& symbol, std::shared_ptr<Strategy> strategy);
+    // Execution reports are applied to this order manager before the strategy sees them
+    void setOrderManager(std::shared_ptr<OrderManager> order_manager) { order_manager_ = order_manager; }
+    void setCore(int core) { core_ = core; }
+
+    // Producers (any thread). Ids outside the registry (INVALID_ID) are dropped.
+    void postMarketData(uint32_t symbol_id, bool is_trade, const nlohmann::json& data);
+    void postExecution(uint32_t symbol_id, const nlohmann::json& data);
+    void post(Task task);
+
+    // Strategy interface: everything is queued to the actor thread. Book updates carry
+    // no symbol and are not routable; ack/reject/fill go to every hosted strategy.
+    void onOrderBookUpdate(const OrderBook& order_book) override;
+    void onTrade(const Trade& trade) override;
+    void onOrderAck(const OrderAck& ack) override;
+    void onOrderReject(const OrderReject& reject) override;
+    void onOrderFill(const OrderFill& fill) override;
+
+    void initialize() override;  // Starts the thread
+    void shutdown() override;    // Drains the inbox and joins
+
+    std::string getName() const override;
+    void updateConfig(const nlohmann::json& config) override;
+    nlohmann::json getSnapshot() const override;
+
+    size_t index() const { return index_; }
+    std::vector<std::string> getSymbols() const;
+    nlohmann::json getStatus() const;
+
+    // Combined stream helpers ("btcusdt@depth10@100ms", "btcusdt@trade")
+    static std::vector<std::string> streamNames(const std::vector<std::string>& symbols);
+    static std::string streamEndpoint(const std::vector<std::string>& symbols);
+    static std::string streamSymbol(const std::string& stream, const nlohmann::json& data);
+    static bool isTradeStream(const std::string& stream);
+
+private:
+    struct Slot {
+        uint32_t symbol_id;
+        std::string symbol;
+        std::unique_ptr<OrderBook> book;
+        std::shared_ptr<Strategy> strategy;
+    };
+
+    struct MarketDataEvent {
+        uint32_t symbol_id;
+        bool is_trade;
+        nlohmann::json data;
+    };
+    struct ExecutionEvent {
+        uint32_t symbol_id;
+        nlohmann::json data;
+    };
+    using Event = std::variant<MarketDataEvent, ExecutionEvent, Trade, OrderAck, OrderReject, OrderFill, Task>;
+
+    void enqueue(Event event);
+    void run();
+    void process(Event& event);
+    void processMarketData(Slot& slot, const MarketDataEvent& event);
+    void processExecution(Slot& slot, const nlohmann::json& data);
+    Slot* findSlot(uint32_t symbol_id);
+    void pinThread();
+
+    std::shared_ptr<Logger> logger_;
+    size_t index_;
+    int core_ = -1;
+    std::shared_ptr<OrderManager> order_manager_;
+
+    // Owned by the actor thread once started
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<int> slot_index_;                // symbol id -> slots_ index
+    std::vector<uint32_t> latest_book_event_;    // Scratch for conflating book snapshots
+    TimerWheel timers_;
+
+    std::thread thread_;
+    mutable std::mutex inbox_mutex_;
+    std::condition_variable inbox_cv_;
+    std::vector<Event> inbox_;
+    bool stopping_ = false;
+    bool running_ = false;
+
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> busy_ns_{0};
+    std::atomic<uint64_t> max_batch_{0};
+    std::atomic<uint64_t> timers_fired_{0};
+};
+
+} // namespace moneybot
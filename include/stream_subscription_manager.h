@@ -0,0 +1,149 @@
+#pragma once
+
+#include "feed_arbiter.h"
+#include "io_runtime.h"
+#include "logger.h"
+#include "network.h"
+#include <atomic>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+struct StreamShardParams {
+    size_t max_connections = 5;
+    size_t max_streams_per_connection = 200;    // Venue cap (Binance: 1024)
+    double connection_target_rate = 400.0;      // Messages/s a shared connection should carry
+    double hot_stream_rate = 100.0;             // At or above: a connection of its own
+    double imbalance = 0.25;                    // Busiest shared connection this far over the mean: rebalance
+    size_t max_moves = 8;                       // Balancing moves per pass; forced moves don't count
+};
+
+// One stream as the planner sees it
+struct StreamLoad {
+    static constexpr size_t NO_CONNECTION = static_cast<size_t>(-1);
+
+    double rate = 0.0;                          // Messages/s
+    size_t connection = NO_CONNECTION;          // Where it is now
+};
+
+// Target connection for each stream (same order), given `open` connections today.
+// Hot streams get dedicated connections while the connection budget lasts; the rest are
+// packed into as few shared connections as their count and total rate need. Streams stay
+// where they are unless a cap forces a move, then the busiest shared connection sheds
+// streams to the lightest until within `imbalance` of the mean (at most max_moves).
+// Indexes >= `open` are new connections.
+std::vector<size_t> planStreamShards(const std::vector<StreamLoad>& streams, size_t open,
+                                     const StreamShardParams& params);
+
+// Spreads market data streams over a pool of combined-stream WebSocket connections and
+// keeps them spread as message rates change. Rates are measured per stream; every
+// rebalance pass re-plans the shards and moves streams make-before-break: the new
+// connection subscribes, takes over delivery with its first message, and only then is
+// the stream unsubscribed on the old one, so delivery has no gap; updates seen on both are
+// applied once, in id order. A connection that drops reconnects (Network's backoff) and resubscribes
+// to its current streams.
+//
+// With more than one feed configured every shard is carried by one connection per feed
+// (A/B, possibly to different endpoints) and a FeedArbiter applies the first copy of each
+// update, so a slow or dropped feed costs nothing while another is up.
+//
+// Config:
+//   "stream_sharding": {"max_connections": 5, "max_streams_per_connection": 200,
+//                       "connection_target_rate": 400, "hot_stream_rate": 100,
+//                       "imbalance": 0.25, "max_moves": 8, "rebalance_ms": 10000,
+//                       "rate_halflife_sec": 30,
+//                       "feeds": [{"host": "stream.binance.us", "port": "9443"}, ...]}
+// Feeds default to exchange.websocket_host / websocket_port; all use the "/stream" endpoint.
+class StreamSubscriptionManager {
+public:
+    StreamSubscriptionManager(std::shared_ptr<Logger> logger, std::shared_ptr<IoRuntime> io_runtime,
+                              const nlohmann::json& config, Network::StreamHandler handler);
+    ~StreamSubscriptionManager();
+
+    StreamSubscriptionManager(const StreamSubscriptionManager&) = delete;
+    StreamSubscriptionManager& operator=(const StreamSubscriptionManager&) = delete;
+
+    void addStreams(const std::vector<std::string>& streams);
+    void removeStreams(const std::vector<std::string>& streams);
+
+    // The I/O runtime must be running; stop before stopping it
+    void start();
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    // Measures rates and moves streams; runs every rebalance_ms once started
+    void rebalance();
+
+    nlohmann::json getStatus() const;
+
+private:
+    struct Stream {
+        std::string name;
+        std::atomic<size_t> owner{StreamLoad::NO_CONNECTION};     // Connection delivering it
+        std::atomic<size_t> pending{StreamLoad::NO_CONNECTION};   // Connection taking it over
+        std::atomic<uint64_t> messages{0};     // Delivered since the last pass
+        double rate = 0.0;                     // Smoothed messages/s
+        FeedSequence sequence;                 // Last update applied, across feeds
+    };
+    struct Feed {
+        std::shared_ptr<Network> network;      // Fresh per open; atomic_load/atomic_store
+        std::atomic<uint64_t> generation{0};   // Bumped per open and close; stale disconnects are ignored
+        uint64_t drops = 0;
+    };
+    struct FeedEndpoint {
+        std::string host;
+        std::string port;
+    };
+    struct Connection {
+        size_t index = 0;
+        std::atomic<bool> open{false};
+        std::vector<std::unique_ptr<Feed>> feeds;   // One per feed endpoint, same streams
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Stream*> streams;   // Subscribed here: owned or pending
+    };
+
+    void onMessage(Connection& connection, size_t feed, const std::string& stream, const nlohmann::json& data);
+    void completeHandover(Stream& stream, size_t to);
+    bool isSubscribed(const Connection& connection) const;     // Some feed is up with its streams
+    void openConnection(Connection& connection);
+    void closeConnection(Connection& connection);
+    void openFeed(Connection& connection, size_t index);
+    void closeFeed(Feed& feed);
+    void changeSubscription(Connection& connection, const std::vector<std::string>& streams, bool subscribe);
+    void onDisconnect(Connection& connection, size_t feed, const std::string& reason);
+    void scheduleRebalance();
+    std::vector<std::string> subscribedOn(const Connection& connection) const;
+
+    std::shared_ptr<Logger> logger_;
+    std::shared_ptr<IoRuntime> io_runtime_;
+    const nlohmann::json& config_;
+    Network::StreamHandler handler_;
+    StreamShardParams params_;
+    std::chrono::milliseconds rebalance_interval_;
+    double rate_halflife_sec_;
+    std::vector<FeedEndpoint> feed_endpoints_;
+    std::unique_ptr<FeedArbiter> arbiter_;     // Only with more than one feed
+
+    // Fixed at construction: message handlers index it without locking
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    mutable std::mutex state_mutex_;       // Streams, planning, opening and closing
+    std::unordered_map<std::string, std::unique_ptr<Stream>> streams_;
+    std::vector<std::unique_ptr<Stream>> retired_;     // Removed; handlers may still hold them
+    std::chrono::steady_clock::time_point last_pass_;
+    uint64_t moves_ = 0;
+
+    IoRuntime::Lease lease_;               // Rebalancing and disconnect bookkeeping run here
+    std::unique_ptr<boost::asio::steady_timer> rebalance_timer_;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace moneybot
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace moneybot {
+
+// One shock inside a scenario. `match` is "*" (any symbol) or a symbol prefix
+// ("BTC" matches BTCUSDT); the first matching shock in a scenario wins.
+struct StressShock {
+    std::string match = "*";
+    double price_change = 0.0;    // Relative move, -0.15 = down 15%
+    double vol_multiplier = 1.0;  // Scales liquidation cost
+};
+
+struct StressScenario {
+    std::string name;
+    std::vector<StressShock> shocks;
+};
+
+struct StressPosition {
+    std::string symbol;
+    double quantity = 0.0;
+    double price = 0.0;           // Mark price
+};
+
+struct StressResult {
+    std::string name;
+    double pnl = 0.0;             // Mark-to-market change
+    double liquidation_cost = 0.0;
+    double total = 0.0;           // pnl - liquidation_cost
+};
+
+struct StressReport {
+    std::vector<StressResult> worst;  // Sorted, worst first
+    double worst_loss = 0.0;
+    double mean_total = 0.0;
+    size_t scenarios = 0;
+    int64_t elapsed_us = 0;
+};
+
+// Revalues a position set under a library of price/volatility shocks. Scenarios are
+// split into chunks and evaluated on a fixed pool of worker threads; every scenario
+// writes only its own result slot, so the hot loop shares nothing.
+class StressScenarioEngine {
+public:
+    explicit StressScenarioEngine(size_t threads = 0, double liquidation_bps = 5.0);
+    ~StressScenarioEngine();
+
+    StressScenarioEngine(const StressScenarioEngine&) = delete;
+    StressScenarioEngine& operator=(const StressScenarioEngine&) = delete;
+
+    // Library management
+    // {"liquidation_bps": 5, "scenarios": [{"name": ..., "shocks": [{"match": "BTC", "price": -0.15, "vol": 2}]}],
+    //  "grid": {"leader": "BTC", "leader_moves": [...], "follower_moves": [...], "vol_multipliers": [...]}}
+    void loadScenarios(const nlohmann::json& j);
+    void addScenario(const StressScenario& scenario);
+    // Cross product of leader moves x follower moves x vol multipliers
+    void addGrid(const std::string& leader, const std::vector<double>& leader_moves,
+                 const std::vector<double>& follower_moves, const std::vector<double>& vol_multipliers);
+    size_t scenarioCount() const;
+
+    StressReport run(const std::vector<StressPosition>& positions, size_t worst_n = 5);
+
+    static nlohmann::json toJson(const StressReport& report);
+
+private:
+    struct CompiledShock {
+        uint32_t pattern;
+        double price_multiplier;
+        double vol_multiplier;
+    };
+
+    uint32_t internPattern(const std::string& match);
+    void workerLoop();
+    void runParallel(size_t chunks, const std::function<void(size_t)>& task);
+
+    // Library (compiled to pattern ids so matching is a table lookup)
+    std::vector<std::string> names_;
+    std::vector<std::vector<CompiledShock>> shocks_;
+    std::vector<std::string> patterns_;
+    double liquidation_bps_;
+    mutable std::mutex library_mutex_;
+
+    // Worker pool
+    std::vector<std::thread> workers_;
+    std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+    std::condition_variable done_cv_;
+    std::function<void(size_t)> task_;
+    size_t task_chunks_ = 0;
+    std::atomic<size_t> next_chunk_{0};
+    size_t workers_done_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+    std::mutex run_mutex_;  // One run at a time
+};
+
+} // namespace moneybot
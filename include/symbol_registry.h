@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace moneybot {
+
+// Maps symbol names to dense integer ids so hot paths can index flat arrays.
+// Lookups are lock-free; registration takes a mutex and is expected at startup
+// or when a new symbol first appears.
+class SymbolRegistry {
+public:
+    static constexpr uint32_t MAX_SYMBOLS = 1024;
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    static SymbolRegistry& getInstance() {
+        static SymbolRegistry instance;
+        return instance;
+    }
+
+    // Returns the id for symbol, registering it if needed (INVALID_ID when full)
+    uint32_t getOrRegister(const std::string& symbol) {
+        uint32_t id = find(symbol);
+        if (id != INVALID_ID) return id;
+
+        std::lock_guard<std::mutex> lock(register_mutex_);
+        id = find(symbol);
+        if (id != INVALID_ID) return id;
+
+        uint32_t next = count_.load(std::memory_order_relaxed);
+        if (next >= MAX_SYMBOLS) return INVALID_ID;
+
+        names_[next] = symbol;
+        size_t slot = hash(symbol);
+        while (slots_[slot].load(std::memory_order_relaxed) != EMPTY) {
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        // Publish the name before the id becomes visible
+        slots_[slot].store(next, std::memory_order_release);
+        count_.store(next + 1, std::memory_order_release);
+        return next;
+    }
+
+    // Lock-free lookup, INVALID_ID if unknown
+    uint32_t find(const std::string& symbol) const {
+        size_t slot = hash(symbol);
+        for (;;) {
+            uint32_t id = slots_[slot].load(std::memory_order_acquire);
+            if (id == EMPTY) return INVALID_ID;
+            if (names_[id] == symbol) return id;
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+    }
+
+    const std::string& name(uint32_t id) const { return names_[id]; }
+    uint32_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr uint32_t TABLE_SIZE = MAX_SYMBOLS * 2; // power of two, load factor <= 0.5
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    SymbolRegistry() {
+        for (auto& slot : slots_) slot.store(EMPTY, std::memory_order_relaxed);
+    }
+
+    static size_t hash(const std::string& symbol) {
+        return std::hash<std::string>{}(symbol) & (TABLE_SIZE - 1);
+    }
+
+    std::array<std::atomic<uint32_t>, TABLE_SIZE> slots_;
+    std::array<std::string, MAX_SYMBOLS> names_;
+    std::atomic<uint32_t> count_{0};
+    std::mutex register_mutex_;
+};
+
+} // namespace moneybot
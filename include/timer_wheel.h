@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace moneybot {
+
+// Hierarchical timing wheel with millisecond ticks. Four levels of 256 slots cover
+// 2^32 ms (~49 days); timers sit in intrusive per-slot lists, so schedule and cancel
+// are O(1) and an idle wheel costs nothing. Timers on the outer levels are cascaded
+// inward as their slot comes up.
+//
+// Not thread-safe: one thread owns the wheel, drives it with advance() and runs the
+// callbacks. Callbacks may schedule and cancel timers, including their own. One that
+// throws is still re-armed or freed, the rest of its tick runs, and advance() then
+// rethrows the first exception.
+class TimerWheel {
+public:
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId INVALID_TIMER = 0;
+    static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+    // Milliseconds on the steady clock; the wheel's time base
+    static uint64_t nowMs();
+    static std::chrono::steady_clock::time_point toTimePoint(uint64_t ms);
+
+    explicit TimerWheel(uint64_t now_ms = nowMs());
+
+    // Delays are in ticks from now(), clamped to [1, 2^32), so when driven from nowMs() a
+    // timer may fire up to a tick early. Periodic timers re-arm from their deadline, not
+    // from when they ran, so they don't drift.
+    TimerId schedule(uint64_t delay_ms, Callback callback);
+    TimerId scheduleEvery(uint64_t interval_ms, Callback callback);
+    TimerId scheduleAt(uint64_t expiry_ms, Callback callback, uint64_t interval_ms = 0);
+
+    // Returns false if the timer already fired (one-shot), was cancelled or is unknown
+    bool cancel(TimerId id);
+
+    // Runs every timer due at or before now_ms; returns how many fired
+    size_t advance(uint64_t now_ms);
+
+    // Earliest tick that may have work (a due timer or an outer-level cascade); NEVER if empty
+    uint64_t nextExpiry() const;
+
+    uint64_t now() const { return current_; }
+    size_t size() const { return active_; }
+    bool empty() const { return active_ == 0; }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr int32_t NIL = -1;
+
+    enum class NodeState : uint8_t { FREE, PENDING, FIRING, CANCELLED };
+
+    struct Node {
+        uint64_t expiry = 0;
+        uint64_t interval = 0;
+        Callback callback;
+        int32_t prev = NIL;
+        int32_t next = NIL;
+        uint32_t generation = 1;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        NodeState state = NodeState::FREE;
+    };
+
+    int32_t allocate();
+    void release(int32_t index);
+    void place(int32_t index);
+    void unlink(int32_t index);
+    void cascade(int level);
+    size_t fireSlot(uint32_t slot);
+    static TimerId makeId(int32_t index, uint32_t generation);
+
+    uint64_t current_;
+    size_t active_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<int32_t> free_;
+    std::array<std::array<int32_t, SLOTS>, LEVELS> heads_;
+    std::array<uint32_t, LEVELS> level_counts_{};
+};
+
+// A TimerWheel on its own thread, for components without an event loop of their own.
+// schedule/cancel may be called from any thread; callbacks run on the service thread,
+// outside its lock, and should stay short, since they delay every timer behind them.
+// They must not throw.
+class TimerService {
+public:
+    TimerService() = default;
+    ~TimerService();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    void start();
+    void stop();  // Joins; pending timers are dropped
+
+    TimerWheel::TimerId schedule(uint64_t delay_ms, TimerWheel::Callback callback);
+    TimerWheel::TimerId scheduleEvery(uint64_t interval_ms, TimerWheel::Callback callback);
+    bool cancel(TimerWheel::TimerId id);
+
+    size_t size() const;
+    bool isRunning() const { return running_; }
+
+private:
+    struct Due {
+        TimerWheel::TimerId id = TimerWheel::INVALID_TIMER;
+        TimerWheel::Callback callback;
+        bool cancelled = false;     // Cancelled after it came due
+    };
+
+    TimerWheel::TimerId add(uint64_t expiry_ms, TimerWheel::Callback callback, uint64_t interval_ms);
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    TimerWheel wheel_;
+    std::deque<std::shared_ptr<Due>> due_;     // Fired by the wheel, waiting to run unlocked
+    std::thread thread_;
+    bool running_ = false;
+    bool stopping_ = false;
+};
+
+} // namespace moneybot
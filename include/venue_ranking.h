@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace moneybot {
+
+// Top of book for one symbol on one exchange
+struct VenueQuote {
+    std::string exchange;
+    double bid_price = 0.0;
+    double bid_size = 0.0;
+    double ask_price = 0.0;
+    double ask_size = 0.0;
+    std::chrono::steady_clock::time_point updated;
+};
+
+// Best cross between two venues: buy at one venue's ask, sell at another's bid
+struct VenueCross {
+    bool crossed = false;
+    uint32_t buy_venue = 0;     // Index of the venue whose ask we lift
+    uint32_t sell_venue = 0;    // Index of the venue whose bid we hit
+    double buy_price = 0.0;
+    double sell_price = 0.0;
+    double profit_bps = 0.0;
+
+    bool sameAs(const VenueCross& other) const {
+        return crossed == other.crossed && buy_venue == other.buy_venue && sell_venue == other.sell_venue &&
+               buy_price == other.buy_price && sell_price == other.sell_price;
+    }
+};
+
+// Venues for one symbol ranked by bid (highest first) and by ask (lowest first).
+// A handful of venues per symbol, so the rankings are small index arrays: an update
+// moves its venue to its new place in each (O(venues), usually a step or two) and the
+// best cross is read off the front.
+class VenueRanking {
+public:
+    // Returns the venue index (stable for the life of the ranking)
+    uint32_t update(const std::string& exchange, double bid_price, double bid_size,
+                    double ask_price, double ask_size,
+                    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    // Best cross over venues passing `usable` (e.g. connected); both sides must be
+    // different venues. crossed is false when the best bid doesn't exceed the best ask.
+    template <typename Usable>
+    VenueCross bestCross(Usable usable) const;
+    VenueCross bestCross() const { return bestCross([](const VenueQuote&) { return true; }); }
+
+    const VenueQuote* bestBid() const;
+    const VenueQuote* bestAsk() const;
+    const VenueQuote& venue(uint32_t index) const { return venues_[index]; }
+    const std::vector<uint32_t>& bidOrder() const { return bid_order_; }
+    const std::vector<uint32_t>& askOrder() const { return ask_order_; }
+    size_t size() const { return venues_.size(); }
+
+    // Last cross reported for this symbol, so an unchanged cross isn't signalled twice
+    VenueCross last_signal;
+
+private:
+    bool bidBetter(uint32_t a, uint32_t b) const;
+    bool askBetter(uint32_t a, uint32_t b) const;
+    template <typename Better>
+    static void reposition(std::vector<uint32_t>& order, uint32_t venue, Better better);
+
+    std::vector<VenueQuote> venues_;
+    std::vector<uint32_t> bid_order_;
+    std::vector<uint32_t> ask_order_;
+};
+
+template <typename Usable>
+VenueCross VenueRanking::bestCross(Usable usable) const {
+    VenueCross best;
+    // The best usable bid pairs with the best usable ask on another venue. When both
+    // bests sit on the same venue, the runner-up bid paired with the best ask may do
+    // better, so at most two bids are tried.
+    int bids_tried = 0;
+    for (uint32_t bid_venue : bid_order_) {
+        const VenueQuote& seller = venues_[bid_venue];
+        if (seller.bid_price <= 0.0) break;
+        if (!usable(seller)) continue;
+        for (uint32_t ask_venue : ask_order_) {
+            const VenueQuote& buyer = venues_[ask_venue];
+            if (buyer.ask_price <= 0.0 || buyer.ask_price >= seller.bid_price) break;
+            if (ask_venue == bid_venue || !usable(buyer)) continue;
+            double profit_bps = (seller.bid_price - buyer.ask_price) / buyer.ask_price * 10000.0;
+            if (!best.crossed || profit_bps > best.profit_bps) {
+                best.crossed = true;
+                best.buy_venue = ask_venue;
+                best.sell_venue = bid_venue;
+                best.buy_price = buyer.ask_price;
+                best.sell_price = seller.bid_price;
+                best.profit_bps = profit_bps;
+            }
+            break;   // Later asks are worse for this bid
+        }
+        if (++bids_tried == 2) break;
+    }
+    return best;
+}
+
+} // namespace moneybot
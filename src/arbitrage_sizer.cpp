@@ -0,0 +1,47 @@
+#include "arbitrage_sizer.h"
+#include <algorithm>
+
+namespace moneybot {
+
+ArbitrageSize sizeArbitrage(const BookLadder& asks, double buy_fee,
+                            const BookLadder& bids, double sell_fee, double max_size) {
+    ArbitrageSize result;
+    const double buy_cost_factor = 1.0 + buy_fee;
+    const double sell_net_factor = 1.0 - sell_fee;
+    double buy_notional = 0.0;
+    double sell_notional = 0.0;
+
+    size_t ask = 0, bid = 0;
+    double ask_left = asks.depth > 0 ? asks.size[0] : 0.0;
+    double bid_left = bids.depth > 0 ? bids.size[0] : 0.0;
+    while (ask < asks.depth && bid < bids.depth && result.size < max_size) {
+        const double ask_price = asks.price[ask];
+        const double bid_price = bids.price[bid];
+        // Edge only shrinks from here on
+        if (bid_price * sell_net_factor <= ask_price * buy_cost_factor) break;
+
+        double qty = std::min({ask_left, bid_left, max_size - result.size});
+        if (qty > 0.0) {
+            result.size += qty;
+            buy_notional += qty * ask_price;
+            sell_notional += qty * bid_price;
+            result.buy_levels = ask + 1;
+            result.sell_levels = bid + 1;
+            ask_left -= qty;
+            bid_left -= qty;
+        }
+        if (ask_left <= 0.0 && ++ask < asks.depth) ask_left = asks.size[ask];
+        if (bid_left <= 0.0 && ++bid < bids.depth) bid_left = bids.size[bid];
+    }
+
+    if (result.size > 0.0) {
+        result.buy_vwap = buy_notional / result.size;
+        result.sell_vwap = sell_notional / result.size;
+        result.buy_cost = buy_notional * buy_cost_factor;
+        result.sell_proceeds = sell_notional * sell_net_factor;
+        result.profit = result.sell_proceeds - result.buy_cost;
+    }
+    return result;
+}
+
+} // namespace moneybot
@@ -1,7 +1,10 @@
 #include "backtest_engine.h"
 #include "logger.h"
+#include "market_maker_strategy.h"
+#include "rolling_stats.h"
 #include <fstream>
 #include <iostream>
+#include <chrono>
 #include <cmath>
 
 namespace moneybot {
@@ -67,4 +70,142 @@ BacktestResult BacktestEngine::run(const std::string& symbol, const std::string&
     return result;
 }
 
+namespace {
+
+struct SimulatedQuoter {
+    QuoteModelType type;
+    QuotePrices quote;
+    double inventory = 0.0;
+    double cash = 0.0;
+    QuoteModelStats stats;
+    double spread_sum = 0.0;
+    int quotes = 0;
+    double quote_ns = 0.0;
+};
+
+// Depth line {"s","E","bids","asks"} or trade line ({"price","quantity","side","timestamp"}
+// or Binance {"e":"trade","p","q","m","T"})
+struct ReplayEvent {
+    bool is_trade = false;
+    int64_t timestamp_ms = 0;
+    double best_bid = 0.0;
+    double best_ask = 0.0;
+    double price = 0.0;
+    bool buyer_aggressor = false;
+};
+
+bool parseReplayEvent(const nlohmann::json& j, ReplayEvent& event) {
+    auto number = [](const nlohmann::json& v) {
+        return v.is_string() ? std::stod(v.get<std::string>()) : v.get<double>();
+    };
+    if (j.contains("bids") && j.contains("asks")) {
+        if (j["bids"].empty() || j["asks"].empty()) return false;
+        event.is_trade = false;
+        event.timestamp_ms = j.value("E", static_cast<int64_t>(0));
+        event.best_bid = number(j["bids"][0][0]);
+        event.best_ask = number(j["asks"][0][0]);
+        return event.best_bid > 0 && event.best_ask > 0;
+    }
+    if (j.contains("price") || j.contains("p")) {
+        event.is_trade = true;
+        event.price = number(j.contains("price") ? j["price"] : j["p"]);
+        event.timestamp_ms = j.contains("timestamp") ? j["timestamp"].get<int64_t>() : j.value("T", static_cast<int64_t>(0));
+        event.buyer_aggressor = j.contains("side") ? j["side"].get<std::string>() == "buy" : !j.value("m", false);
+        return event.price > 0;
+    }
+    return false;
+}
+
+} // namespace
+
+std::vector<QuoteModelStats> BacktestEngine::compareQuoteModels(const std::string& data_path) {
+    std::vector<QuoteModelStats> results;
+    std::ifstream file(data_path);
+    if (!file.is_open()) {
+        if (logger_) logger_->getLogger()->error("Failed to open backtest data: {}", data_path);
+        return results;
+    }
+    
+    MarketMakerConfig mm_config(config_["strategy"].value("config", nlohmann::json::object()));
+    HeuristicQuoteModel heuristic(mm_config.heuristicParams());
+    AvellanedaStoikovModel avellaneda_stoikov(mm_config.avellanedaStoikovParams());
+    RollingVolatility volatility(static_cast<size_t>(std::max(mm_config.volatility_window, 2)));
+    
+    std::vector<SimulatedQuoter> quoters = {{QuoteModelType::HEURISTIC, {}}, {QuoteModelType::AVELLANEDA_STOIKOV, {}}};
+    const double lot = mm_config.order_size;
+    double mid = 0.0;
+    
+    auto fill = [&](SimulatedQuoter& q, bool buy, double price) {
+        if (buy && q.inventory + lot > mm_config.max_position + 1e-12) return;
+        if (!buy && q.inventory - lot < -mm_config.max_position - 1e-12) return;
+        q.inventory += buy ? lot : -lot;
+        q.cash += buy ? -price * lot : price * lot;
+        q.stats.fills++;
+        q.stats.max_abs_inventory = std::max(q.stats.max_abs_inventory, std::abs(q.inventory));
+    };
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        
+        ReplayEvent event;
+        try {
+            if (!parseReplayEvent(nlohmann::json::parse(line), event)) continue;
+        } catch (const std::exception& e) {
+            if (logger_) logger_->getLogger()->warn("Failed to parse line: {}", line);
+            continue;
+        }
+        
+        // Resting quotes fill against the new event before anyone requotes
+        for (auto& q : quoters) {
+            if (q.quote.bid <= 0) continue;
+            if (event.is_trade) {
+                if (!event.buyer_aggressor && event.price <= q.quote.bid) fill(q, true, q.quote.bid);
+                if (event.buyer_aggressor && event.price >= q.quote.ask) fill(q, false, q.quote.ask);
+            } else {
+                if (event.best_ask <= q.quote.bid) fill(q, true, q.quote.bid);
+                if (event.best_bid >= q.quote.ask) fill(q, false, q.quote.ask);
+            }
+        }
+        
+        if (event.is_trade) {
+            if (mid > 0) {
+                auto start = std::chrono::steady_clock::now();
+                avellaneda_stoikov.onTrade(event.price, mid, event.timestamp_ms);
+                quoters[1].quote_ns += std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start).count();
+            }
+            // Trade-only data has no book; the last print stands in for mid
+            mid = event.price;
+        } else {
+            mid = (event.best_bid + event.best_ask) / 2.0;
+        }
+        
+        for (auto& q : quoters) {
+            auto start = std::chrono::steady_clock::now();
+            if (q.type == QuoteModelType::HEURISTIC) {
+                volatility.push(mid);
+                double vol = volatility.samples() >= 9 ? volatility.volatility() : 0.0;
+                q.quote = heuristic.quote(mid, q.inventory, vol);
+            } else {
+                avellaneda_stoikov.onMid(mid, event.timestamp_ms);
+                q.quote = avellaneda_stoikov.quote(mid, q.inventory);
+            }
+            q.quote_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            q.spread_sum += q.quote.spread_bps;
+            q.quotes++;
+        }
+    }
+    
+    for (auto& q : quoters) {
+        q.stats.model = quoteModelName(q.type);
+        q.stats.final_inventory = q.inventory;
+        q.stats.pnl = q.cash + q.inventory * mid;
+        q.stats.avg_spread_bps = q.quotes > 0 ? q.spread_sum / q.quotes : 0.0;
+        q.stats.avg_quote_ns = q.quotes > 0 ? q.quote_ns / q.quotes : 0.0;
+        results.push_back(q.stats);
+    }
+    return results;
+}
+
 } // namespace moneybot
@@ -1,4 +1,5 @@
 #include "../include/cli_command_processor.h"
+#include "../include/stress_scenario_engine.h"
 #include <iostream>
 #include <iomanip>
 
@@ -283,7 +284,32 @@ int CLICommandProcessor::cmd_risk_check(const std::vector<std::string>& args) {
     std::cout << "🛡️ Risk Limits:\n";
     std::cout << "  Max Position Size:      $10,000.00\n";
     std::cout << "  Max Daily Loss:         $1,000.00\n";
-    std::cout << "  Stop Loss Threshold:    5.00%\n";
+    std::cout << "  Stop Loss Threshold:    5.00%\n\n";
+    
+    // Stress scenarios on the current book (positions marked at average price)
+    const auto& config = config_.getConfig();
+    if (config.contains("risk") && config["risk"].contains("stress")) {
+        StressScenarioEngine stress(config["risk"]["stress"].value("threads", 0));
+        stress.loadScenarios(config["risk"]["stress"]);
+        
+        std::vector<StressPosition> positions;
+        for (const auto& position : portfolio_->getPositions()) {
+            positions.push_back({position.symbol, position.quantity, position.avg_price});
+        }
+        StressReport report = stress.run(positions);
+        
+        std::cout << "🌪️ Stress Scenarios (" << report.scenarios << " evaluated in "
+                  << report.elapsed_us / 1000.0 << " ms):\n";
+        if (positions.empty()) {
+            std::cout << "  No open positions\n";
+        } else {
+            std::cout << "  Worst Loss:             $" << std::fixed << std::setprecision(2) << report.worst_loss << "\n";
+            for (const auto& result : report.worst) {
+                std::cout << "  " << std::left << std::setw(40) << result.name << std::right
+                          << " $" << std::setprecision(2) << result.total << "\n";
+            }
+        }
+    }
     
     return 0;
 }
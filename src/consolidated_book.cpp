@@ -0,0 +1,173 @@
+#include "consolidated_book.h"
+#include <algorithm>
+
+namespace moneybot {
+
+namespace {
+
+// Side order: bids by descending price, asks by ascending
+inline bool ahead(double a, double b, bool is_bid) {
+    return is_bid ? a > b : a < b;
+}
+
+} // namespace
+
+double ConsolidatedBook::effectivePrice(const ConsolidatedLevel& level, size_t venue, bool is_bid) const {
+    double fee = (*venues)[venue].taker_fee;
+    return is_bid ? level.price * (1.0 - fee) : level.price * (1.0 + fee);
+}
+
+void ConsolidatedBook::venueLadder(size_t venue, bool is_bid, BookLadder& ladder) const {
+    ladder.depth = 0;
+    for (const auto& level : is_bid ? bids : asks) {
+        if (ladder.depth == BookLadder::MAX_LEVELS) break;
+        if (level.venue_quantity[venue] > 0.0) {
+            ladder.price[ladder.depth] = level.price;
+            ladder.size[ladder.depth] = level.venue_quantity[venue];
+            ++ladder.depth;
+        }
+    }
+}
+
+nlohmann::json ConsolidatedBook::toJson(size_t levels) const {
+    nlohmann::json j;
+    j["symbol"] = symbol;
+    j["venues"] = nlohmann::json::array();
+    for (size_t v = 0; v < venueCount(); ++v) {
+        j["venues"].push_back({{"exchange", (*venues)[v].exchange}, {"taker_fee", (*venues)[v].taker_fee}});
+    }
+    auto side = [&](const std::vector<ConsolidatedLevel>& book_side) {
+        nlohmann::json out = nlohmann::json::array();
+        for (size_t i = 0; i < book_side.size() && i < levels; ++i) {
+            const auto& level = book_side[i];
+            nlohmann::json by_venue;
+            for (size_t v = 0; v < venueCount(); ++v) {
+                if (level.venue_quantity[v] > 0.0) by_venue[(*venues)[v].exchange] = level.venue_quantity[v];
+            }
+            out.push_back({{"price", level.price}, {"quantity", level.quantity},
+                           {"effective_price", level.effective_price}, {"venues", by_venue}});
+        }
+        return out;
+    };
+    j["bids"] = side(bids);
+    j["asks"] = side(asks);
+    return j;
+}
+
+ConsolidatedBookBuilder::ConsolidatedBookBuilder(std::string symbol, size_t publish_depth)
+    : publish_depth_(publish_depth) {
+    book_.symbol = std::move(symbol);
+    book_.venues = std::make_shared<const std::vector<ConsolidatedVenue>>();
+}
+
+size_t ConsolidatedBookBuilder::addVenue(const std::string& exchange, double taker_fee) {
+    if (venueCount() >= ConsolidatedLevel::MAX_VENUES) return NO_VENUE;
+    // Copy-on-write: published snapshots keep the old venue list
+    auto venues = std::make_shared<std::vector<ConsolidatedVenue>>(*book_.venues);
+    venues->push_back(ConsolidatedVenue{exchange, taker_fee});
+    book_.venues = std::move(venues);
+    fees_[venueCount()] = taker_fee;
+    bid_ladders_.emplace_back();
+    ask_ladders_.emplace_back();
+    return venueCount() - 1;
+}
+
+void ConsolidatedBookBuilder::update(size_t venue, const BookLadder& bids, const BookLadder& asks) {
+    if (venue >= venueCount()) return;
+    applySide(book_.bids, true, venue, bid_ladders_[venue], bids);
+    applySide(book_.asks, false, venue, ask_ladders_[venue], asks);
+    bid_ladders_[venue] = bids;
+    ask_ladders_[venue] = asks;
+}
+
+std::shared_ptr<const ConsolidatedBook> ConsolidatedBookBuilder::publish() const {
+    auto snapshot = std::make_shared<ConsolidatedBook>();
+    snapshot->symbol = book_.symbol;
+    snapshot->venues = book_.venues;
+    snapshot->bids.assign(book_.bids.begin(), book_.bids.begin() + std::min(publish_depth_, book_.bids.size()));
+    snapshot->asks.assign(book_.asks.begin(), book_.asks.begin() + std::min(publish_depth_, book_.asks.size()));
+    return snapshot;
+}
+
+void ConsolidatedBookBuilder::applySide(std::vector<ConsolidatedLevel>& side, bool is_bid, size_t venue,
+                                        const BookLadder& previous, const BookLadder& next) {
+    // Both ladders are in side order; walk them together to find what changed. A tick
+    // usually moves a level or two, patched in place; when the ladder shifted wholesale
+    // one merge pass over the side beats that many vector inserts and erases.
+    auto walk = [&](auto&& changed) {
+        size_t i = 0, j = 0;
+        while (i < previous.depth || j < next.depth) {
+            if (j == next.depth || (i < previous.depth && ahead(previous.price[i], next.price[j], is_bid))) {
+                changed(previous.price[i], 0.0);    // Level gone
+                ++i;
+            } else if (i == previous.depth || ahead(next.price[j], previous.price[i], is_bid)) {
+                changed(next.price[j], next.size[j]);   // New level
+                ++j;
+            } else {
+                if (previous.size[i] != next.size[j]) changed(next.price[j], next.size[j]);
+                ++i;
+                ++j;
+            }
+        }
+    };
+
+    size_t changes = 0;
+    walk([&changes](double, double) { ++changes; });
+    if (changes <= PATCH_LIMIT) {
+        walk([&](double price, double quantity) { setQuantity(side, is_bid, venue, price, quantity); });
+    } else {
+        mergeSide(side, is_bid, venue, next);
+    }
+}
+
+void ConsolidatedBookBuilder::mergeSide(std::vector<ConsolidatedLevel>& side, bool is_bid, size_t venue,
+                                        const BookLadder& next) {
+    merged_.clear();
+    size_t i = 0, j = 0;
+    while (i < side.size() || j < next.depth) {
+        if (j == next.depth || (i < side.size() && ahead(side[i].price, next.price[j], is_bid))) {
+            merged_.push_back(side[i++]);
+            merged_.back().venue_quantity[venue] = 0.0;
+        } else if (i == side.size() || ahead(next.price[j], side[i].price, is_bid)) {
+            merged_.emplace_back();
+            merged_.back().price = next.price[j];
+            merged_.back().venue_quantity[venue] = std::max(next.size[j++], 0.0);
+        } else {
+            merged_.push_back(side[i++]);
+            merged_.back().venue_quantity[venue] = std::max(next.size[j++], 0.0);
+        }
+        if (!refreshLevel(merged_.back(), is_bid)) merged_.pop_back();
+    }
+    side.swap(merged_);
+}
+
+void ConsolidatedBookBuilder::setQuantity(std::vector<ConsolidatedLevel>& side, bool is_bid, size_t venue,
+                                          double price, double quantity) {
+    auto it = std::lower_bound(side.begin(), side.end(), price, [is_bid](const ConsolidatedLevel& level, double p) {
+        return ahead(level.price, p, is_bid);
+    });
+    bool found = it != side.end() && it->price == price;
+    if (!found) {
+        if (quantity <= 0.0) return;
+        it = side.insert(it, ConsolidatedLevel{});
+        it->price = price;
+    }
+
+    it->venue_quantity[venue] = std::max(quantity, 0.0);
+    if (!refreshLevel(*it, is_bid)) side.erase(it);
+}
+
+bool ConsolidatedBookBuilder::refreshLevel(ConsolidatedLevel& level, bool is_bid) const {
+    // The cheapest fee among the venues quoting this price sets the effective price
+    double total = 0.0;
+    double best_fee = 1.0;
+    for (size_t v = 0; v < ConsolidatedLevel::MAX_VENUES; ++v) {
+        total += level.venue_quantity[v];
+        if (level.venue_quantity[v] > 0.0) best_fee = std::min(best_fee, fees_[v]);
+    }
+    level.quantity = total;
+    level.effective_price = is_bid ? level.price * (1.0 - best_fee) : level.price * (1.0 + best_fee);
+    return total > 0.0;
+}
+
+} // namespace moneybot
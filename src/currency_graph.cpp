@@ -0,0 +1,283 @@
+#include "currency_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace moneybot {
+
+namespace {
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+constexpr double EPS = 1e-12;   // Log-space rounding noise
+constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+bool ArbitrageCycle::startFrom(const std::string& asset) {
+    auto it = std::find_if(legs.begin(), legs.end(),
+                           [&asset](const CycleLeg& leg) { return leg.from_asset == asset; });
+    if (it == legs.end()) return false;
+    std::rotate(legs.begin(), it, legs.end());
+
+    double multiplier = 1.0;
+    max_start_amount = INF;
+    for (const auto& leg : legs) {
+        max_start_amount = std::min(max_start_amount, leg.capacity / multiplier);
+        multiplier *= leg.rate;
+    }
+    return true;
+}
+
+CurrencyGraph::CurrencyGraph(CurrencyGraphParams params)
+    : params_(std::move(params)), min_log_return_(std::log1p(std::max(params_.min_return, 0.0))) {
+    // Longest suffix wins (USDT before USD)
+    std::sort(params_.quote_assets.begin(), params_.quote_assets.end(),
+              [](const std::string& a, const std::string& b) { return a.size() > b.size(); });
+}
+
+bool CurrencyGraph::splitSymbol(const std::string& symbol, std::string& base, std::string& quote) const {
+    size_t separator = symbol.find_first_of("-/_");
+    if (separator != std::string::npos) {
+        base = symbol.substr(0, separator);
+        quote = symbol.substr(separator + 1);
+        return !base.empty() && !quote.empty();
+    }
+    for (const auto& candidate : params_.quote_assets) {
+        if (symbol.size() > candidate.size() &&
+            symbol.compare(symbol.size() - candidate.size(), candidate.size(), candidate) == 0) {
+            base = symbol.substr(0, symbol.size() - candidate.size());
+            quote = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CurrencyGraph::update(const std::string& exchange, const std::string& symbol, double fee,
+                           double bid_price, double bid_size, double ask_price, double ask_size,
+                           std::vector<ArbitrageCycle>& found) {
+    uint32_t venue = exchangeId(exchange);
+    uint32_t market;
+    auto it = market_ids_[venue].find(symbol);
+    if (it != market_ids_[venue].end()) {
+        market = it->second;
+    } else {
+        std::string base, quote;
+        if (!splitSymbol(symbol, base, quote)) return false;
+        market = marketId(venue, symbol, base, quote);
+    }
+
+    const Market& entry = markets_[market];
+    double keep = 1.0 - fee;
+    setEdge(entry.bid_edge, bid_price, bid_price > 0.0 ? bid_price * keep : 0.0, bid_size);
+    setEdge(entry.ask_edge, ask_price, ask_price > 0.0 ? keep / ask_price : 0.0, ask_size * ask_price);
+
+    // One at a time, so each search starts from labels valid for every other edge
+    for (uint32_t edge : {entry.bid_edge, entry.ask_edge}) {
+        insertEdge(edge, found);
+        // Not set aside again: the cycle it was reported for is gone
+        if (!edges_[edge].set_aside) edges_[edge].cycle.clear();
+    }
+    return true;
+}
+
+void CurrencyGraph::addMarket(const std::string& exchange, const std::string& symbol,
+                              const std::string& base, const std::string& quote) {
+    uint32_t venue = exchangeId(exchange);
+    if (market_ids_[venue].count(symbol) == 0 && base != quote) {
+        marketId(venue, symbol, base, quote);
+    }
+}
+
+std::vector<ArbitrageCycle> CurrencyGraph::activeCycles() const {
+    std::vector<ArbitrageCycle> cycles;
+    for (const auto& edge : edges_) {
+        if (!edge.set_aside || edge.cycle.empty()) continue;
+        double weight = cycleWeight(edge.cycle);
+        if (weight < -min_log_return_) {
+            cycles.push_back(describe(edge.cycle, weight));
+        }
+    }
+    std::sort(cycles.begin(), cycles.end(), [](const ArbitrageCycle& a, const ArbitrageCycle& b) {
+        return a.gross_return > b.gross_return;
+    });
+    return cycles;
+}
+
+uint32_t CurrencyGraph::assetId(const std::string& asset) {
+    auto it = asset_ids_.find(asset);
+    if (it != asset_ids_.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(assets_.size());
+    asset_ids_.emplace(asset, id);
+    assets_.push_back(asset);
+    out_edges_.emplace_back();
+    dist_.push_back(0.0);
+    reach_.push_back(INF);
+    via_.push_back(0);
+    return id;
+}
+
+uint32_t CurrencyGraph::exchangeId(const std::string& exchange) {
+    for (uint32_t i = 0; i < exchanges_.size(); ++i) {
+        if (exchanges_[i] == exchange) return i;
+    }
+    exchanges_.push_back(exchange);
+    market_ids_.emplace_back();
+    return static_cast<uint32_t>(exchanges_.size() - 1);
+}
+
+uint32_t CurrencyGraph::marketId(uint32_t exchange, const std::string& symbol,
+                                 const std::string& base, const std::string& quote) {
+    uint32_t base_id = assetId(base);
+    uint32_t quote_id = assetId(quote);
+    uint32_t market = static_cast<uint32_t>(markets_.size());
+    uint32_t bid_edge = static_cast<uint32_t>(edges_.size());
+    uint32_t ask_edge = bid_edge + 1;
+
+    edges_.push_back(Edge{base_id, quote_id, market, false, 0.0, 0.0, 0.0, INF, false, {}, 0.0});
+    edges_.push_back(Edge{quote_id, base_id, market, true, 0.0, 0.0, 0.0, INF, false, {}, 0.0});
+    out_edges_[base_id].push_back(bid_edge);
+    out_edges_[quote_id].push_back(ask_edge);
+    markets_.push_back(Market{exchange, symbol, bid_edge, ask_edge});
+    market_ids_[exchange].emplace(symbol, market);
+    return market;
+}
+
+void CurrencyGraph::setEdge(uint32_t edge, double price, double rate, double capacity) {
+    Edge& e = edges_[edge];
+    e.price = price;
+    e.rate = rate;
+    e.capacity = capacity;
+    e.weight = rate > 0.0 ? -std::log(rate) : INF;
+    e.set_aside = false;
+}
+
+void CurrencyGraph::insertEdge(uint32_t edge, std::vector<ArbitrageCycle>& found) {
+    const Edge& inserted = edges_[edge];
+    if (inserted.weight == INF) return;
+    // A rise keeps dist[to] <= dist[from] + w; only a shortfall needs work
+    double slack = dist_[inserted.to] - dist_[inserted.from] - inserted.weight;
+    if (slack <= EPS) return;
+
+    auto later = [](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+        return a.first > b.first;
+    };
+    reach_[inserted.to] = 0.0;
+    touched_.push_back(inserted.to);
+    heap_.emplace_back(0.0, inserted.to);
+
+    // Below three legs the search skips straight back along the same pair; those two-leg
+    // closes are checked separately below
+    const bool skip_direct = params_.min_legs > 2;
+    bool closed = false;
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        auto [distance, asset] = heap_.back();
+        heap_.pop_back();
+        if (distance > reach_[asset]) continue;     // Stale entry
+        ++searched_;
+        if (asset == inserted.from) {
+            closed = true;
+            break;
+        }
+        for (uint32_t id : out_edges_[asset]) {
+            const Edge& e = edges_[id];
+            if (e.set_aside || e.weight == INF) continue;
+            if (skip_direct && asset == inserted.to && e.to == inserted.from) continue;
+            // Reduced costs are non-negative up to rounding
+            double next = distance + std::max(e.weight + dist_[asset] - dist_[e.to], 0.0);
+            if (next >= slack - EPS || next >= reach_[e.to]) continue;
+            if (reach_[e.to] == INF) touched_.push_back(e.to);
+            reach_[e.to] = next;
+            via_[e.to] = id;
+            heap_.emplace_back(next, e.to);
+            std::push_heap(heap_.begin(), heap_.end(), later);
+        }
+    }
+
+    uint32_t direct = NO_EDGE;
+    if (!closed && skip_direct) {
+        for (uint32_t id : out_edges_[inserted.to]) {
+            const Edge& e = edges_[id];
+            if (e.to == inserted.from && !e.set_aside && e.weight < INF &&
+                e.weight + dist_[inserted.to] - dist_[inserted.from] < slack - EPS) {
+                direct = id;
+                break;
+            }
+        }
+    }
+
+    if (direct != NO_EDGE) {
+        // Only a two-leg cycle: break it without reporting
+        cycle_scratch_.assign({direct, edge});
+        setAside(edge, cycle_scratch_, cycleWeight(cycle_scratch_), found);
+    } else if (closed) {
+        // The cycle is the edge plus the search path back to its tail; leave the labels
+        cycle_scratch_.clear();
+        for (uint32_t asset = inserted.from; asset != inserted.to; asset = edges_[via_[asset]].from) {
+            cycle_scratch_.push_back(via_[asset]);
+        }
+        std::reverse(cycle_scratch_.begin(), cycle_scratch_.end());
+        cycle_scratch_.push_back(edge);
+        setAside(edge, cycle_scratch_, cycleWeight(cycle_scratch_), found);
+    } else {
+        // Every asset within the slack drops by what's left of it
+        for (uint32_t asset : touched_) {
+            dist_[asset] -= slack - reach_[asset];
+        }
+    }
+
+    for (uint32_t asset : touched_) reach_[asset] = INF;
+    touched_.clear();
+    heap_.clear();
+}
+
+double CurrencyGraph::cycleWeight(const std::vector<uint32_t>& cycle) const {
+    double weight = 0.0;
+    for (uint32_t id : cycle) {
+        if (edges_[id].weight == INF) return INF;
+        weight += edges_[id].weight;
+    }
+    return weight;
+}
+
+void CurrencyGraph::setAside(uint32_t edge, const std::vector<uint32_t>& cycle, double weight,
+                             std::vector<ArbitrageCycle>& found) {
+    Edge& e = edges_[edge];
+    e.set_aside = true;
+    if (cycle.size() < params_.min_legs || -weight < min_log_return_) {
+        e.cycle.clear();
+        return;
+    }
+    // Unchanged since this edge last reported it: still set aside, but not news
+    if (e.cycle == cycle && std::abs(e.cycle_weight - weight) < EPS) return;
+    e.cycle = cycle;
+    e.cycle_weight = weight;
+    found.push_back(describe(cycle, weight));
+}
+
+ArbitrageCycle CurrencyGraph::describe(const std::vector<uint32_t>& cycle, double weight) const {
+    ArbitrageCycle result;
+    result.legs.reserve(cycle.size());
+    for (uint32_t id : cycle) {
+        const Edge& e = edges_[id];
+        const Market& market = markets_[e.market];
+        CycleLeg leg;
+        leg.exchange = exchanges_[market.exchange];
+        leg.symbol = market.symbol;
+        leg.is_buy = e.is_buy;
+        leg.from_asset = assets_[e.from];
+        leg.to_asset = assets_[e.to];
+        leg.price = e.price;
+        leg.rate = e.rate;
+        leg.capacity = e.capacity;
+        result.legs.push_back(std::move(leg));
+    }
+    result.gross_return = std::expm1(-weight);
+    result.detected = std::chrono::steady_clock::now();
+    result.startFrom(result.legs.front().from_asset);   // Fills max_start_amount
+    return result;
+}
+
+} // namespace moneybot
@@ -1,6 +1,8 @@
 #include "exchange_connectors.h"
 #include "config_manager.h"
 #include <chrono>
+#include <future>
+#include <set>
 #include <sstream>
 
 namespace moneybot {
@@ -23,10 +25,18 @@ void BaseExchangeConnector::connect() {
     
     should_stop_ = false;
     
-    // Start WebSocket connection in a separate thread
-    ws_thread_ = std::thread(&BaseExchangeConnector::webSocketLoop, this);
+    if (io_runtime_) {
+        // Handlers run on a shared I/O context rather than a thread of our own
+        io_lease_ = io_runtime_->acquire(config_.name);
+        poll_timer_ = std::make_unique<boost::asio::steady_timer>(io_lease_.context());
+        connected_ = true;
+        schedulePoll();
+    } else {
+        // Start WebSocket connection in a separate thread
+        ws_thread_ = std::thread(&BaseExchangeConnector::webSocketLoop, this);
+        connected_ = true;
+    }
     
-    connected_ = true;
     logInfo("Connected to " + config_.name);
 }
 
@@ -42,6 +52,24 @@ void BaseExchangeConnector::disconnect() {
         ws_thread_.join();
     }
     
+    if (poll_timer_) {
+        // Cancel on the context's thread: once that has run, no poll can still be pending
+        // against this connector. The runtime must be stopped after its connections.
+        auto& context = io_lease_.context();
+        if (context.get_executor().running_in_this_thread() || !io_runtime_->isRunning()) {
+            poll_timer_->cancel();
+        } else {
+            std::promise<void> cancelled;
+            boost::asio::post(context, [this, &cancelled]() {
+                poll_timer_->cancel();
+                cancelled.set_value();
+            });
+            cancelled.get_future().wait();
+        }
+        poll_timer_.reset();
+        io_lease_.release();
+    }
+    
     logInfo("Disconnected from " + config_.name);
 }
 
@@ -89,6 +117,24 @@ ExchangeBalance BaseExchangeConnector::getBalance(const std::string& asset) cons
     return balance;
 }
 
+std::vector<ExchangeBalance> BaseExchangeConnector::getBalances() const {
+    // Default implementation - one simulated balance per asset the venue lists
+    static const CurrencyGraph splitter;
+    std::set<std::string> assets;
+    for (const auto& symbol : getAvailableSymbols()) {
+        std::string base, quote;
+        if (splitter.splitSymbol(symbol, base, quote)) {
+            assets.insert(base);
+            assets.insert(quote);
+        }
+    }
+    std::vector<ExchangeBalance> balances;
+    for (const auto& asset : assets) {
+        balances.push_back(getBalance(asset));
+    }
+    return balances;
+}
+
 OrderBook BaseExchangeConnector::getOrderBook(const std::string& symbol) const {
     // Return a dummy order book - in real implementation, this would fetch from the exchange
     OrderBook book(logger_);
@@ -153,6 +199,17 @@ void BaseExchangeConnector::webSocketLoop() {
     logInfo("WebSocket loop ended");
 }
 
+void BaseExchangeConnector::schedulePoll() {
+    poll_timer_->expires_after(std::chrono::milliseconds(100));
+    poll_timer_->async_wait([this](const boost::system::error_code& ec) {
+        if (ec || should_stop_) return;
+        
+        // Simulate latency measurement
+        updateLatency(50.0 + (rand() % 50)); // 50-100ms latency
+        schedulePoll();
+    });
+}
+
 // BinanceConnector implementation
 BinanceConnector::BinanceConnector(const ExchangeConfig& config, std::shared_ptr<Logger> logger)
     : BaseExchangeConnector(config, logger) {
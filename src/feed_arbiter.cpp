@@ -0,0 +1,106 @@
+#include "feed_arbiter.h"
+#include <algorithm>
+
+namespace moneybot {
+
+FeedArbiter::FeedArbiter(size_t feeds) {
+    for (size_t i = 0; i < std::max<size_t>(feeds, 1); ++i) {
+        counters_.push_back(std::make_unique<Counters>());
+    }
+}
+
+bool FeedArbiter::accept(FeedSequence& sequence, size_t feed, const nlohmann::json& data,
+                         std::chrono::steady_clock::time_point now) {
+    Counters& counters = *counters_[feed];
+    counters.messages.fetch_add(1, std::memory_order_relaxed);
+    auto id = updateId(data);
+    if (!id) {
+        counters.unsequenced.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (!sequence.seen || *id > sequence.last_id) {
+        sequence.seen = true;
+        sequence.last_id = *id;
+        sequence.winner = feed;
+        sequence.won_at = now;
+        counters.wins.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    counters.duplicates.fetch_add(1, std::memory_order_relaxed);
+    // Only the latest update's arrival is kept; copies of older ones just drop
+    if (*id == sequence.last_id && sequence.winner != feed) {
+        recordLead(sequence.winner, std::chrono::duration<double, std::micro>(now - sequence.won_at).count());
+    }
+    return false;
+}
+
+bool FeedArbiter::advance(FeedSequence& sequence, const nlohmann::json& data) {
+    auto id = updateId(data);
+    if (!id) return true;
+    if (sequence.seen && *id <= sequence.last_id) return false;
+    sequence.seen = true;
+    sequence.last_id = *id;
+    return true;
+}
+
+std::optional<uint64_t> FeedArbiter::updateId(const nlohmann::json& data) {
+    for (const char* key : {"u", "lastUpdateId", "t", "a"}) {
+        auto it = data.find(key);
+        if (it != data.end() && it->is_number_unsigned()) return it->get<uint64_t>();
+        if (it != data.end() && it->is_number_integer() && it->get<int64_t>() >= 0) {
+            return static_cast<uint64_t>(it->get<int64_t>());
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<FeedStats> FeedArbiter::stats() const {
+    std::vector<FeedStats> result;
+    for (size_t i = 0; i < counters_.size(); ++i) {
+        const Counters& counters = *counters_[i];
+        FeedStats entry;
+        entry.feed = i;
+        entry.messages = counters.messages.load(std::memory_order_relaxed);
+        entry.wins = counters.wins.load(std::memory_order_relaxed);
+        entry.duplicates = counters.duplicates.load(std::memory_order_relaxed);
+        entry.unsequenced = counters.unsequenced.load(std::memory_order_relaxed);
+        entry.lead_avg_us = counters.lead_avg_us.load(std::memory_order_relaxed);
+        entry.lead_max_us = counters.lead_max_us.load(std::memory_order_relaxed);
+        result.push_back(entry);
+    }
+    return result;
+}
+
+nlohmann::json FeedArbiter::toJson() const {
+    nlohmann::json feeds = nlohmann::json::array();
+    for (const auto& entry : stats()) {
+        uint64_t arbitrated = entry.wins + entry.duplicates;
+        feeds.push_back({
+            {"feed", entry.feed},
+            {"messages", entry.messages},
+            {"wins", entry.wins},
+            {"duplicates", entry.duplicates},
+            {"unsequenced", entry.unsequenced},
+            {"win_rate", arbitrated > 0 ? static_cast<double>(entry.wins) / arbitrated : 0.0},
+            {"lead_avg_us", entry.lead_avg_us},
+            {"lead_max_us", entry.lead_max_us}
+        });
+    }
+    return feeds;
+}
+
+void FeedArbiter::recordLead(size_t feed, double lead_us) {
+    // Duplicates of one feed's wins arrive on the other feeds' threads
+    Counters& counters = *counters_[feed];
+    double avg = counters.lead_avg_us.load(std::memory_order_relaxed);
+    while (!counters.lead_avg_us.compare_exchange_weak(avg, avg == 0.0 ? lead_us : avg + (lead_us - avg) / 16.0,
+                                                       std::memory_order_relaxed)) {
+    }
+    double max = counters.lead_max_us.load(std::memory_order_relaxed);
+    while (lead_us > max &&
+           !counters.lead_max_us.compare_exchange_weak(max, lead_us, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace moneybot
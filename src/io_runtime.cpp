@@ -0,0 +1,188 @@
+#include "io_runtime.h"
+#include <algorithm>
+
+namespace moneybot {
+
+IoRuntime::Lease::Lease(Lease&& other) noexcept
+    : runtime_(other.runtime_), index_(other.index_), weight_(other.weight_) {
+    other.runtime_ = nullptr;
+}
+
+IoRuntime::Lease& IoRuntime::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        runtime_ = other.runtime_;
+        index_ = other.index_;
+        weight_ = other.weight_;
+        other.runtime_ = nullptr;
+    }
+    return *this;
+}
+
+boost::asio::io_context& IoRuntime::Lease::context() const {
+    return runtime_->contexts_[index_]->ioc;
+}
+
+void IoRuntime::Lease::release() {
+    if (runtime_) {
+        runtime_->release(index_, weight_);
+        runtime_ = nullptr;
+    }
+}
+
+IoRuntime::IoRuntime(std::shared_ptr<Logger> logger, const nlohmann::json& config)
+    : logger_(logger) {
+    nlohmann::json io = config.value("io", nlohmann::json::object());
+    size_t count = io.value("contexts", 1);
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    bool pin_threads = io.value("pin_threads", true);
+    int first_core = io.value("first_core", 0);
+    probe_interval_ = std::chrono::milliseconds(std::max(1, io.value("lag_probe_ms", 100)));
+
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (size_t i = 0; i < count; ++i) {
+        auto context = std::make_unique<Context>();
+        if (pin_threads) {
+            context->core = (first_core + static_cast<int>(i)) % cores;
+        }
+        contexts_.push_back(std::move(context));
+    }
+}
+
+IoRuntime::~IoRuntime() {
+    stop();
+    // Handlers still pending are destroyed with their context and may drop the last
+    // reference to a connection; its lease has nothing left to give back
+    destroying_ = true;
+}
+
+void IoRuntime::start() {
+    if (running_.exchange(true)) return;
+    for (auto& context : contexts_) {
+        Context* ctx = context.get();
+        ctx->ioc.restart();
+        ctx->work.emplace(ctx->ioc.get_executor());
+        armProbe(*ctx);
+        ctx->thread = std::thread([ctx]() { ctx->ioc.run(); });
+        pinThread(*ctx);
+    }
+    if (logger_) {
+        logger_->getLogger()->info("I/O runtime started with {} contexts", contexts_.size());
+    }
+}
+
+void IoRuntime::stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& context : contexts_) {
+        context->work.reset();
+        context->ioc.stop();
+    }
+    for (auto& context : contexts_) {
+        if (context->thread.joinable()) context->thread.join();
+    }
+    // Cancelled operations and posted closes are ready but were never run; run them here,
+    // on this thread, rather than dropping them with whatever they hold
+    for (auto& context : contexts_) {
+        context->probe.cancel();
+        context->ioc.restart();
+        context->ioc.poll();
+    }
+}
+
+IoRuntime::Lease IoRuntime::acquire(const std::string& name, double weight) {
+    std::lock_guard<std::mutex> lock(assign_mutex_);
+    size_t best = 0;
+    for (size_t i = 1; i < contexts_.size(); ++i) {
+        const Context& candidate = *contexts_[i];
+        const Context& current = *contexts_[best];
+        if (candidate.load < current.load ||
+            (candidate.load == current.load &&
+             candidate.lag_avg_us.load(std::memory_order_relaxed) < current.lag_avg_us.load(std::memory_order_relaxed))) {
+            best = i;
+        }
+    }
+    contexts_[best]->load += weight;
+    ++contexts_[best]->connections;
+    if (logger_) {
+        logger_->getLogger()->debug("I/O context {} takes {} (load {:.1f})", best, name, contexts_[best]->load);
+    }
+    return Lease(this, best, weight);
+}
+
+void IoRuntime::release(size_t index, double weight) {
+    if (destroying_) return;
+    std::lock_guard<std::mutex> lock(assign_mutex_);
+    Context& context = *contexts_[index];
+    context.load = std::max(0.0, context.load - weight);
+    if (context.connections > 0) --context.connections;
+}
+
+std::vector<IoContextStats> IoRuntime::stats() const {
+    std::lock_guard<std::mutex> lock(assign_mutex_);
+    std::vector<IoContextStats> result;
+    for (size_t i = 0; i < contexts_.size(); ++i) {
+        const Context& context = *contexts_[i];
+        IoContextStats entry;
+        entry.index = i;
+        entry.core = context.core;
+        entry.connections = context.connections;
+        entry.load = context.load;
+        entry.lag_last_us = context.lag_last_us.load(std::memory_order_relaxed);
+        entry.lag_avg_us = context.lag_avg_us.load(std::memory_order_relaxed);
+        entry.lag_max_us = context.lag_max_us.load(std::memory_order_relaxed);
+        entry.probes = context.probes.load(std::memory_order_relaxed);
+        result.push_back(entry);
+    }
+    return result;
+}
+
+nlohmann::json IoRuntime::toJson() const {
+    nlohmann::json contexts = nlohmann::json::array();
+    for (const auto& entry : stats()) {
+        contexts.push_back({
+            {"index", entry.index},
+            {"core", entry.core},
+            {"connections", entry.connections},
+            {"load", entry.load},
+            {"lag_last_us", entry.lag_last_us},
+            {"lag_avg_us", entry.lag_avg_us},
+            {"lag_max_us", entry.lag_max_us},
+            {"probes", entry.probes}
+        });
+    }
+    return {{"running", running_.load()}, {"contexts", contexts}};
+}
+
+void IoRuntime::armProbe(Context& context) {
+    context.probe.expires_after(probe_interval_);
+    context.probe.async_wait([this, &context](const boost::system::error_code& ec) {
+        if (ec) return;
+        // Only this context's thread writes its lag figures
+        double lag = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - context.probe.expiry()).count();
+        double avg = context.lag_avg_us.load(std::memory_order_relaxed);
+        uint64_t probes = context.probes.load(std::memory_order_relaxed);
+        context.lag_last_us.store(lag, std::memory_order_relaxed);
+        context.lag_avg_us.store(probes == 0 ? lag : avg + (lag - avg) / 16.0, std::memory_order_relaxed);
+        context.lag_max_us.store(std::max(lag, context.lag_max_us.load(std::memory_order_relaxed)),
+                                 std::memory_order_relaxed);
+        context.probes.store(probes + 1, std::memory_order_relaxed);
+        armProbe(context);
+    });
+}
+
+void IoRuntime::pinThread(Context& context) {
+#ifdef __linux__
+    if (context.core < 0) return;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(static_cast<size_t>(context.core), &cpuset);
+    if (pthread_setaffinity_np(context.thread.native_handle(), sizeof(cpu_set_t), &cpuset) != 0 && logger_) {
+        logger_->getLogger()->warn("I/O context: failed to pin to core {}", context.core);
+    }
+#endif
+}
+
+} // namespace moneybot
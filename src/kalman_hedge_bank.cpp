@@ -0,0 +1,96 @@
+#include "kalman_hedge_bank.h"
+#include <algorithm>
+#include <cmath>
+
+namespace moneybot {
+
+namespace {
+
+// Four doubles per operation; GCC/Clang vector extension, one AVX register or two SSE/NEON
+// ones. Element-aligned and may_alias so it can be loaded straight from the arrays.
+typedef double double4 __attribute__((vector_size(32), aligned(8), may_alias));
+
+inline double4& lane(std::vector<double>& v, size_t i) {
+    return *reinterpret_cast<double4*>(v.data() + i);
+}
+
+} // namespace
+
+KalmanHedgeBank::KalmanHedgeBank(KalmanHedgeParams params) : params_(params) {
+    params_.observation_noise = std::max(params_.observation_noise, 1e-12);
+    params_.process_noise = std::max(params_.process_noise, 0.0);
+}
+
+size_t KalmanHedgeBank::addFilter(double hedge_ratio, double intercept) {
+    size_t filter = count_++;
+    if (filter >= ratio_.size()) {
+        size_t padded = (count_ + LANES - 1) / LANES * LANES;
+        for (auto* v : {&intercept_, &ratio_, &p00_, &p01_, &p11_, &y_, &x_, &mask_, &innovation_, &variance_}) {
+            v->resize(padded, 0.0);
+        }
+        for (size_t i = filter; i < padded; ++i) initialize(i, 1.0, 0.0);
+    }
+    initialize(filter, hedge_ratio, intercept);
+    return filter;
+}
+
+void KalmanHedgeBank::reset(size_t filter, double hedge_ratio, double intercept) {
+    if (filter < count_) initialize(filter, hedge_ratio, intercept);
+}
+
+void KalmanHedgeBank::initialize(size_t filter, double hedge_ratio, double intercept) {
+    intercept_[filter] = params_.intercept ? intercept : 0.0;
+    ratio_[filter] = hedge_ratio;
+    p00_[filter] = params_.intercept ? params_.initial_variance : 0.0;
+    p01_[filter] = 0.0;
+    p11_[filter] = params_.initial_variance;
+    y_[filter] = x_[filter] = mask_[filter] = 0.0;
+    innovation_[filter] = variance_[filter] = 0.0;
+}
+
+double KalmanHedgeBank::zScore(size_t filter) const {
+    return variance_[filter] > 0.0 ? innovation_[filter] / std::sqrt(variance_[filter]) : 0.0;
+}
+
+void KalmanHedgeBank::step() {
+    // H = [h0, x]: h0 = 0 pins the intercept, whose covariance row then stays zero
+    const double h0 = params_.intercept ? 1.0 : 0.0;
+    const double q0 = params_.process_noise * h0;
+    const double q1 = params_.process_noise;
+    const double r = params_.observation_noise;
+    const double4 zero = {};
+
+    for (size_t i = 0; i < ratio_.size(); i += LANES) {
+        double4 a = lane(intercept_, i), b = lane(ratio_, i);
+        double4 p00 = lane(p00_, i), p01 = lane(p01_, i), p11 = lane(p11_, i);
+        double4 y = lane(y_, i), x = lane(x_, i), m = lane(mask_, i);
+
+        // Predict: random-walk states
+        p00 += q0;
+        p11 += q1;
+
+        // Update, with the gain zeroed on lanes that had no observation
+        double4 e = y - (a * h0 + b * x);
+        double4 ph0 = p00 * h0 + p01 * x;
+        double4 ph1 = p01 * h0 + p11 * x;
+        double4 s = ph0 * h0 + ph1 * x + r;
+        double4 g = m / s;
+        double4 k0 = ph0 * g, k1 = ph1 * g;
+        a += k0 * e;
+        b += k1 * e;
+        p00 -= k0 * ph0;
+        p01 -= k0 * ph1;
+        p11 -= k1 * ph1;
+
+        lane(intercept_, i) = a;
+        lane(ratio_, i) = b;
+        lane(p00_, i) = p00;
+        lane(p01_, i) = p01;
+        lane(p11_, i) = p11;
+        lane(innovation_, i) = e * m;
+        lane(variance_, i) = s * m;
+        lane(mask_, i) = zero;
+    }
+}
+
+} // namespace moneybot
@@ -5,6 +5,7 @@
 #include "strategy_factory.h"
 #include "config_manager.h"
 #include "market_data_simulator.h"
+#include "pair_discovery.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <iostream>
@@ -34,6 +35,7 @@ void printUsage(const char* program) {
               << "  --dry-run     Run without placing real orders\n"
               << "  --backtest    Run in backtest mode with historical data\n"
               << "  --multi-asset Run multi-asset trading mode\n"
+              << "  --discover-pairs [DB] Rank cointegrated pairs from the tick store\n"
               << std::endl;
 }
 
@@ -46,6 +48,7 @@ int main(int argc, char* argv[]) {
     bool dry_run = false;
     bool backtest_mode = false;
     bool multi_asset_mode = false;
+    bool discover_mode = false;
     std::string backtest_data = "data/ticks.db";
 
     // Parse command line arguments
@@ -75,6 +78,11 @@ int main(int argc, char* argv[]) {
             }
         } else if (arg == "--multi-asset") {
             multi_asset_mode = true;
+        } else if (arg == "--discover-pairs") {
+            discover_mode = true;
+            if (i + 1 < argc && argv[i+1][0] != '-') {
+                backtest_data = argv[++i];
+            }
         } else {
             std::cerr << "Unknown option: " << arg << std::endl;
             printUsage(argv[0]);
@@ -131,6 +139,47 @@ int main(int argc, char* argv[]) {
         std::cout << "Total Trades: " << result.total_trades << std::endl;
         std::cout << "Win/Loss: " << result.wins << "/" << result.losses << std::endl;
         std::cout << "Sharpe Ratio: " << result.sharpe_ratio << std::endl;
+        
+        if (config["strategy"]["type"].get<std::string>() == "market_maker") {
+            std::cout << "\n=== Quote Model Comparison ===" << std::endl;
+            for (const auto& stats : backtester.compareQuoteModels(backtest_data)) {
+                std::cout << stats.model << ": PnL $" << stats.pnl
+                          << " | Fills " << stats.fills
+                          << " | Inventory " << stats.final_inventory << " (max " << stats.max_abs_inventory << ")"
+                          << " | Avg Spread " << stats.avg_spread_bps << "bps"
+                          << " | " << stats.avg_quote_ns << "ns/quote" << std::endl;
+            }
+        }
+        return 0;
+    }
+
+    if (discover_mode) {
+        auto logger = std::make_shared<moneybot::Logger>();
+        json discovery = config.value("strategies", json::object())
+                               .value("statistical_arbitrage", json::object())
+                               .value("discovery", json::object());
+        moneybot::PairDiscovery discoverer(moneybot::PairDiscoveryParams(discovery), logger);
+        std::cout << "=== Pair Discovery ===" << std::endl;
+        std::cout << "Loading bars from: " << backtest_data << std::endl;
+        auto bars = discoverer.loadBars(backtest_data);
+        auto report = discoverer.run(bars);
+        std::cout << "Symbols: " << report.symbols << " | Bars: " << report.bars
+                  << " | Candidates: " << report.candidates << " | Cointegrated: " << report.cointegrated << std::endl;
+        std::cout << "Correlation: " << report.correlation_ms << "ms | Cointegration: "
+                  << report.cointegration_ms << "ms" << std::endl;
+        for (const auto& pair : report.pairs) {
+            std::cout << pair.base_symbol << "/" << pair.hedge_symbol
+                      << " | Hedge " << pair.hedge_ratio
+                      << " | ADF " << pair.adf_stat
+                      << " | Half-life " << pair.half_life_minutes << "min"
+                      << " | Corr " << pair.correlation << std::endl;
+        }
+        std::string output = discovery.value("output", std::string("data/discovered_pairs.json"));
+        std::ofstream out(output);
+        if (out) {
+            out << report.toJson().dump(4) << std::endl;
+            std::cout << "Ranked pairs written to: " << output << std::endl;
+        }
         return 0;
     }
 
@@ -45,7 +45,9 @@ void MarketDataSimulator::start() {
     }
     std::cout << std::endl;
     
-    simulation_thread_ = std::thread(&MarketDataSimulator::simulationLoop, this);
+    timers_.start();
+    scheduleUpdates();
+    timers_.scheduleEvery(5000, [this]() { printStatus(); });
 }
 
 void MarketDataSimulator::stop() {
@@ -54,9 +56,7 @@ void MarketDataSimulator::stop() {
     }
     
     running_ = false;
-    if (simulation_thread_.joinable()) {
-        simulation_thread_.join();
-    }
+    timers_.stop();
     std::cout << "⏹️ Market Data Simulator stopped" << std::endl;
 }
 
@@ -105,42 +105,38 @@ void MarketDataSimulator::simulateNewsEvent(double impact_percentage, std::chron
               << duration.count() << " seconds" << std::endl;
 }
 
-void MarketDataSimulator::simulationLoop() {
-    auto last_update = std::chrono::steady_clock::now();
-    auto last_status = std::chrono::steady_clock::now();
-    
-    while (running_) {
-        auto now = std::chrono::steady_clock::now();
-        
-        if (now - last_update >= update_interval_) {
-            updatePrices();
-            updateOrderBooks();
-            last_update = now;
-        }
-        
-        // Print status every 5 seconds
-        if (now - last_status >= std::chrono::seconds(5)) {
-            std::cout << "📈 Market Update - ";
-            for (const auto& symbol : symbols_) {
-                if (symbol == "BTCUSDT") { // Show only BTC for brevity
-                    auto avg_price = 0.0;
-                    int count = 0;
-                    for (const auto& [exchange, price] : symbol_prices_[symbol]) {
-                        avg_price += price;
-                        count++;
-                    }
-                    if (count > 0) {
-                        avg_price /= count;
-                        std::cout << symbol << ": $" << std::fixed << std::setprecision(2) << avg_price << " ";
-                    }
-                }
+void MarketDataSimulator::setUpdateInterval(std::chrono::milliseconds interval) {
+    update_interval_ = interval;
+    if (running_) {
+        scheduleUpdates();
+    }
+}
+
+void MarketDataSimulator::scheduleUpdates() {
+    timers_.cancel(update_timer_);
+    update_timer_ = timers_.scheduleEvery(update_interval_.count(), [this]() {
+        updatePrices();
+        updateOrderBooks();
+    });
+}
+
+void MarketDataSimulator::printStatus() {
+    std::cout << "📈 Market Update - ";
+    for (const auto& symbol : symbols_) {
+        if (symbol == "BTCUSDT") { // Show only BTC for brevity
+            auto avg_price = 0.0;
+            int count = 0;
+            for (const auto& [exchange, price] : symbol_prices_[symbol]) {
+                avg_price += price;
+                count++;
+            }
+            if (count > 0) {
+                avg_price /= count;
+                std::cout << symbol << ": $" << std::fixed << std::setprecision(2) << avg_price << " ";
             }
-            std::cout << std::endl;
-            last_status = now;
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+    std::cout << std::endl;
 }
 
 void MarketDataSimulator::updatePrices() {
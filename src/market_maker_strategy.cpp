@@ -15,10 +15,35 @@ MarketMakerConfig::MarketMakerConfig(const nlohmann::json& j) {
     volatility_window = j.value("volatility_window", 100);
     volatility_multiplier = j.value("volatility_multiplier", 1.5);
     refresh_interval_ms = j.value("refresh_interval_ms", 1000);
+    min_requote_interval_ms = j.value("min_requote_interval_ms", 100);
     min_profit_bps = j.value("min_profit_bps", 0.5);
     rebalance_threshold = j.value("rebalance_threshold", 0.5);
     max_slippage_bps = j.value("max_slippage_bps", 10.0);
     aggressive_rebalancing = j.value("aggressive_rebalancing", false);
+    quote_tolerance_bps = j.value("quote_tolerance_bps", 1.0);
+    quote_size_tolerance = j.value("quote_size_tolerance", 0.1);
+    amend_supported = j.value("amend_supported", true);
+    tick_size = j.value("tick_size", 0.01);
+    speculative_quotes = j.value("speculative_quotes", true);
+    snapshot_interval_ms = j.value("snapshot_interval_ms", 100);
+    order_timeout_ms = j.value("order_timeout_ms", 0);
+    quote_model = parseQuoteModelType(j.value("quote_model", "heuristic"));
+    as_gamma = j.value("as_gamma", 0.01);
+    as_horizon_sec = j.value("as_horizon_sec", 60.0);
+    as_initial_k = j.value("as_initial_k", 0.5);
+    as_min_trade_distance_bps = j.value("as_min_trade_distance_bps", 0.1);
+    as_trade_window = j.value("as_trade_window", 200);
+    as_volatility_halflife_sec = j.value("as_volatility_halflife_sec", 60.0);
+}
+
+HeuristicQuoteParams MarketMakerConfig::heuristicParams() const {
+    return {base_spread_bps, min_spread_bps, max_spread_bps,
+            volatility_multiplier, max_position, inventory_skew_factor};
+}
+
+AvellanedaStoikovParams MarketMakerConfig::avellanedaStoikovParams() const {
+    return {as_gamma, as_horizon_sec, as_initial_k, as_min_trade_distance_bps, as_trade_window,
+            as_volatility_halflife_sec, order_size, min_spread_bps, max_spread_bps};
 }
 
 MarketMakerStrategy::MarketMakerStrategy(std::shared_ptr<Logger> logger,
@@ -27,12 +52,15 @@ MarketMakerStrategy::MarketMakerStrategy(std::shared_ptr<Logger> logger,
                                        const nlohmann::json& config)
     : logger_(logger), order_manager_(order_manager), risk_manager_(risk_manager),
       current_position_(0.0), current_bid_price_(0.0), current_ask_price_(0.0), mid_price_(0.0),
-      current_volatility_(0.0), current_spread_bps_(0.0),
+      current_volatility_(0.0), current_spread_bps_(0.0), best_bid_(0.0), best_ask_(0.0),
+      size_rng_(std::random_device{}()),
       total_pnl_(0.0), realized_pnl_(0.0), unrealized_pnl_(0.0), 
-      total_trades_(0), avg_spread_(0.0), spread_samples_(0), strategy_active_(true) {
+      total_trades_(0), strategy_active_(true) {
     
     loadConfig(config);
-    // Note: deque doesn't have reserve, but we'll limit size in push operations
+    intent_manager_ = std::make_unique<OrderIntentManager>(logger_, order_manager_);
+    intent_manager_->setTolerance({config_.quote_tolerance_bps, config_.quote_size_tolerance,
+                                   config_.amend_supported});
     
     if (logger_) {
         logger_->getLogger()->info("MarketMakerStrategy initialized for {} with enhanced features", symbol_);
@@ -57,8 +85,13 @@ void MarketMakerStrategy::initialize() {
     current_position_ = 0.0;
     total_pnl_ = 0.0;
     total_trades_ = 0;
-    avg_spread_ = 0.0;
-    spread_samples_ = 0;
+    price_volatility_.clear();
+    spread_stats_.clear();
+    as_model_.reset();
+    speculative_quotes_.invalidate();
+    speculative_latency_ns_.clear();
+    full_latency_ns_.clear();
+    publishSnapshot(nullptr);
     
     last_quote_time_ = std::chrono::system_clock::now();
     last_rebalance_time_ = std::chrono::system_clock::now();
@@ -72,7 +105,7 @@ void MarketMakerStrategy::shutdown() {
 }
 
 void MarketMakerStrategy::onOrderBookUpdate(const OrderBook& order_book) {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    event_received_ = std::chrono::steady_clock::now();
     
     if (!strategy_active_) return;
     
@@ -81,28 +114,22 @@ void MarketMakerStrategy::onOrderBookUpdate(const OrderBook& order_book) {
     double best_ask = order_book.getBestAsk();
     
     if (best_bid > 0 && best_ask > 0) {
-        mid_price_ = (best_bid + best_ask) / 2.0;
-        
-        // Track price history for volatility calculation
-        recent_prices_.push_back(mid_price_);
-        if (recent_prices_.size() > config_.volatility_window) {
-            recent_prices_.pop_front();
-        }
+        // A prepared state goes out first; the statistics below catch up after the send.
+        // Tick-driven requotes share one minimum interval, table or not.
+        bool reacted = requoteIntervalElapsed() && reactFromTable(best_bid, best_ask);
         
-        // Calculate current spread
-        double spread_bps = (best_ask - best_bid) / mid_price_ * 10000.0;
-        recent_spreads_.push_back(spread_bps);
-        if (recent_spreads_.size() > config_.volatility_window) {
-            recent_spreads_.pop_front();
+        best_bid_ = best_bid;
+        best_ask_ = best_ask;
+        mid_price_ = (best_bid + best_ask) / 2.0;
+        if (risk_manager_) {
+            risk_manager_->onPrice(symbol_, mid_price_);
         }
         
-        // Update running average spread
-        if (spread_samples_ == 0) {
-            avg_spread_ = spread_bps;
-        } else {
-            avg_spread_ = (avg_spread_ * spread_samples_ + spread_bps) / (spread_samples_ + 1);
-        }
-        spread_samples_++;
+        // Track price and spread windows for volatility calculation
+        price_volatility_.push(mid_price_);
+        as_model_.onMid(mid_price_, std::chrono::duration_cast<std::chrono::milliseconds>(
+            event_received_.time_since_epoch()).count());
+        spread_stats_.push((best_ask - best_bid) / mid_price_ * 10000.0);
         
         // Calculate current volatility
         current_volatility_ = calculateVolatility();
@@ -111,14 +138,21 @@ void MarketMakerStrategy::onOrderBookUpdate(const OrderBook& order_book) {
         current_spread_bps_ = calculateOptimalSpread();
         
         // Check if we should refresh orders
-        if (shouldRefreshOrders()) {
-            cancelStaleOrders();
+        if (!reacted && shouldRefreshOrders()) {
             calculateQuotes();
             placeQuotes();
         }
         
+        // Prepare the next reactions with the updated statistics
+        precomputeQuotes();
+        
         // Update metrics
         updateMetrics();
+        
+        // Readers on other threads only ever see published snapshots
+        if (event_received_ - last_snapshot_ >= std::chrono::milliseconds(config_.snapshot_interval_ms)) {
+            publishSnapshot(&order_book);
+        }
     }
 }
 
@@ -126,6 +160,15 @@ void MarketMakerStrategy::onTrade(const Trade& trade) {
     logger_->getLogger()->debug("Trade: {} {} @ {}", 
                                trade.symbol, trade.quantity, trade.price);
     // No position update here; only update position on order fills (onOrderFill)
+    
+    // Trade distance from mid feeds the arrival-intensity estimate
+    if (trade.symbol == symbol_ && mid_price_ > 0) {
+        as_model_.onTrade(trade.price, mid_price_, std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        if (config_.quote_model == QuoteModelType::AVELLANEDA_STOIKOV) {
+            precomputeQuotes(); // k moved, prepared quotes are stale
+        }
+    }
 }
 
 void MarketMakerStrategy::onOrderAck(const OrderAck& ack) {
@@ -136,88 +179,204 @@ void MarketMakerStrategy::onOrderReject(const OrderReject& reject) {
     logger_->getLogger()->warn("Order rejected: {} - {}", reject.order_id, reject.reason);
     
     // Remove from active orders
-    std::lock_guard<std::mutex> lock(orders_mutex_);
-    active_orders_.erase(reject.order_id);
+    untrackOrder(reject.order_id);
 }
 
 void MarketMakerStrategy::onOrderFill(const OrderFill& fill) {
-    logger_->getLogger()->info("Order filled: {} {} @ {}", 
-                               fill.order_id, fill.quantity, fill.price);
+    event_received_ = std::chrono::steady_clock::now();
     
     // Update position
     auto it = active_orders_.find(fill.order_id);
     if (it != active_orders_.end()) {
         updatePosition(fill.quantity, it->second.side);
+        if (risk_manager_) {
+            double signed_qty = it->second.side == OrderSide::BUY ? fill.quantity : -fill.quantity;
+            risk_manager_->updatePosition(symbol_, signed_qty, fill.price);
+        }
         
         // Remove filled order
-        std::lock_guard<std::mutex> lock(orders_mutex_);
-        active_orders_.erase(fill.order_id);
+        untrackOrder(fill.order_id);
+        
+        // Requote straight from the table when this was a full fill we prepared for
+        if (std::abs(current_position_) <= config_.rebalance_threshold && reactFromTable(best_bid_, best_ask_)) {
+            precomputeQuotes();
+        }
+        publishSnapshot(nullptr);
     }
+    
+    logger_->getLogger()->info("Order filled: {} {} @ {}", 
+                               fill.order_id, fill.quantity, fill.price);
 }
 
 void MarketMakerStrategy::updateConfig(const nlohmann::json& config) {
     loadConfig(config);
+    if (intent_manager_) {
+        intent_manager_->setTolerance({config_.quote_tolerance_bps, config_.quote_size_tolerance,
+                                       config_.amend_supported});
+    }
     logger_->getLogger()->info("MarketMakerStrategy config updated");
 }
 
 void MarketMakerStrategy::calculateQuotes() {
     if (mid_price_ <= 0) return;
     
-    // Calculate spread in price terms using optimal spread
-    double spread_price = mid_price_ * (current_spread_bps_ / 10000.0);
-    double half_spread = spread_price / 2.0;
+    QuotePrices quote = modelQuote(mid_price_, current_position_);
+    current_spread_bps_ = quote.spread_bps;
+    
+    // Round to appropriate precision (assume 5 decimal places for crypto)
+    current_bid_price_ = std::floor(quote.bid * 100000) / 100000;
+    current_ask_price_ = std::ceil(quote.ask * 100000) / 100000;
     
-    // Apply inventory skew
-    double skew = calculateInventorySkew();
-    double skew_adjustment = mid_price_ * (skew / 10000.0);
+    logger_->getLogger()->debug("Calculated quotes ({}): Bid: {:.5f}, Ask: {:.5f}, Spread: {:.2f}bps, Skew: {:.2f}bps",
+                               quoteModelName(config_.quote_model), current_bid_price_, current_ask_price_,
+                               quote.spread_bps, quote.skew_bps);
+    if (config_.quote_model == QuoteModelType::AVELLANEDA_STOIKOV) {
+        logger_->getLogger()->debug("A-S state: sigma: {:.3f}bps/s^0.5, k: {:.3f}, A: {:.2f}/s",
+                                   as_model_.sigmaBps(), as_model_.arrivalDecay(), as_model_.arrivalRate());
+    }
+}
+
+QuotePrices MarketMakerStrategy::modelQuote(double mid, double position) const {
+    if (config_.quote_model == QuoteModelType::AVELLANEDA_STOIKOV) {
+        return as_model_.quote(mid, position);
+    }
+    return heuristic_model_.quote(mid, position, current_volatility_);
+}
+
+SpeculativeQuote MarketMakerStrategy::buildQuote(double best_bid, double best_ask, double position) const {
+    SpeculativeQuote result;
+    result.mid = (best_bid + best_ask) / 2.0;
     
-    // Calculate target prices
-    current_bid_price_ = mid_price_ - half_spread + skew_adjustment;
-    current_ask_price_ = mid_price_ + half_spread + skew_adjustment;
+    QuotePrices quote = modelQuote(result.mid, position);
+    result.bid = std::floor(quote.bid * 100000) / 100000;
+    result.ask = std::ceil(quote.ask * 100000) / 100000;
+    result.spread_bps = quote.spread_bps;
+    std::tie(result.bid_size, result.ask_size) = orderSizesFor(position);
+    return result;
+}
+
+void MarketMakerStrategy::precomputeQuotes() {
+    if (!config_.speculative_quotes || best_bid_ <= 0 || best_ask_ <= 0) return;
     
-    // Round to appropriate precision (assume 5 decimal places for crypto)
-    current_bid_price_ = std::floor(current_bid_price_ * 100000) / 100000;
-    current_ask_price_ = std::ceil(current_ask_price_ * 100000) / 100000;
+    // Fill states assume the resting quote fills in full
+    auto [bid_fill, ask_fill] = calculateOrderSizes();
+    for (const auto& [order_id, order] : active_orders_) {
+        if (order.side == OrderSide::BUY) bid_fill = order.quantity;
+        else ask_fill = order.quantity;
+    }
     
-    logger_->getLogger()->debug("Calculated quotes: Bid: {:.5f}, Ask: {:.5f}, Spread: {:.2f}bps, Skew: {:.2f}",
-                               current_bid_price_, current_ask_price_, current_spread_bps_, skew);
+    speculative_quotes_.precompute(best_bid_, best_ask_, current_position_, bid_fill, ask_fill,
+        [this](double bid, double ask, double position) { return buildQuote(bid, ask, position); });
+}
+
+bool MarketMakerStrategy::reactFromTable(double best_bid, double best_ask) {
+    if (!config_.speculative_quotes) return false;
+    
+    const SpeculativeQuote* quote = speculative_quotes_.lookup(best_bid, best_ask, current_position_);
+    if (!quote) return false;
+    
+    current_bid_price_ = quote->bid;
+    current_ask_price_ = quote->ask;
+    current_spread_bps_ = quote->spread_bps;
+    sendQuotes(quote->bid_size, quote->ask_size, true);
+    return true;
 }
 
 void MarketMakerStrategy::placeQuotes() {
+    // Get sophisticated order sizes
+    auto [bid_size, ask_size] = calculateOrderSizes();
+    sendQuotes(bid_size, ask_size, false);
+}
+
+void MarketMakerStrategy::sendQuotes(double bid_size, double ask_size, bool speculative) {
     if (risk_manager_ && risk_manager_->isEmergencyStopped()) {
         if (logger_) logger_->getLogger()->warn("Not placing quotes: Emergency stop active");
         return;
     }
     
-    // Cancel stale orders first
-    cancelStaleOrders();
-    
-    // Get sophisticated order sizes
-    auto [bid_size, ask_size] = calculateOrderSizes();
-    
-    // Place bid order
+    // Declare the quotes we want; a side left out gets its resting quote pulled
+    std::vector<QuoteIntent> desired;
     if (current_bid_price_ > 0 && isWithinRiskLimits(current_bid_price_, bid_size, true)) {
-        placeBidOrder(current_bid_price_, bid_size);
+        desired.push_back({OrderSide::BUY, current_bid_price_, bid_size});
     }
-    
-    // Place ask order
     if (current_ask_price_ > 0 && isWithinRiskLimits(current_ask_price_, ask_size, false)) {
-        placeAskOrder(current_ask_price_, ask_size);
+        desired.push_back({OrderSide::SELL, current_ask_price_, ask_size});
+    }
+    
+    std::vector<LiveQuote> live;
+    for (const auto& [order_id, order] : active_orders_) {
+        live.push_back({order_id, order.side, order.price, order.quantity, order.timestamp});
+    }
+    
+    // Diff against what is resting and run new orders through pre-trade risk
+    auto actions = intent_manager_->plan(live, desired);
+    if (risk_manager_) {
+        std::vector<QuoteAction> checked;
+        checked.reserve(actions.size());
+        for (auto& action : actions) {
+            if (action.type == QuoteActionType::PLACE || action.type == QuoteActionType::AMEND) {
+                Order order;
+                order.symbol = symbol_;
+                order.side = action.side;
+                order.type = OrderType::LIMIT;
+                order.quantity = action.quantity;
+                order.price = action.price;
+                if (!risk_manager_->checkOrderRisk(order)) {
+                    if (logger_) logger_->getLogger()->warn("{} quote rejected by risk manager",
+                                                            action.side == OrderSide::BUY ? "Bid" : "Ask");
+                    if (action.type == QuoteActionType::PLACE) continue;
+                    // The quote being amended is stale; don't leave it resting
+                    action.type = QuoteActionType::CANCEL;
+                }
+            }
+            checked.push_back(std::move(action));
+        }
+        actions.swap(checked);
     }
     
-    last_quote_time_ = std::chrono::system_clock::now();
+    // Event-to-send latency, measured up to the hand-off to the order manager
+    bool sending = std::any_of(actions.begin(), actions.end(), [](const QuoteAction& action) {
+        return action.type != QuoteActionType::KEEP;
+    });
+    if (sending) {
+        double latency_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - event_received_).count();
+        (speculative ? speculative_latency_ns_ : full_latency_ns_).push(latency_ns);
+    }
+    
+    auto results = intent_manager_->execute(symbol_, actions);
+    
+    auto now = std::chrono::system_clock::now();
+    for (const auto& result : results) {
+        if (!result.success) continue;
+        const auto& action = result.action;
+        switch (action.type) {
+            case QuoteActionType::AMEND:
+                untrackOrder(action.order_id);
+                trackOrder({result.new_order_id, action.side, action.price, action.quantity, now});
+                break;
+            case QuoteActionType::PLACE:
+                trackOrder({result.new_order_id, action.side, action.price, action.quantity, now});
+                break;
+            case QuoteActionType::CANCEL:
+                untrackOrder(action.order_id);
+                break;
+            case QuoteActionType::KEEP:
+                armOrderTimeout(action.order_id); // Still the quote we want
+                break;
+        }
+    }
+    
+    last_quote_time_ = now;
 }
 
 void MarketMakerStrategy::cancelStaleOrders() {
     auto now = std::chrono::system_clock::now();
     std::vector<std::string> stale_orders;
     
-    {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
-        for (const auto& [order_id, order] : active_orders_) {
-            if (isOrderStale(order_id)) {
-                stale_orders.push_back(order_id);
-            }
+    for (const auto& [order_id, order] : active_orders_) {
+        if (isOrderStale(order_id)) {
+            stale_orders.push_back(order_id);
         }
     }
     
@@ -274,9 +433,7 @@ void MarketMakerStrategy::placeBidOrder(double price, double quantity) {
     if (order_manager_) {
         std::string order_id = order_manager_->placeOrder(order);
         if (!order_id.empty()) {
-            std::lock_guard<std::mutex> lock(orders_mutex_);
-            active_orders_[order_id] = {order_id, OrderSide::BUY, price, quantity, 
-                                       std::chrono::system_clock::now()};
+            trackOrder({order_id, OrderSide::BUY, price, quantity, std::chrono::system_clock::now()});
             if (logger_) logger_->getLogger()->debug("Bid order placed: {} @ {}", quantity, price);
         }
     }
@@ -299,9 +456,7 @@ void MarketMakerStrategy::placeAskOrder(double price, double quantity) {
     if (order_manager_) {
         std::string order_id = order_manager_->placeOrder(order);
         if (!order_id.empty()) {
-            std::lock_guard<std::mutex> lock(orders_mutex_);
-            active_orders_[order_id] = {order_id, OrderSide::SELL, price, quantity, 
-                                       std::chrono::system_clock::now()};
+            trackOrder({order_id, OrderSide::SELL, price, quantity, std::chrono::system_clock::now()});
             if (logger_) logger_->getLogger()->debug("Ask order placed: {} @ {}", quantity, price);
         }
     }
@@ -309,19 +464,47 @@ void MarketMakerStrategy::placeAskOrder(double price, double quantity) {
 
 void MarketMakerStrategy::cancelOrder(const std::string& order_id) {
     if (order_manager_ && order_manager_->cancelOrder(order_id)) {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
-        active_orders_.erase(order_id);
+        untrackOrder(order_id);
         if (logger_) logger_->getLogger()->debug("Order cancelled: {}", order_id);
     }
 }
 
+void MarketMakerStrategy::trackOrder(const ActiveOrder& order) {
+    active_orders_[order.order_id] = order;
+    armOrderTimeout(order.order_id);
+}
+
+void MarketMakerStrategy::untrackOrder(const std::string& order_id) {
+    active_orders_.erase(order_id);
+    auto it = order_timers_.find(order_id);
+    if (it != order_timers_.end()) {
+        if (timers_) timers_->cancel(it->second);
+        order_timers_.erase(it);
+    }
+}
+
+void MarketMakerStrategy::armOrderTimeout(const std::string& order_id) {
+    int timeout_ms = config_.order_timeout_ms != 0 ? config_.order_timeout_ms : config_.refresh_interval_ms * 2;
+    if (!timers_ || timeout_ms <= 0) return;
+    
+    // Re-arming is a cancel plus a schedule, both O(1) on the wheel
+    auto& timer = order_timers_[order_id];
+    timers_->cancel(timer);
+    timer = timers_->schedule(timeout_ms, [this, order_id]() { onOrderTimeout(order_id); });
+}
+
+void MarketMakerStrategy::onOrderTimeout(const std::string& order_id) {
+    order_timers_.erase(order_id);
+    if (active_orders_.count(order_id)) {
+        logger_->getLogger()->debug("Quote {} not reconfirmed in time, cancelling", order_id);
+        cancelOrder(order_id);
+    }
+}
+
 void MarketMakerStrategy::cancelAllOrders() {
     std::vector<std::string> order_ids;
-    {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
-        for (const auto& [order_id, _] : active_orders_) {
-            order_ids.push_back(order_id);
-        }
+    for (const auto& [order_id, _] : active_orders_) {
+        order_ids.push_back(order_id);
     }
     
     for (const auto& order_id : order_ids) {
@@ -360,11 +543,8 @@ double MarketMakerStrategy::calculateAskPrice() {
 
 double MarketMakerStrategy::calculateOrderSize() {
     // Base size with some randomization to avoid detection
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<> dis(0.8, 1.2);
-    
-    return config_.order_size * dis(gen);
+    std::uniform_real_distribution<> dis(0.8, 1.2);
+    return config_.order_size * dis(size_rng_);
 }
 
 bool MarketMakerStrategy::shouldPlaceOrders() {
@@ -383,11 +563,20 @@ bool MarketMakerStrategy::isOrderStale(const std::string& order_id) {
 void MarketMakerStrategy::loadConfig(const nlohmann::json& config) {
     symbol_ = config["strategy"]["symbol"].get<std::string>();
     config_ = MarketMakerConfig(config["strategy"]["config"]);
+    heuristic_model_ = HeuristicQuoteModel(config_.heuristicParams());
+    as_model_.setParams(config_.avellanedaStoikovParams());
+    
+    // Windows are allocated once; only resize when the configured length changes
+    size_t window = static_cast<size_t>(std::max(config_.volatility_window, 2));
+    if (spread_stats_.capacity() != window) {
+        price_volatility_ = RollingVolatility(window);
+        spread_stats_ = RollingStats(window);
+    }
+    speculative_quotes_.setTickSize(config_.tick_size);
 }
 
 std::string MarketMakerStrategy::generateClientOrderId() {
-    static int counter = 0;
-    return "MM_" + std::to_string(++counter) + "_" + std::to_string(
+    return "MM_" + std::to_string(++client_order_counter_) + "_" + std::to_string(
         std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count());
 }
@@ -395,77 +584,39 @@ std::string MarketMakerStrategy::generateClientOrderId() {
 // Enhanced market making methods
 double MarketMakerStrategy::calculateOptimalSpread() const {
     if (mid_price_ <= 0) return config_.base_spread_bps;
-    
-    // Base spread
-    double spread_bps = config_.base_spread_bps;
-    
-    // Adjust for volatility
-    if (current_volatility_ > 0) {
-        spread_bps += current_volatility_ * config_.volatility_multiplier * 10000; // Convert to bps
-    }
-    
-    // Adjust for inventory (wider spread if we have large position)
-    double inventory_factor = std::abs(current_position_) / config_.max_position;
-    spread_bps += inventory_factor * config_.base_spread_bps * 0.5;
-    
-    // Ensure within bounds
-    spread_bps = std::max(config_.min_spread_bps, std::min(config_.max_spread_bps, spread_bps));
-    
-    return spread_bps;
+    return heuristic_model_.spreadBps(current_volatility_, current_position_);
 }
 
 double MarketMakerStrategy::calculateInventorySkew() const {
-    if (config_.max_position <= 0) return 0.0;
-    
-    // Skew orders based on current position
-    // If long, skew towards selling (widen bid, tighten ask)
-    // If short, skew towards buying (tighten bid, widen ask)
-    double position_ratio = current_position_ / config_.max_position;
-    return position_ratio * config_.inventory_skew_factor;
+    return heuristic_model_.skewBps(current_position_);
 }
 
 double MarketMakerStrategy::calculateVolatility() const {
-    if (recent_prices_.size() < 10) return 0.0;
-    
-    // Calculate returns
-    std::vector<double> returns;
-    for (size_t i = 1; i < recent_prices_.size(); ++i) {
-        double ret = (recent_prices_[i] - recent_prices_[i-1]) / recent_prices_[i-1];
-        returns.push_back(ret);
-    }
-    
-    // Calculate standard deviation
-    double mean = 0.0;
-    for (double ret : returns) {
-        mean += ret;
-    }
-    mean /= returns.size();
-    
-    double variance = 0.0;
-    for (double ret : returns) {
-        variance += (ret - mean) * (ret - mean);
-    }
-    variance /= returns.size();
-    
-    return std::sqrt(variance);
+    // Need at least 10 prices (9 returns)
+    if (price_volatility_.samples() < 9) return 0.0;
+    return price_volatility_.volatility();
 }
 
 std::pair<double, double> MarketMakerStrategy::calculateOrderSizes() const {
+    return orderSizesFor(current_position_);
+}
+
+std::pair<double, double> MarketMakerStrategy::orderSizesFor(double position) const {
     double base_size = config_.order_size;
     
     // Reduce size if approaching position limits
-    double position_utilization = std::abs(current_position_) / config_.max_position;
+    double position_utilization = std::abs(position) / config_.max_position;
     double size_factor = std::max(0.1, 1.0 - position_utilization);
     
     double bid_size = base_size * size_factor;
     double ask_size = base_size * size_factor;
     
     // Further adjust based on inventory
-    if (current_position_ > 0) {
+    if (position > 0) {
         // Long position - prefer to sell
         ask_size *= 1.2;
         bid_size *= 0.8;
-    } else if (current_position_ < 0) {
+    } else if (position < 0) {
         // Short position - prefer to buy
         bid_size *= 1.2;
         ask_size *= 0.8;
@@ -474,6 +625,11 @@ std::pair<double, double> MarketMakerStrategy::calculateOrderSizes() const {
     return {bid_size, ask_size};
 }
 
+bool MarketMakerStrategy::requoteIntervalElapsed() const {
+    return std::chrono::system_clock::now() - last_quote_time_ >=
+        std::chrono::milliseconds(config_.min_requote_interval_ms);
+}
+
 bool MarketMakerStrategy::shouldRefreshOrders() const {
     auto now = std::chrono::system_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_quote_time_);
@@ -483,8 +639,8 @@ bool MarketMakerStrategy::shouldRefreshOrders() const {
         return true;
     }
     
-    // Price-based refresh (if market moved significantly)
-    if (mid_price_ > 0) {
+    // Price-based refresh (if market moved significantly), at most once per requote interval
+    if (mid_price_ > 0 && elapsed.count() >= config_.min_requote_interval_ms) {
         double expected_bid = mid_price_ - (mid_price_ * current_spread_bps_ / 20000.0);
         double expected_ask = mid_price_ + (mid_price_ * current_spread_bps_ / 20000.0);
         
@@ -531,12 +687,72 @@ void MarketMakerStrategy::updateMetrics() {
     total_pnl_ = realized_pnl_ + unrealized_pnl_;
     
     // Log strategy state periodically
-    static int log_counter = 0;
-    if (++log_counter % 50 == 0) { // Log every 50 updates
+    if (++metrics_updates_ % 50 == 0) { // Log every 50 updates
         logStrategyState();
     }
 }
 
+void MarketMakerStrategy::publishSnapshot(const OrderBook* order_book) {
+    auto snapshot = std::make_shared<MarketMakerSnapshot>();
+    snapshot->symbol = symbol_;
+    snapshot->position = current_position_;
+    snapshot->mid_price = mid_price_;
+    snapshot->best_bid = best_bid_;
+    snapshot->best_ask = best_ask_;
+    snapshot->bid_quote = current_bid_price_;
+    snapshot->ask_quote = current_ask_price_;
+    snapshot->spread_bps = current_spread_bps_;
+    snapshot->volatility = current_volatility_;
+    snapshot->total_pnl = total_pnl_;
+    snapshot->realized_pnl = realized_pnl_;
+    snapshot->unrealized_pnl = unrealized_pnl_;
+    snapshot->total_trades = total_trades_;
+    snapshot->active_orders = active_orders_.size();
+    snapshot->speculative_latency_ns = speculative_latency_ns_.mean();
+    snapshot->full_latency_ns = full_latency_ns_.mean();
+    
+    // Depth only changes with a book; keep the last levels otherwise
+    if (order_book) {
+        snapshot->bids = order_book->getTopBids(SNAPSHOT_LEVELS);
+        snapshot->asks = order_book->getTopAsks(SNAPSHOT_LEVELS);
+    } else if (auto previous = getMarketSnapshot()) {
+        snapshot->bids = previous->bids;
+        snapshot->asks = previous->asks;
+    }
+    
+    snapshot->timestamp = std::chrono::system_clock::now();
+    std::atomic_store(&snapshot_, std::shared_ptr<const MarketMakerSnapshot>(std::move(snapshot)));
+    last_snapshot_ = std::chrono::steady_clock::now();
+}
+
+std::shared_ptr<const MarketMakerSnapshot> MarketMakerStrategy::getMarketSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+nlohmann::json MarketMakerStrategy::getSnapshot() const {
+    auto snapshot = getMarketSnapshot();
+    if (!snapshot) return nlohmann::json::object();
+    return {
+        {"symbol", snapshot->symbol},
+        {"position", snapshot->position},
+        {"mid_price", snapshot->mid_price},
+        {"best_bid", snapshot->best_bid},
+        {"best_ask", snapshot->best_ask},
+        {"bid_quote", snapshot->bid_quote},
+        {"ask_quote", snapshot->ask_quote},
+        {"spread_bps", snapshot->spread_bps},
+        {"volatility", snapshot->volatility},
+        {"total_pnl", snapshot->total_pnl},
+        {"realized_pnl", snapshot->realized_pnl},
+        {"unrealized_pnl", snapshot->unrealized_pnl},
+        {"total_trades", snapshot->total_trades},
+        {"active_orders", snapshot->active_orders},
+        {"reaction_ns", {{"table", snapshot->speculative_latency_ns}, {"full", snapshot->full_latency_ns}}},
+        {"timestamp_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+            snapshot->timestamp.time_since_epoch()).count()}
+    };
+}
+
 void MarketMakerStrategy::logStrategyState() const {
     logger_->getLogger()->info("=== Market Maker State ===");
     logger_->getLogger()->info("Position: {} | PnL: {} (R: {}, U: {})", 
@@ -544,7 +760,13 @@ void MarketMakerStrategy::logStrategyState() const {
     logger_->getLogger()->info("Spread: {:.2f}bps | Volatility: {:.6f}", current_spread_bps_, current_volatility_);
     logger_->getLogger()->info("Active Orders: {} | Mid Price: {:.2f}", active_orders_.size(), mid_price_);
     logger_->getLogger()->info("Market: {:.2f} / {:.2f} (spread: {:.2f}bps)", 
-                             current_bid_price_, current_ask_price_, avg_spread_);
+                             current_bid_price_, current_ask_price_, spread_stats_.mean());
+    if (config_.speculative_quotes) {
+        logger_->getLogger()->info("Reaction: table {:.0f}ns (n={}, hits {} / misses {}) | full {:.0f}ns (n={})",
+                                 speculative_latency_ns_.mean(), speculative_latency_ns_.size(),
+                                 speculative_quotes_.hits(), speculative_quotes_.misses(),
+                                 full_latency_ns_.mean(), full_latency_ns_.size());
+    }
 }
 
 } // namespace moneybot 
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "moneybot.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -21,23 +22,103 @@ void TradingEngine::initializeComponents() {
     // Initialize core components
     logger_ = std::make_shared<Logger>();
     order_book_ = std::make_shared<OrderBook>(logger_);
-    network_ = std::make_shared<Network>(logger_, order_book_, config_);
+    // Market data is sharded over its own connections; the user data stream has one
+    io_runtime_ = std::make_shared<IoRuntime>(logger_, config_);
+    network_ = std::make_shared<Network>(logger_, order_book_, config_, io_runtime_->acquire("binance-user-data"));
     order_manager_ = std::make_shared<OrderManager>(logger_, config_);
     risk_manager_ = std::make_shared<RiskManager>(logger_, config_);
+    order_manager_->setRateLimiter(risk_manager_->getRateLimiter());
     network_->setOrderManager(order_manager_);
     
     // Initialize strategy based on config
     std::string strategy_type = config_["strategy"]["type"].get<std::string>();
+    Network::StreamHandler stream_handler;
+    std::vector<std::string> streams;
     if (strategy_type == "market_maker") {
-        strategy_ = std::make_shared<MarketMakerStrategy>(logger_, order_manager_, risk_manager_, config_);
+        // The strategy runs as an actor: all its events arrive in order on one thread
+        std::string symbol = config_["strategy"]["symbol"].get<std::string>();
+        market_maker_ = std::make_shared<MarketMakerStrategy>(logger_, order_manager_, risk_manager_, config_);
+        actor_ = std::make_shared<StrategyActor>(logger_);
+        actor_->setOrderManager(order_manager_);
+        actor_->addStrategy(SymbolRegistry::getInstance().getOrRegister(symbol), symbol, market_maker_);
+        strategy_ = actor_;
+        stream_handler = [actor = actor_](const std::string& stream, const nlohmann::json& data) {
+            uint32_t id = SymbolRegistry::getInstance().find(StrategyActor::streamSymbol(stream, data));
+            actor->postMarketData(id, StrategyActor::isTradeStream(stream), data);
+        };
+        streams = StrategyActor::streamNames(actor_->getSymbols());
+        network_->setUserDataHandler([actor = actor_, order_manager = order_manager_](const nlohmann::json& message) {
+            uint32_t id = SymbolRegistry::getInstance().find(message.value("s", ""));
+            if (id == SymbolRegistry::INVALID_ID) {
+                // Not a symbol the actor hosts; the account mirror still needs the report
+                order_manager->handleOrderUpdate(message);
+                return;
+            }
+            actor->postExecution(id, message);
+        });
     } else if (strategy_type == "multi_asset") {
-        // For multi-asset mode, use a dummy strategy for now
-        // In the future, this will create a Multi-Asset Strategy Manager
-        strategy_ = std::make_shared<MarketMakerStrategy>(logger_, order_manager_, risk_manager_, config_);
-        logger_->getLogger()->info("Multi-asset strategy mode initialized (using market maker for now)");
+        // One market maker per symbol, sharded across worker threads
+        multi_symbol_ = std::make_shared<MultiSymbolMarketMaker>(logger_, order_manager_, risk_manager_, config_);
+        strategy_ = multi_symbol_;
+        stream_handler = [host = multi_symbol_](const std::string& stream, const nlohmann::json& data) {
+            host->onStreamMessage(stream, data);
+        };
+        streams = StrategyActor::streamNames(multi_symbol_->getSymbols());
+        network_->setUserDataHandler([host = multi_symbol_](const nlohmann::json& message) {
+            host->onUserData(message);
+        });
+        logger_->getLogger()->info("Multi-asset strategy mode initialized ({} symbols)",
+                                  multi_symbol_->getSymbols().size());
     } else {
         throw std::runtime_error("Unknown strategy type: " + strategy_type);
     }
+    stream_manager_ = std::make_shared<StreamSubscriptionManager>(logger_, io_runtime_, config_, stream_handler);
+    stream_manager_->addStreams(streams);
+
+    // Venues from multi_asset.exchanges feed the consolidated book behind the depth view
+    nlohmann::json multi_asset = config_.value("multi_asset", nlohmann::json::object());
+    if (multi_asset.value("enabled", false)) {
+        std::vector<ExchangeConfig> exchanges;
+        for (const auto& entry : multi_asset.value("exchanges", nlohmann::json::array())) {
+            ExchangeConfig exchange;
+            exchange.name = entry.value("name", "");
+            exchange.rest_url = entry.value("rest_url", "");
+            exchange.ws_url = entry.value("ws_url", "");
+            exchange.api_key = entry.value("api_key", "");
+            exchange.secret_key = entry.value("secret_key", "");
+            exchange.passphrase = entry.value("passphrase", "");
+            exchange.taker_fee = entry.value("taker_fee", exchange.taker_fee);
+            exchange.maker_fee = entry.value("maker_fee", exchange.maker_fee);
+            exchange.enabled = entry.value("enabled", exchange.enabled);
+            exchange.max_connections = entry.value("max_connections", exchange.max_connections);
+            exchange.latency_threshold_ms = entry.value("latency_threshold_ms", exchange.latency_threshold_ms);
+            exchanges.push_back(exchange);
+        }
+        gateway_ = std::make_shared<MultiExchangeGateway>(exchanges, logger_);
+        gateway_->setIoRuntime(io_runtime_);
+        depth_symbol_ = config_["strategy"].value("symbol", "");
+        if (depth_symbol_.empty() && multi_symbol_ && !multi_symbol_->getSymbols().empty()) {
+            depth_symbol_ = multi_symbol_->getSymbols().front();
+        }
+    }
+
+    // Pair discovery reads the ticks the order book records and writes the ranked pairs
+    // where the statistical arbitrage strategy loads them
+    nlohmann::json stat_arb = config_.value("strategies", nlohmann::json::object())
+                                  .value("statistical_arbitrage", nlohmann::json::object());
+    nlohmann::json discovery = stat_arb.value("discovery", nlohmann::json::object());
+    if (stat_arb.value("enabled", false) && !discovery.empty() && discovery.value("enabled", true)) {
+        pair_discovery_ = std::make_unique<PairDiscoveryJob>(
+            PairDiscoveryParams(discovery), discovery.value("tick_db", "data/ticks.db"),
+            discovery.value("output", "data/discovered_pairs.json"),
+            std::chrono::minutes(std::max(1, discovery.value("interval_minutes", 60))), logger_);
+        pair_discovery_->setCallback([this](const PairDiscoveryReport& report) {
+            logger_->getLogger()->info("Pair discovery: {} of {} candidates cointegrated, {} ranked",
+                                      report.cointegrated, report.candidates, report.pairs.size());
+            std::lock_guard<std::mutex> lock(status_mutex_);
+            last_discovery_ = report.toJson();
+        });
+    }
     
     logger_->getLogger()->info("All components initialized");
 }
@@ -61,22 +142,24 @@ void TradingEngine::start() {
     // Start order manager
     order_manager_->start();
 
+    // Streams run on the I/O runtime's threads; starting them doesn't block
+    io_runtime_->start();
+    if (gateway_) gateway_->start();
+
     // Start user data stream for private events
     std::string listenKey = order_manager_->createUserDataStream();
     if (!listenKey.empty()) {
-        std::thread([this, listenKey]() {
-            network_->runUserDataStream(listenKey);
-        }).detach();
+        network_->runUserDataStream(listenKey);
     } else {
         logger_->getLogger()->error("Failed to start user data stream: listenKey is empty");
     }
 
-    // Start network thread
     running_.store(true);
-    network_thread_ = std::thread(&TradingEngine::networkThread, this);
+    startMarketDataStream();
+    if (pair_discovery_) pair_discovery_->start();
     
-    // Start strategy thread
-    strategy_thread_ = std::thread(&TradingEngine::strategyThread, this);
+    timers_.start();
+    scheduleStressTest();
     
     logger_->getLogger()->info("TradingEngine started successfully");
 }
@@ -90,7 +173,11 @@ void TradingEngine::stop() {
     
     running_.store(false);
     
+    // A scan in progress finishes before this returns
+    if (pair_discovery_) pair_discovery_->stop();
+    
     // Stop network
+    stream_manager_->stop();
     network_->stop();
     
     // Stop order manager
@@ -99,13 +186,10 @@ void TradingEngine::stop() {
     // Shutdown strategy
     strategy_->shutdown();
     
-    // Wait for threads to finish
-    if (network_thread_.joinable()) {
-        network_thread_.join();
-    }
-    if (strategy_thread_.joinable()) {
-        strategy_thread_.join();
-    }
+    // A stress run in progress finishes first
+    timers_.stop();
+    if (gateway_) gateway_->stop();
+    io_runtime_->stop();
     
     logger_->getLogger()->info("TradingEngine stopped");
 }
@@ -117,30 +201,31 @@ void TradingEngine::emergencyStop() {
     stop();
 }
 
-void TradingEngine::networkThread() {
+void TradingEngine::startMarketDataStream() {
     try {
-        network_->run(
-            config_["exchange"]["websocket_host"].get<std::string>(),
-            config_["exchange"]["websocket_port"].get<std::string>(),
-            config_["exchange"]["websocket_endpoint"].get<std::string>()
-        );
+        // Opens as many connections as the streams need and keeps them balanced
+        stream_manager_->start();
     } catch (const std::exception& e) {
-        logger_->getLogger()->error("Network thread error: {}", e.what());
+        logger_->getLogger()->error("Market data stream error: {}", e.what());
         emergencyStop();
     }
 }
 
-void TradingEngine::strategyThread() {
-    try {
-        while (running_.load() && !emergency_stop_.load()) {
-            // Strategy runs continuously, processing market data
-            // The actual strategy logic is handled in the event callbacks
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+void TradingEngine::scheduleStressTest() {
+    // Periodic stress revaluation for the risk report; strategy logic runs in the event callbacks
+    uint64_t interval_ms = std::max<int64_t>(
+        1, config_["risk"].value("stress", nlohmann::json::object()).value("interval_ms", 5000));
+    timers_.scheduleEvery(interval_ms, [this]() {
+        if (!running_.load() || emergency_stop_.load()) return;
+        try {
+            risk_manager_->runStressTest();
+        } catch (const std::exception& e) {
+            // stop() joins this thread, so only halt trading here
+            logger_->getLogger()->error("Stress test error: {}", e.what());
+            emergency_stop_.store(true);
+            risk_manager_->emergencyStop();
         }
-    } catch (const std::exception& e) {
-        logger_->getLogger()->error("Strategy thread error: {}", e.what());
-        emergencyStop();
-    }
+    });
 }
 
 void TradingEngine::onOrderBookUpdate(const OrderBook& order_book) {
@@ -157,6 +242,7 @@ void TradingEngine::onTrade(const Trade& trade) {
     if (emergency_stop_.load()) return;
     setLastEvent("Trade");
     try {
+        risk_manager_->onPrice(trade.symbol, trade.price);
         strategy_->onTrade(trade);
         total_trades_++;
     } catch (const std::exception& e) {
@@ -215,6 +301,18 @@ nlohmann::json TradingEngine::getStatus() const {
         std::chrono::system_clock::now() - start_time_).count();
     status["last_event"] = last_event_;
     status["ws_connected"] = ws_connected_;
+    if (io_runtime_) {
+        status["io"] = io_runtime_->toJson();
+    }
+    if (stream_manager_) {
+        status["streams"] = stream_manager_->getStatus();
+    }
+    if (network_) {
+        status["user_data"] = network_->getStats();
+    }
+    if (pair_discovery_) {
+        status["pair_discovery"] = {{"running", pair_discovery_->isRunning()}, {"last", last_discovery_}};
+    }
     
     // Risk status
     if (risk_manager_) {
@@ -225,9 +323,13 @@ nlohmann::json TradingEngine::getStatus() const {
     if (strategy_) {
         status["strategy"] = {
             {"name", strategy_->getName()},
-            {"active", running_.load()}
+            {"active", running_.load()},
+            {"state", strategy_->getSnapshot()}
         };
     }
+    if (multi_symbol_) {
+        status["shards"] = multi_symbol_->getStatus();
+    }
     
     return status;
 }
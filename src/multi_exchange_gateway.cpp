@@ -2,7 +2,6 @@
 #include "exchange_connectors.h"
 #include "config_manager.h"
 #include <algorithm>
-#include <thread>
 #include <chrono>
 #include <cmath>
 #include <set>
@@ -13,6 +12,9 @@ MultiExchangeGateway::MultiExchangeGateway(const std::vector<ExchangeConfig>& co
                                            std::shared_ptr<Logger> logger)
     : configs_(configs), logger_(logger) {
     
+    slot_tables_.push_back(std::make_unique<SlotTable>(64));
+    slot_table_.store(slot_tables_.back().get(), std::memory_order_release);
+    
     // Create connectors for each enabled exchange
     for (const auto& config : configs_) {
         if (config.enabled) {
@@ -44,9 +46,17 @@ void MultiExchangeGateway::start() {
     running_ = true;
     logInfo("Starting MultiExchangeGateway...");
     
+    if (!io_runtime_) {
+        io_runtime_ = std::make_shared<IoRuntime>(logger_, nlohmann::json::object());
+        owns_io_runtime_ = true;
+    }
+    io_runtime_->start();
+    
     // Connect to all exchanges
     for (auto& [exchange_name, connector] : connectors_) {
         try {
+            connector->setIoRuntime(io_runtime_);
+
             // Set up callbacks
             connector->setOrderBookCallback([this, exchange_name](const std::string& symbol, const OrderBook& book) {
                 onOrderBookUpdate(exchange_name, symbol, book);
@@ -65,33 +75,28 @@ void MultiExchangeGateway::start() {
         }
     }
     
-    // Start worker threads
-    worker_threads_.emplace_back([this]() {
-        while (running_) {
-            try {
-                scanArbitrageOpportunities();
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            } catch (const std::exception& e) {
-                logError("Error in arbitrage scanner: " + std::string(e.what()));
-            }
-        }
-    });
+    // Periodic work; arbitrage is detected per book update in onOrderBookUpdate
+    timers_.start();
+    {
+        std::lock_guard<std::mutex> lock(graph_wake_mutex_);
+        graph_stopping_ = false;
+    }
+    graph_thread_ = std::thread(&MultiExchangeGateway::graphLoop, this);
     
-    worker_threads_.emplace_back([this]() {
-        while (running_) {
-            try {
-                // Update balances every 30 seconds
-                for (const auto& [exchange_name, connector] : connectors_) {
-                    if (connector->isConnected()) {
-                        updateBalances(exchange_name);
-                    }
+    // Balances are pushed via onBalanceUpdate; reconcile against REST at start and every 30 seconds
+    auto reconcile_balances = [this]() {
+        try {
+            for (const auto& [exchange_name, connector] : connectors_) {
+                if (connector->isConnected()) {
+                    updateBalances(exchange_name);
                 }
-                std::this_thread::sleep_for(std::chrono::seconds(30));
-            } catch (const std::exception& e) {
-                logError("Error updating balances: " + std::string(e.what()));
             }
+        } catch (const std::exception& e) {
+            logError("Error updating balances: " + std::string(e.what()));
         }
-    });
+    };
+    timers_.schedule(0, reconcile_balances);
+    timers_.scheduleEvery(30000, reconcile_balances);
     
     logInfo("MultiExchangeGateway started successfully");
 }
@@ -102,13 +107,8 @@ void MultiExchangeGateway::stop() {
     logInfo("Stopping MultiExchangeGateway...");
     running_ = false;
     
-    // Wait for worker threads
-    for (auto& thread : worker_threads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
-    }
-    worker_threads_.clear();
+    // Stop periodic work
+    timers_.stop();
     
     // Disconnect from all exchanges
     for (auto& [exchange_name, connector] : connectors_) {
@@ -120,6 +120,21 @@ void MultiExchangeGateway::stop() {
         }
     }
     
+    // Quotes still queued for the graph are applied on the next start
+    {
+        std::lock_guard<std::mutex> lock(graph_wake_mutex_);
+        graph_stopping_ = true;
+    }
+    graph_wake_cv_.notify_one();
+    if (graph_thread_.joinable()) {
+        graph_thread_.join();
+    }
+    
+    // A runtime handed in by the owner may still run other connections
+    if (owns_io_runtime_) {
+        io_runtime_->stop();
+    }
+    
     logInfo("MultiExchangeGateway stopped");
 }
 
@@ -146,15 +161,52 @@ std::vector<std::string> MultiExchangeGateway::getAllExchanges() const {
     return exchanges;
 }
 
+void MultiExchangeGateway::setConnector(const std::string& exchange, std::unique_ptr<ExchangeConnector> connector) {
+    if (running_) {
+        logError("Cannot replace the connector for " + exchange + " while running");
+        return;
+    }
+    connectors_[exchange] = std::move(connector);
+}
+
+void MultiExchangeGateway::setIoRuntime(std::shared_ptr<IoRuntime> runtime) {
+    if (running_) {
+        logError("Cannot replace the I/O runtime while running");
+        return;
+    }
+    io_runtime_ = std::move(runtime);
+    owns_io_runtime_ = false;
+}
+
 CrossExchangeOrderBook MultiExchangeGateway::getAggregatedOrderBook(const std::string& symbol) const {
-    std::lock_guard<std::mutex> lock(books_mutex_);
-    auto it = aggregated_books_.find(symbol);
-    if (it != aggregated_books_.end()) {
-        return it->second;
+    auto snapshot = getAggregatedOrderBookSnapshot(symbol);
+    if (snapshot) {
+        return *snapshot;
     }
     return CrossExchangeOrderBook{symbol};
 }
 
+std::shared_ptr<const CrossExchangeOrderBook> MultiExchangeGateway::getAggregatedOrderBookSnapshot(const std::string& symbol) const {
+    SymbolSlot* slot = findSlot(symbol);
+    return slot ? std::atomic_load_explicit(&slot->snapshot, std::memory_order_acquire) : nullptr;
+}
+
+std::shared_ptr<const ConsolidatedBook> MultiExchangeGateway::getConsolidatedBook(const std::string& symbol) const {
+    auto snapshot = getAggregatedOrderBookSnapshot(symbol);
+    return snapshot ? snapshot->consolidated : nullptr;
+}
+
+std::unordered_map<std::string, CrossExchangeOrderBook> MultiExchangeGateway::getAllAggregatedBooks() const {
+    std::unordered_map<std::string, CrossExchangeOrderBook> books;
+    forEachSlot([&books](const SymbolSlot& slot) {
+        auto snapshot = std::atomic_load_explicit(&slot.snapshot, std::memory_order_acquire);
+        if (snapshot) {
+            books.emplace(slot.symbol, *snapshot);
+        }
+    });
+    return books;
+}
+
 std::vector<std::string> MultiExchangeGateway::getAvailableSymbols() const {
     std::set<std::string> unique_symbols;
     
@@ -196,6 +248,59 @@ bool MultiExchangeGateway::cancelOrder(const std::string& exchange, const std::s
     return it->second->cancelOrder(order_id);
 }
 
+RouteReport MultiExchangeGateway::routeOrder(const Order& parent, const RouteParams& params) {
+    auto book = getConsolidatedBook(parent.symbol);
+    if (!book) {
+        throw std::runtime_error("No consolidated book for " + parent.symbol);
+    }
+
+    // Buys spend the quote asset, sells the base; an unsplittable symbol isn't capped.
+    // splitSymbol only reads the graph's immutable parameters, so no graph_mutex_.
+    std::string base, quote;
+    bool split = currency_graph_.splitSymbol(parent.symbol, base, quote);
+    const std::string& spent = parent.side == OrderSide::BUY ? quote : base;
+
+    std::vector<RouteVenue> venues(book->venueCount());
+    for (size_t v = 0; v < venues.size(); ++v) {
+        const std::string& exchange = (*book->venues)[v].exchange;
+        venues[v].enabled = isExchangeConnected(exchange);
+        venues[v].latency_ms = getExchangeLatency(exchange);
+    }
+    if (split) {
+        // Only a balance the venue has reported caps it; an asset we haven't seen stays
+        // uncapped and the venue rejects what it can't fund
+        std::lock_guard<std::mutex> lock(balances_mutex_);
+        for (size_t v = 0; v < venues.size(); ++v) {
+            auto exchange_it = balances_.find((*book->venues)[v].exchange);
+            if (exchange_it == balances_.end()) continue;
+            auto asset_it = exchange_it->second.find(spent);
+            if (asset_it != exchange_it->second.end()) venues[v].available = asset_it->second.available;
+        }
+    }
+
+    SmartOrderRouter router([this](const std::string& exchange, const Order& child) {
+        auto it = connectors_.find(exchange);
+        if (it == connectors_.end() || !it->second->isConnected()) {
+            throw std::runtime_error("Exchange not connected: " + exchange);
+        }
+        return it->second->executeOrder(child);
+    }, params);
+    RouteReport report = router.route(parent, *book, venues);
+
+    for (const auto& child : report.children) {
+        if (child.error.empty()) {
+            updateLatency(child.exchange, child.latency_ms);
+        } else {
+            logError("Child order on " + child.exchange + " failed: " + child.error);
+        }
+    }
+    logInfo("Routed " + parent.symbol + " " + std::to_string(report.plan.routed) + "/" +
+            std::to_string(parent.quantity) + " over " + std::to_string(report.children.size()) +
+            " venues, filled " + std::to_string(report.filled_quantity) + ", slippage " +
+            std::to_string(report.slippage_bps) + " bps vs arrival mid");
+    return report;
+}
+
 ExchangeBalance MultiExchangeGateway::getBalance(const std::string& exchange, const std::string& asset) const {
     std::lock_guard<std::mutex> lock(balances_mutex_);
     auto exchange_it = balances_.find(exchange);
@@ -224,53 +329,21 @@ double MultiExchangeGateway::getTotalBalance(const std::string& asset) const {
 
 std::vector<ArbitrageOpportunity> MultiExchangeGateway::findArbitrageOpportunities(double min_profit_bps) const {
     std::vector<ArbitrageOpportunity> opportunities;
-    std::lock_guard<std::mutex> lock(books_mutex_);
-    
-    for (const auto& [symbol, aggregated_book] : aggregated_books_) {
-        if (aggregated_book.exchange_books.size() < 2) continue;
-        
-        // Find best bid and ask across exchanges
-        double best_bid = 0.0;
-        double best_ask = std::numeric_limits<double>::max();
-        std::string best_bid_exchange, best_ask_exchange;
-        
-        for (const auto& [exchange_name, book_ptr] : aggregated_book.exchange_books) {
-            if (!isExchangeConnected(exchange_name) || !book_ptr) continue;
-            
-            double bid = book_ptr->getBestBid();
-            double ask = book_ptr->getBestAsk();
-            
-            if (bid > best_bid) {
-                best_bid = bid;
-                best_bid_exchange = exchange_name;
-            }
-            
-            if (ask < best_ask && ask > 0) {
-                best_ask = ask;
-                best_ask_exchange = exchange_name;
-            }
-        }
-        
-        // Calculate arbitrage opportunity
-        if (best_bid > 0 && best_ask > 0 && best_bid_exchange != best_ask_exchange) {
-            double profit_bps = ((best_bid - best_ask) / best_ask) * 10000.0;
-            
-            if (profit_bps >= min_profit_bps) {
-                ArbitrageOpportunity opp;
-                opp.symbol = symbol;
-                opp.buy_exchange = best_ask_exchange;
-                opp.sell_exchange = best_bid_exchange;
-                opp.buy_price = best_ask;
-                opp.sell_price = best_bid;
-                opp.profit_bps = profit_bps;
-                opp.max_size = calculateMaxArbitrageSize(opp);
-                opp.profit_usd = opp.max_size * (best_bid - best_ask);
-                opp.confidence_score = calculateConfidenceScore(opp);
-                opp.timestamp = std::chrono::steady_clock::now();
-                
-                opportunities.push_back(opp);
+    {
+        forEachSlot([&](SymbolSlot& slot) {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            VenueCross cross = slot.ranking.bestCross([this](const VenueQuote& venue) { return isUsableVenue(venue); });
+            if (!cross.crossed || cross.profit_bps < min_profit_bps) return;
+            ArbitrageSize sized = sizeCross(slot, cross);
+            if (sized.size > 0.0) {
+                opportunities.push_back(makeOpportunity(slot, cross, sized));
             }
-        }
+        });
+    }
+    
+    // Confidence reads the latency metrics; score outside the slot locks
+    for (auto& opp : opportunities) {
+        opp.confidence_score = calculateConfidenceScore(opp);
     }
     
     // Sort by profit potential
@@ -282,6 +355,38 @@ std::vector<ArbitrageOpportunity> MultiExchangeGateway::findArbitrageOpportuniti
     return opportunities;
 }
 
+std::vector<ArbitrageCycle> MultiExchangeGateway::findArbitrageCycles() const {
+    std::lock_guard<std::mutex> lock(graph_mutex_);
+    return currency_graph_.activeCycles();
+}
+
+std::vector<ArbitrageOpportunity> MultiExchangeGateway::findTriangularArbitrage(const std::string& base_asset) const {
+    std::vector<ArbitrageOpportunity> opportunities;
+    for (auto& cycle : findArbitrageCycles()) {
+        if (!cycle.startFrom(base_asset)) continue;
+        bool usable = std::all_of(cycle.legs.begin(), cycle.legs.end(),
+                                  [this](const CycleLeg& leg) { return isExchangeConnected(leg.exchange); });
+        if (!usable) continue;
+        
+        ArbitrageOpportunity opp;
+        opp.symbol = base_asset;
+        for (const auto& leg : cycle.legs) {
+            opp.symbol += "->" + leg.to_asset;
+        }
+        opp.buy_exchange = cycle.legs.front().exchange;
+        opp.sell_exchange = cycle.legs.back().exchange;
+        opp.buy_price = cycle.legs.front().price;
+        opp.sell_price = cycle.legs.back().price;
+        opp.profit_bps = cycle.profitBps();
+        opp.max_size = cycle.max_start_amount;
+        opp.profit_usd = cycle.max_start_amount * cycle.gross_return;
+        opp.timestamp = cycle.detected;
+        opp.confidence_score = calculateConfidenceScore(opp);
+        opportunities.push_back(std::move(opp));
+    }
+    return opportunities;
+}
+
 double MultiExchangeGateway::getBestPrice(const std::string& symbol, bool is_bid) const {
     auto aggregated_book = getAggregatedOrderBook(symbol);
     return is_bid ? aggregated_book.best_bid_price : aggregated_book.best_ask_price;
@@ -290,43 +395,49 @@ double MultiExchangeGateway::getBestPrice(const std::string& symbol, bool is_bid
 nlohmann::json MultiExchangeGateway::getPerformanceMetrics() const {
     nlohmann::json metrics;
     
-    std::lock_guard<std::mutex> metrics_lock(metrics_mutex_);
-    
     // Exchange connectivity
     metrics["exchanges"]["total"] = connectors_.size();
     metrics["exchanges"]["connected"] = getConnectedExchanges().size();
     
     // Latency metrics
-    nlohmann::json latencies;
-    double total_latency = 0.0;
-    int connected_count = 0;
-    
-    for (const auto& [exchange_name, latency] : exchange_latencies_) {
-        latencies[exchange_name] = latency;
-        if (isExchangeConnected(exchange_name)) {
-            total_latency += latency;
-            connected_count++;
+    {
+        std::lock_guard<std::mutex> metrics_lock(metrics_mutex_);
+        nlohmann::json latencies;
+        double total_latency = 0.0;
+        int connected_count = 0;
+        
+        for (const auto& [exchange_name, latency] : exchange_latencies_) {
+            latencies[exchange_name] = latency;
+            if (isExchangeConnected(exchange_name)) {
+                total_latency += latency;
+                connected_count++;
+            }
         }
+        
+        metrics["latency"]["per_exchange"] = latencies;
+        metrics["latency"]["average"] = connected_count > 0 ? total_latency / connected_count : 0.0;
     }
     
-    metrics["latency"]["per_exchange"] = latencies;
-    metrics["latency"]["average"] = connected_count > 0 ? total_latency / connected_count : 0.0;
-    
     // Market data
-    std::lock_guard<std::mutex> books_lock(books_mutex_);
-    metrics["market_data"]["symbols_tracked"] = aggregated_books_.size();
-    
-    nlohmann::json symbol_stats;
-    for (const auto& [symbol, book] : aggregated_books_) {
-        symbol_stats[symbol]["exchanges"] = book.exchange_books.size();
-        symbol_stats[symbol]["spread"] = book.best_ask_price > 0 && book.best_bid_price > 0 ? 
-                                        book.best_ask_price - book.best_bid_price : 0.0;
-        symbol_stats[symbol]["last_update"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-            book.last_update.time_since_epoch()).count();
-    }
-    metrics["market_data"]["symbols"] = symbol_stats;
-    
-    // Arbitrage opportunities
+    {
+        size_t symbols_tracked = 0;
+        nlohmann::json symbol_stats;
+        forEachSlot([&](const SymbolSlot& slot) {
+            auto book = std::atomic_load_explicit(&slot.snapshot, std::memory_order_acquire);
+            if (!book) return;
+            ++symbols_tracked;
+            auto& stats = symbol_stats[slot.symbol];
+            stats["exchanges"] = book->exchange_books ? book->exchange_books->size() : 0;
+            stats["spread"] = book->best_ask_price > 0 && book->best_bid_price > 0 ? 
+                              book->best_ask_price - book->best_bid_price : 0.0;
+            stats["last_update"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                book->last_update.time_since_epoch()).count();
+        });
+        metrics["market_data"]["symbols_tracked"] = symbols_tracked;
+        metrics["market_data"]["symbols"] = symbol_stats;
+    }
+    
+    // Arbitrage opportunities (takes the slot and metrics locks itself)
     auto opportunities = findArbitrageOpportunities(10.0);
     metrics["arbitrage"]["opportunities_count"] = opportunities.size();
     metrics["arbitrage"]["total_profit_potential"] = 0.0;
@@ -356,32 +467,132 @@ nlohmann::json MultiExchangeGateway::getStatus() const {
         }
     }
     
-    status["market_data"]["aggregated_symbols"] = aggregated_books_.size();
-    status["worker_threads"] = worker_threads_.size();
+    size_t aggregated_symbols = 0;
+    forEachSlot([&aggregated_symbols](const SymbolSlot&) { ++aggregated_symbols; });
+    status["market_data"]["aggregated_symbols"] = aggregated_symbols;
+    status["timers"] = timers_.size();
+    status["arbitrage_signals"] = arbitrage_signals_.load();
+    status["arbitrage_cycles"] = cycle_signals_.load();
+    if (io_runtime_) {
+        status["io"] = io_runtime_->toJson();
+    }
     
     return status;
 }
 
+void MultiExchangeGateway::setOrderBookUpdateCallback(std::function<void(const std::string&, const std::string&, const OrderBook&)> callback) {
+    orderbook_callback_ = std::move(callback);
+}
+
+void MultiExchangeGateway::setTradeCallback(std::function<void(const std::string&, const Trade&)> callback) {
+    trade_callback_ = std::move(callback);
+}
+
+void MultiExchangeGateway::setArbitrageCallback(std::function<void(const ArbitrageOpportunity&)> callback) {
+    arbitrage_callback_ = std::move(callback);
+}
+
+void MultiExchangeGateway::setArbitrageCycleCallback(std::function<void(const ArbitrageCycle&)> callback) {
+    cycle_callback_ = std::move(callback);
+}
+
 // Private methods implementation
 
 void MultiExchangeGateway::onOrderBookUpdate(const std::string& exchange, const std::string& symbol, const OrderBook& book) {
+    bool signal = false;
+    bool queue_graph = false;
+    ArbitrageOpportunity opportunity;
+    double taker_fee = 0.0;
+    SymbolSlot& slot = slotFor(symbol);
     {
-        std::lock_guard<std::mutex> lock(books_mutex_);
-        auto& aggregated_book = aggregated_books_[symbol];
-        aggregated_book.symbol = symbol;
+        // Only writers of this symbol contend here; readers use the published snapshot
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        auto& aggregated_book = slot.book;
         
         // Create a copy of the order book - we need to handle the logger requirement
-        if (aggregated_book.exchange_books.find(exchange) == aggregated_book.exchange_books.end()) {
-            aggregated_book.exchange_books[exchange] = std::make_shared<OrderBook>(logger_);
+        if (!aggregated_book.exchange_books || aggregated_book.exchange_books->count(exchange) == 0) {
+            // Copy-on-write: snapshots already handed out keep the old map
+            auto books = aggregated_book.exchange_books ? std::make_shared<ExchangeBookMap>(*aggregated_book.exchange_books)
+                                                        : std::make_shared<ExchangeBookMap>();
+            (*books)[exchange] = std::make_shared<OrderBook>(logger_);
+            aggregated_book.exchange_books = std::move(books);
         }
         
         // Copy the order book data (we'll need to add a copy method or assignment operator)
         // For now, we'll store a reference to the original book
         // TODO: Implement proper deep copy of OrderBook
         
-        aggregated_book.last_update = std::chrono::steady_clock::now();
+        // Re-rank this venue's top of book; only the changed symbol is checked for a cross
+        auto now = std::chrono::steady_clock::now();
+        auto& ranking = slot.ranking;
+        uint32_t venue = ranking.update(exchange, book.getBestBid(), book.getBestBidSize(),
+                                        book.getBestAsk(), book.getBestAskSize(), now);
+        aggregated_book.last_update = now;
         
-        updateAggregatedBook(symbol);
+        // Merge this venue's new ladders into the consolidated book (only changed prices move)
+        auto& consolidated = slot.consolidated;
+        if (venue == consolidated.venueCount() &&
+            consolidated.addVenue(exchange, takerFee(exchange)) == ConsolidatedBookBuilder::NO_VENUE &&
+            !slot.venue_cap_logged) {
+            slot.venue_cap_logged = true;
+            logWarning("Consolidated book for " + symbol + " is full (" +
+                       std::to_string(ConsolidatedLevel::MAX_VENUES) + " venues); " + exchange +
+                       " and later venues are left out of its depth");
+        }
+        if (venue < consolidated.venueCount()) {
+            BookLadder bids, asks;
+            bids.depth = book.copyTopBids(bids.price.data(), bids.size.data(), BookLadder::MAX_LEVELS);
+            asks.depth = book.copyTopAsks(asks.price.data(), asks.size.data(), BookLadder::MAX_LEVELS);
+            consolidated.update(venue, bids, asks);
+            taker_fee = consolidated.takerFee(venue);
+        } else {
+            taker_fee = takerFee(exchange);
+        }
+        aggregated_book.consolidated = consolidated.publish();
+        
+        // Park the top of book for the graph worker; only the newest per venue is kept
+        auto pending = std::find_if(slot.graph_pending.begin(), slot.graph_pending.end(),
+                                    [&exchange](const GraphQuote& quote) { return quote.exchange == exchange; });
+        if (pending == slot.graph_pending.end()) {
+            pending = slot.graph_pending.insert(slot.graph_pending.end(), GraphQuote{exchange});
+        }
+        pending->taker_fee = taker_fee;
+        pending->bid_price = book.getBestBid();
+        pending->bid_size = book.getBestBidSize();
+        pending->ask_price = book.getBestAsk();
+        pending->ask_size = book.getBestAskSize();
+        queue_graph = !slot.graph_queued.exchange(true, std::memory_order_acq_rel);
+        
+        updateAggregatedBook(slot);
+        std::atomic_store_explicit(&slot.snapshot,
+                                   std::make_shared<const CrossExchangeOrderBook>(aggregated_book),
+                                   std::memory_order_release);
+        
+        VenueCross cross = ranking.bestCross([this](const VenueQuote& venue) { return isUsableVenue(venue); });
+        // A touch cross that no level pair clears after fees isn't signalled
+        ArbitrageSize sized;
+        if (cross.crossed && cross.profit_bps >= arbitrage_min_profit_bps_) {
+            sized = sizeCross(slot, cross);
+        }
+        if (sized.size <= 0.0) {
+            ranking.last_signal = VenueCross{};
+        } else if (!cross.sameAs(ranking.last_signal)) {
+            // Signal each distinct cross once, not on every update while it persists
+            ranking.last_signal = cross;
+            opportunity = makeOpportunity(slot, cross, sized);
+            signal = true;
+        }
+    }
+    
+    if (signal && arbitrage_callback_) {
+        opportunity.confidence_score = calculateConfidenceScore(opportunity);
+        ++arbitrage_signals_;
+        arbitrage_callback_(opportunity);
+    }
+    
+    // Multi-leg cycles are searched on the graph worker
+    if (queue_graph) {
+        queueGraphUpdate(slot);
     }
     
     // Call user callback if set
@@ -390,6 +601,61 @@ void MultiExchangeGateway::onOrderBookUpdate(const std::string& exchange, const
     }
 }
 
+void MultiExchangeGateway::queueGraphUpdate(SymbolSlot& slot) {
+    SymbolSlot* head = graph_dirty_.load(std::memory_order_relaxed);
+    do {
+        slot.graph_next = head;
+    } while (!graph_dirty_.compare_exchange_weak(head, &slot, std::memory_order_release, std::memory_order_relaxed));
+    
+    // The worker only sleeps on an empty stack, so only the push that ends that needs to wake it
+    if (!head) {
+        { std::lock_guard<std::mutex> lock(graph_wake_mutex_); }
+        graph_wake_cv_.notify_one();
+    }
+}
+
+void MultiExchangeGateway::graphLoop() {
+    std::vector<GraphQuote> quotes;
+    std::vector<ArbitrageCycle> cycles;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(graph_wake_mutex_);
+            graph_wake_cv_.wait(lock, [this] {
+                return graph_stopping_ || graph_dirty_.load(std::memory_order_acquire) != nullptr;
+            });
+            if (graph_stopping_) return;
+        }
+        
+        // Only what the ticks moved is searched; symbols come off in any order
+        SymbolSlot* slot = graph_dirty_.exchange(nullptr, std::memory_order_acquire);
+        while (slot) {
+            SymbolSlot* next = slot->graph_next;
+            {
+                std::lock_guard<std::mutex> lock(slot->mutex);
+                quotes.swap(slot->graph_pending);
+                slot->graph_queued.store(false, std::memory_order_release);
+            }
+            {
+                std::lock_guard<std::mutex> lock(graph_mutex_);
+                for (const auto& quote : quotes) {
+                    currency_graph_.update(quote.exchange, slot->symbol, quote.taker_fee, quote.bid_price,
+                                           quote.bid_size, quote.ask_price, quote.ask_size, cycles);
+                }
+            }
+            quotes.clear();
+            slot = next;
+        }
+        
+        for (const auto& cycle : cycles) {
+            ++cycle_signals_;
+            if (cycle_callback_) {
+                cycle_callback_(cycle);
+            }
+        }
+        cycles.clear();
+    }
+}
+
 void MultiExchangeGateway::onTradeUpdate(const std::string& exchange, const Trade& trade) {
     // Log trade update
     logInfo("Trade update from " + exchange + ": " + trade.symbol + " " + 
@@ -401,68 +667,147 @@ void MultiExchangeGateway::onTradeUpdate(const std::string& exchange, const Trad
     }
 }
 
-void MultiExchangeGateway::updateAggregatedBook(const std::string& symbol) {
-    auto& aggregated_book = aggregated_books_[symbol];
+MultiExchangeGateway::SlotTable::SlotTable(size_t capacity)
+    : mask(capacity - 1), entries(new std::atomic<SymbolSlot*>[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) {
+        entries[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+MultiExchangeGateway::SymbolSlot* MultiExchangeGateway::findSlot(const std::string& symbol) const {
+    const SlotTable* table = slot_table_.load(std::memory_order_acquire);
+    size_t index = std::hash<std::string>{}(symbol) & table->mask;
+    while (SymbolSlot* slot = table->entries[index].load(std::memory_order_acquire)) {
+        if (slot->symbol == symbol) return slot;
+        index = (index + 1) & table->mask;
+    }
+    return nullptr;
+}
+
+MultiExchangeGateway::SymbolSlot& MultiExchangeGateway::slotFor(const std::string& symbol) {
+    if (SymbolSlot* slot = findSlot(symbol)) return *slot;
     
-    double best_bid = 0.0;
-    double best_ask = std::numeric_limits<double>::max();
-    std::string best_bid_exchange, best_ask_exchange;
-    double best_bid_size = 0.0, best_ask_size = 0.0;
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    if (SymbolSlot* slot = findSlot(symbol)) return *slot;  // Raced with another creator
     
-    for (const auto& [exchange_name, book_ptr] : aggregated_book.exchange_books) {
-        if (!isExchangeConnected(exchange_name) || !book_ptr) continue;
-        
-        double bid = book_ptr->getBestBid();
-        double ask = book_ptr->getBestAsk();
-        
-        if (bid > best_bid) {
-            best_bid = bid;
-            best_bid_exchange = exchange_name;
-            best_bid_size = book_ptr->getBestBidSize();
+    auto created = std::make_unique<SymbolSlot>();
+    created->symbol = symbol;
+    created->book.symbol = symbol;
+    created->consolidated = ConsolidatedBookBuilder(symbol);
+    SymbolSlot* slot = created.get();
+    slots_.push_back(std::move(created));
+    
+    auto insert = [](SlotTable& table, SymbolSlot* entry) {
+        size_t index = std::hash<std::string>{}(entry->symbol) & table.mask;
+        while (table.entries[index].load(std::memory_order_relaxed)) {
+            index = (index + 1) & table.mask;
         }
-        
-        if (ask < best_ask && ask > 0) {
-            best_ask = ask;
-            best_ask_exchange = exchange_name;
-            best_ask_size = book_ptr->getBestAskSize();
+        table.entries[index].store(entry, std::memory_order_release);
+    };
+    
+    SlotTable* table = slot_table_.load(std::memory_order_relaxed);
+    if (slots_.size() * 2 > table->mask + 1) {
+        // Grow: fill a fresh table, then publish it; readers still probing the old one finish there
+        auto grown = std::make_unique<SlotTable>((table->mask + 1) * 2);
+        for (const auto& entry : slots_) {
+            insert(*grown, entry.get());
         }
+        slot_table_.store(grown.get(), std::memory_order_release);
+        slot_tables_.push_back(std::move(grown));
+    } else {
+        insert(*table, slot);
     }
-    
-    aggregated_book.best_bid_price = best_bid;
-    aggregated_book.best_ask_price = best_ask == std::numeric_limits<double>::max() ? 0.0 : best_ask;
-    aggregated_book.best_bid_exchange = best_bid_exchange;
-    aggregated_book.best_ask_exchange = best_ask_exchange;
-    aggregated_book.best_bid_size = best_bid_size;
-    aggregated_book.best_ask_size = best_ask_size;
+    return *slot;
 }
 
-void MultiExchangeGateway::scanArbitrageOpportunities() {
-    auto opportunities = findArbitrageOpportunities(15.0); // Scan for 15+ bps opportunities
-    
-    for (const auto& opp : opportunities) {
-        if (arbitrage_callback_) {
-            arbitrage_callback_(opp);
+template <typename Fn>
+void MultiExchangeGateway::forEachSlot(Fn fn) const {
+    const SlotTable* table = slot_table_.load(std::memory_order_acquire);
+    for (size_t i = 0; i <= table->mask; ++i) {
+        if (SymbolSlot* slot = table->entries[i].load(std::memory_order_acquire)) {
+            fn(*slot);
         }
     }
 }
 
-double MultiExchangeGateway::calculateMaxArbitrageSize(const ArbitrageOpportunity& opp) const {
-    // Get order book depths
-    auto aggregated_book = getAggregatedOrderBook(opp.symbol);
-    
-    auto buy_book_it = aggregated_book.exchange_books.find(opp.buy_exchange);
-    auto sell_book_it = aggregated_book.exchange_books.find(opp.sell_exchange);
-    
-    if (buy_book_it == aggregated_book.exchange_books.end() || 
-        sell_book_it == aggregated_book.exchange_books.end() ||
-        !buy_book_it->second || !sell_book_it->second) {
-        return 0.0;
+void MultiExchangeGateway::updateAggregatedBook(SymbolSlot& slot) {
+    auto& aggregated_book = slot.book;
+    const auto& ranking = slot.ranking;
+    
+    // Best connected venue on each side: the first usable entry of each ranking
+    const VenueQuote* best_bid = nullptr;
+    const VenueQuote* best_ask = nullptr;
+    for (uint32_t index : ranking.bidOrder()) {
+        const VenueQuote& venue = ranking.venue(index);
+        if (venue.bid_price <= 0.0) break;
+        if (isUsableVenue(venue)) { best_bid = &venue; break; }
+    }
+    for (uint32_t index : ranking.askOrder()) {
+        const VenueQuote& venue = ranking.venue(index);
+        if (venue.ask_price <= 0.0) break;
+        if (isUsableVenue(venue)) { best_ask = &venue; break; }
+    }
+    
+    aggregated_book.best_bid_price = best_bid ? best_bid->bid_price : 0.0;
+    aggregated_book.best_ask_price = best_ask ? best_ask->ask_price : 0.0;
+    aggregated_book.best_bid_exchange = best_bid ? best_bid->exchange : std::string();
+    aggregated_book.best_ask_exchange = best_ask ? best_ask->exchange : std::string();
+    aggregated_book.best_bid_size = best_bid ? best_bid->bid_size : 0.0;
+    aggregated_book.best_ask_size = best_ask ? best_ask->ask_size : 0.0;
+}
+
+double MultiExchangeGateway::takerFee(const std::string& exchange) const {
+    for (const auto& config : configs_) {
+        if (config.name == exchange) return config.taker_fee;
     }
-    
-    double buy_size = buy_book_it->second->getBestAskSize();
-    double sell_size = sell_book_it->second->getBestBidSize();
-    
-    return std::min(buy_size, sell_size);
+    return ExchangeConfig{}.taker_fee;
+}
+
+ArbitrageSize MultiExchangeGateway::sizeCross(const SymbolSlot& slot, const VenueCross& cross) const {
+    const auto& consolidated = slot.consolidated;
+    if (cross.buy_venue >= consolidated.venueCount() || cross.sell_venue >= consolidated.venueCount()) {
+        return ArbitrageSize{};
+    }
+    return sizeArbitrage(consolidated.venueAsks(cross.buy_venue), consolidated.takerFee(cross.buy_venue),
+                         consolidated.venueBids(cross.sell_venue), consolidated.takerFee(cross.sell_venue));
+}
+
+double MultiExchangeGateway::calculateArbitrageProfit(const std::string& symbol, const std::string& buy_exchange,
+                                                      const std::string& sell_exchange) const {
+    SymbolSlot* slot = findSlot(symbol);
+    if (!slot) return 0.0;
+    
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    VenueCross cross;
+    bool found_buy = false, found_sell = false;
+    for (uint32_t i = 0; i < slot->ranking.size(); ++i) {
+        const std::string& name = slot->ranking.venue(i).exchange;
+        if (name == buy_exchange) { cross.buy_venue = i; found_buy = true; }
+        if (name == sell_exchange) { cross.sell_venue = i; found_sell = true; }
+    }
+    if (!found_buy || !found_sell || cross.buy_venue == cross.sell_venue) return 0.0;
+    return sizeCross(*slot, cross).profit;
+}
+
+ArbitrageOpportunity MultiExchangeGateway::makeOpportunity(const SymbolSlot& slot, const VenueCross& cross,
+                                                           const ArbitrageSize& sized) const {
+    const VenueQuote& buy = slot.ranking.venue(cross.buy_venue);
+    const VenueQuote& sell = slot.ranking.venue(cross.sell_venue);
+    
+    ArbitrageOpportunity opp;
+    opp.symbol = slot.symbol;
+    opp.buy_exchange = buy.exchange;
+    opp.sell_exchange = sell.exchange;
+    opp.buy_price = cross.buy_price;
+    opp.sell_price = cross.sell_price;
+    opp.profit_bps = cross.profit_bps;
+    opp.max_size = sized.size;
+    opp.profit_usd = sized.profit;
+    opp.buy_vwap = sized.buy_vwap;
+    opp.sell_vwap = sized.sell_vwap;
+    opp.confidence_score = 0.0;
+    opp.timestamp = std::chrono::steady_clock::now();
+    return opp;
 }
 
 double MultiExchangeGateway::calculateConfidenceScore(const ArbitrageOpportunity& opp) const {
@@ -498,10 +843,39 @@ void MultiExchangeGateway::updateBalances(const std::string& exchange) {
         return;
     }
     
-    // This would typically fetch all balances from the exchange
-    // For now, we'll implement a placeholder
+    // The venue's full list replaces the mirror, so assets it no longer holds drop out
+    auto balances = connector_it->second->getBalances();
+    if (!balances.empty()) {
+        auto now = std::chrono::steady_clock::now();
+        std::unordered_map<std::string, ExchangeBalance> fresh;
+        for (auto& balance : balances) {
+            balance.last_update = now;
+            fresh[balance.asset] = std::move(balance);
+        }
+        std::lock_guard<std::mutex> lock(balances_mutex_);
+        balances_[exchange] = std::move(fresh);
+        return;
+    }
+    
+    // Venues that can't list balances: reconcile the assets we already mirror
+    std::vector<std::string> assets;
+    {
+        std::lock_guard<std::mutex> lock(balances_mutex_);
+        for (const auto& [asset, balance] : balances_[exchange]) {
+            assets.push_back(asset);
+        }
+    }
+    
+    for (const auto& asset : assets) {
+        onBalanceUpdate(exchange, connector_it->second->getBalance(asset));
+    }
+}
+
+void MultiExchangeGateway::onBalanceUpdate(const std::string& exchange, const ExchangeBalance& balance) {
     std::lock_guard<std::mutex> lock(balances_mutex_);
-    // Implementation would go here
+    auto& entry = balances_[exchange][balance.asset];
+    entry = balance;
+    entry.last_update = std::chrono::steady_clock::now();
 }
 
 double MultiExchangeGateway::getExchangeLatency(const std::string& exchange) const {
@@ -510,6 +884,13 @@ double MultiExchangeGateway::getExchangeLatency(const std::string& exchange) con
     return it != exchange_latencies_.end() ? it->second : 0.0;
 }
 
+void MultiExchangeGateway::updateLatency(const std::string& exchange, double latency_ms) {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    // Smoothed so one slow round trip doesn't starve a venue of routed flow
+    auto [it, inserted] = exchange_latencies_.emplace(exchange, latency_ms);
+    if (!inserted) it->second += 0.2 * (latency_ms - it->second);
+}
+
 void MultiExchangeGateway::logInfo(const std::string& message) const {
     if (logger_) {
         logger_->getLogger()->info("[MultiExchangeGateway] {}", message);
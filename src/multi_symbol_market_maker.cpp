@@ -0,0 +1,184 @@
+#include "multi_symbol_market_maker.h"
+#include <algorithm>
+#include <thread>
+
+namespace moneybot {
+
+MultiSymbolMarketMaker::MultiSymbolMarketMaker(std::shared_ptr<Logger> logger,
+                                               std::shared_ptr<OrderManager> order_manager,
+                                               std::shared_ptr<RiskManager> risk_manager,
+                                               const nlohmann::json& config)
+    : logger_(logger), order_manager_(order_manager), risk_manager_(risk_manager), config_(config),
+      shard_of_(SymbolRegistry::MAX_SYMBOLS, -1) {
+    nlohmann::json host = config.value("multi_symbol", nlohmann::json::object());
+    size_t threads = host.value("threads", 0);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    bool pin_threads = host.value("pin_threads", true);
+    int first_core = host.value("first_core", 0);
+
+    nlohmann::json symbols = host.value("symbols", nlohmann::json::array());
+    if (symbols.empty()) {
+        symbols.push_back(config["strategy"]["symbol"].get<std::string>());
+    }
+    threads = std::min(threads, symbols.size());
+
+    for (size_t i = 0; i < threads; ++i) {
+        Shard shard;
+        shard.actor = std::make_unique<StrategyActor>(logger_, i);
+        shard.actor->setOrderManager(order_manager_);
+        if (pin_threads) {
+            shard.actor->setCore(first_core + static_cast<int>(i));
+        }
+        shards_.push_back(std::move(shard));
+    }
+
+    for (const auto& entry : symbols) {
+        HostedSymbol hosted;
+        hosted.symbol = entry.is_string() ? entry.get<std::string>() : entry.value("symbol", "");
+        hosted.overrides = entry.is_object() ? entry.value("config", nlohmann::json::object())
+                                             : nlohmann::json::object();
+        uint32_t id = SymbolRegistry::getInstance().getOrRegister(hosted.symbol);
+        if (hosted.symbol.empty() || id == SymbolRegistry::INVALID_ID || shard_of_[id] >= 0) {
+            logger_->getLogger()->warn("Skipping symbol '{}' (empty, duplicate or registry full)", hosted.symbol);
+            continue;
+        }
+
+        // Dense ids, so modulo spreads symbols evenly
+        hosted.shard = id % shards_.size();
+        Shard& shard = shards_[hosted.shard];
+        hosted.strategy = std::make_shared<MarketMakerStrategy>(logger_, order_manager_, risk_manager_,
+                                                                symbolConfig(config, hosted));
+        shard.actor->addStrategy(id, hosted.symbol, hosted.strategy);
+        shard_of_[id] = static_cast<int>(hosted.shard);
+        symbols_.push_back(std::move(hosted));
+    }
+
+    logger_->getLogger()->info("MultiSymbolMarketMaker hosting {} symbols on {} shards",
+                              symbols_.size(), shards_.size());
+}
+
+MultiSymbolMarketMaker::~MultiSymbolMarketMaker() {
+    shutdown();
+}
+
+nlohmann::json MultiSymbolMarketMaker::symbolConfig(const nlohmann::json& config, const HostedSymbol& hosted) const {
+    nlohmann::json result = config;
+    result["strategy"]["symbol"] = hosted.symbol;
+    for (const auto& [key, value] : hosted.overrides.items()) {
+        result["strategy"]["config"][key] = value;
+    }
+    return result;
+}
+
+StrategyActor* MultiSymbolMarketMaker::route(uint32_t symbol_id) const {
+    if (symbol_id >= shard_of_.size() || shard_of_[symbol_id] < 0) {
+        unrouted_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return shards_[shard_of_[symbol_id]].actor.get();
+}
+
+void MultiSymbolMarketMaker::initialize() {
+    if (running_) return;
+    running_ = true;
+
+    for (auto& shard : shards_) {
+        shard.actor->initialize();
+    }
+    logger_->getLogger()->info("MultiSymbolMarketMaker started {} shard threads", shards_.size());
+}
+
+void MultiSymbolMarketMaker::shutdown() {
+    if (!running_) return;
+    running_ = false;
+
+    for (auto& shard : shards_) {
+        shard.actor->shutdown();
+    }
+    logger_->getLogger()->info("MultiSymbolMarketMaker stopped");
+}
+
+void MultiSymbolMarketMaker::onStreamMessage(const std::string& stream, const nlohmann::json& data) {
+    uint32_t id = SymbolRegistry::getInstance().find(StrategyActor::streamSymbol(stream, data));
+    if (StrategyActor* actor = route(id)) {
+        actor->postMarketData(id, StrategyActor::isTradeStream(stream), data);
+    }
+}
+
+void MultiSymbolMarketMaker::onUserData(const nlohmann::json& message) {
+    if (message.value("e", "") != "executionReport") return;
+    uint32_t id = SymbolRegistry::getInstance().find(message.value("s", ""));
+    if (StrategyActor* actor = route(id)) {
+        actor->postExecution(id, message);
+    } else if (order_manager_) {
+        // No shard hosts the symbol; the account mirror still needs the report
+        order_manager_->handleOrderUpdate(message);
+    }
+}
+
+void MultiSymbolMarketMaker::onOrderBookUpdate(const OrderBook& order_book) {
+    // OrderBook carries no symbol; hosted symbols are fed through onStreamMessage
+    (void)order_book;
+}
+
+void MultiSymbolMarketMaker::onTrade(const Trade& trade) {
+    if (StrategyActor* actor = route(SymbolRegistry::getInstance().find(trade.symbol))) {
+        actor->onTrade(trade);
+    }
+}
+
+void MultiSymbolMarketMaker::onOrderAck(const OrderAck& ack) {
+    for (auto& shard : shards_) shard.actor->onOrderAck(ack);
+}
+
+void MultiSymbolMarketMaker::onOrderReject(const OrderReject& reject) {
+    for (auto& shard : shards_) shard.actor->onOrderReject(reject);
+}
+
+void MultiSymbolMarketMaker::onOrderFill(const OrderFill& fill) {
+    for (auto& shard : shards_) shard.actor->onOrderFill(fill);
+}
+
+void MultiSymbolMarketMaker::updateConfig(const nlohmann::json& config) {
+    config_ = config;
+    for (const auto& hosted : symbols_) {
+        shards_[hosted.shard].actor->post([strategy = hosted.strategy, symbol_config = symbolConfig(config, hosted)]() {
+            strategy->updateConfig(symbol_config);
+        });
+    }
+    logger_->getLogger()->info("MultiSymbolMarketMaker config updated");
+}
+
+nlohmann::json MultiSymbolMarketMaker::getSnapshot() const {
+    nlohmann::json snapshot = nlohmann::json::object();
+    for (const auto& hosted : symbols_) {
+        snapshot[hosted.symbol] = hosted.strategy->getSnapshot();
+    }
+    return snapshot;
+}
+
+std::string MultiSymbolMarketMaker::streamEndpoint() const {
+    return StrategyActor::streamEndpoint(getSymbols());
+}
+
+std::vector<std::string> MultiSymbolMarketMaker::getSymbols() const {
+    std::vector<std::string> symbols;
+    for (const auto& hosted : symbols_) symbols.push_back(hosted.symbol);
+    return symbols;
+}
+
+nlohmann::json MultiSymbolMarketMaker::getStatus() const {
+    nlohmann::json shards = nlohmann::json::array();
+    for (const auto& shard : shards_) {
+        shards.push_back(shard.actor->getStatus());
+    }
+    return {
+        {"running", running_},
+        {"unrouted", unrouted_.load(std::memory_order_relaxed)},
+        {"shards", shards}
+    };
+}
+
+} // namespace moneybot
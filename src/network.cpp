@@ -3,6 +3,7 @@
 #include "types.h"
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
+#include <boost/asio/redirect_error.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <boost/beast/ssl.hpp>
 #include <nlohmann/json.hpp>
@@ -16,10 +17,26 @@ namespace moneybot {
     using boost::asio::use_awaitable;
     namespace this_coro = boost::asio::this_coro;
 
-    Network::Network(std::shared_ptr<Logger> logger, std::shared_ptr<OrderBook> order_book, const json& config)
-        : logger_(logger), order_book_(order_book), config_(config), ioc_(), ssl_ctx_(ssl::context::tlsv12_client),
-          strand_(ioc_.get_executor()) {
+    // Binance drops a listenKey 60 minutes after it was created or last kept alive
+    constexpr std::chrono::minutes LISTEN_KEY_KEEPALIVE{30};
+
+    Network::Network(std::shared_ptr<Logger> logger, std::shared_ptr<OrderBook> order_book, const json& config,
+                     IoRuntime::Lease lease)
+        : logger_(logger), order_book_(order_book), config_(config),
+          own_ioc_(lease ? nullptr : std::make_unique<net::io_context>()), lease_(std::move(lease)),
+          ioc_(lease_ ? lease_.context() : *own_ioc_), ssl_ctx_(ssl::context::tlsv12_client),
+          retry_timer_(ioc_), user_data_retry_timer_(ioc_), resolver_(ioc_), dns_timer_(ioc_),
+          standby_timer_(ioc_), listen_key_timer_(ioc_), strand_(ioc_.get_executor()) {
+        json reconnect = config.value("reconnect", json::object());
+        backoff_initial_ = std::chrono::milliseconds(std::max(1, reconnect.value("initial_ms", 250)));
+        backoff_max_ = std::chrono::milliseconds(std::max(1, reconnect.value("max_ms", 10000)));
+        backoff_jitter_ = std::clamp(reconnect.value("jitter", 0.5), 0.0, 1.0);
+        dns_refresh_ = std::chrono::seconds(reconnect.value("dns_refresh_sec", 60));
+        standby_enabled_ = reconnect.value("standby", false);
+        standby_refresh_ = std::chrono::seconds(std::max(1, reconnect.value("standby_refresh_sec", 20)));
+
         ssl_ctx_.set_default_verify_paths();
+        SSL_CTX_set_session_cache_mode(ssl_ctx_.native_handle(), SSL_SESS_CACHE_CLIENT);
         // ssl_ctx_.set_verify_mode(ssl::verify_peer); // Production
         ssl_ctx_.set_verify_mode(ssl::verify_none); // For testing
         logger_->getLogger()->info("Network initialized.");
@@ -42,85 +59,343 @@ namespace moneybot {
 
         co_await net::post(self->strand_, use_awaitable);
 
-        try {
-            logger->debug("Attempting WebSocket connection to host: {}, port: {}, endpoint: {}", host, port, endpoint);
-
-            ws = std::make_unique<beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>>>(
-                co_await this_coro::executor, self->ssl_ctx_);
+        int attempt = 0;
+        std::optional<Clock::time_point> down_since;
+        while (!self->stopping_) {
+            std::string failure;
+            try {
+                logger->debug("Attempting WebSocket connection to host: {}, port: {}, endpoint: {}", host, port, endpoint);
+                ws = co_await openStream(self, host, port, endpoint,
+                                         self->config_["exchange"]["user_agent"].get<std::string>());
+                logger->info("WebSocket handshake successful.");
 
-            ws->set_option(beast::websocket::stream_base::decorator([&self](beast::websocket::request_type& req) {
-                req.set(beast::http::field::user_agent, self->config_["exchange"]["user_agent"].get<std::string>());
-            }));
+                // Requests queued before here are covered by the subscription below
+                self->outbox_.clear();
+                self->writing_ = false;
+                ++self->outbox_epoch_;
 
-            if (!SSL_set_tlsext_host_name(ws->next_layer().native_handle(), host.c_str())) {
-                throw beast::system_error{
-                    beast::error_code{static_cast<int>(::ERR_get_error()), net::error::get_ssl_category()},
-                    "Failed to set SNI"};
-            }
+                // Only send subscription message if using combined stream endpoint
+                if (endpoint.rfind("/stream", 0) == 0) {
+                    json subscribe = self->config_["exchange"]["websocket_subscription"];
+                    if (self->subscription_provider_) {
+                        subscribe = {{"method", "SUBSCRIBE"}, {"params", self->subscription_provider_()},
+                                     {"id", self->request_id_++}};
+                    }
+                    if (!subscribe["params"].empty()) {
+                        co_await ws->async_write(net::buffer(subscribe.dump()), use_awaitable);
+                    }
+                    logger->info("Subscribed to {} streams", subscribe["params"].size());
+                }
+                self->stream_open_ = true;
+                // Changes made while the subscription was being written
+                if (!self->outbox_.empty()) self->writeNext();
 
-            net::ip::tcp::resolver resolver(co_await this_coro::executor);
-            auto results = co_await resolver.async_resolve(host, port, use_awaitable);
-            co_await beast::get_lowest_layer(ws->next_layer()).async_connect(results, use_awaitable);
-            logger->info("TCP connected to {}:{}", host, port);
-
-            co_await ws->next_layer().async_handshake(ssl::stream_base::client, use_awaitable);
-            logger->info("SSL handshake successful.");
-
-            ws->control_callback([self, &ws](beast::websocket::frame_type kind, boost::string_view payload) {
-                if (kind == beast::websocket::frame_type::ping) {
-                    self->logger_->getLogger()->debug("Received ping frame: {}",
-                                                  std::string(payload.data(), payload.size()));
-                    beast::websocket::ping_data ping_payload;
-                    if (!payload.empty()) {
-                        ping_payload.assign(payload.data(), std::min(payload.size(), ping_payload.max_size()));
+                bool first = true;
+                for (;;) {
+                    buffer.clear();
+                    co_await ws->async_read(buffer, use_awaitable);
+                    if (self->stopping_) {
+                        self->stream_open_ = false;
+                        co_return;
                     }
-                    ws->async_pong(ping_payload, [self](boost::system::error_code ec) {
-                        if (ec) {
-                            self->logger_->getLogger()->error("Failed to send pong: {}", ec.message());
+                    if (first) {
+                        first = false;
+                        attempt = 0;
+                        self->onFirstMessage(*ws, host, port, down_since);
+                    }
+                    auto data = beast::buffers_to_string(buffer.data());
+                    logger->debug("Received data: {}", data);
+                    try {
+                        json j = json::parse(data);
+                        // Handle combined stream payloads
+                        if (j.contains("stream") && j.contains("data")) {
+                            if (self->stream_handler_) {
+                                self->stream_handler_(j["stream"].get<std::string>(), j["data"]);
+                            } else {
+                                self->processMessage(j["data"]);
+                            }
+                        } else {
+                            self->processMessage(j);
                         }
-                    });
-                } else if (kind == beast::websocket::frame_type::pong) {
-                    self->logger_->getLogger()->debug("Received pong frame: {}",
-                                                  std::string(payload.data(), payload.size()));
+                    } catch (const std::exception& e) {
+                        logger->error("Failed to process data: {}", e.what());
+                    }
                 }
-            });
+            } catch (const boost::system::system_error& e) {
+                self->stream_open_ = false;
+                if (e.code() == net::error::operation_aborted || self->stopping_) {
+                    logger->info("WebSocket operation canceled.");
+                    co_return;
+                }
+                failure = e.what();
+                logger->error("WebSocket connection failed (system error): {}", failure);
+            } catch (const std::exception& e) {
+                self->stream_open_ = false;
+                failure = e.what();
+                logger->error("WebSocket connection failed: {}", failure);
+            }
+            if (self->stopping_) co_return;
+            if (self->disconnect_handler_) self->disconnect_handler_(failure);
+
+            if (!down_since) down_since = Clock::now();
+            auto wait = self->backoff(attempt++);
+            logger->info("Reconnecting to {}:{} in {} ms (attempt {})", host, port, wait.count(), attempt);
+            boost::system::error_code ec;
+            self->retry_timer_.expires_after(wait);
+            co_await self->retry_timer_.async_wait(net::redirect_error(use_awaitable, ec));
+        }
+    }
+
+    awaitable<std::unique_ptr<Network::WsStream>> Network::openStream(std::shared_ptr<Network> self,
+                                                                      const std::string& host,
+                                                                      const std::string& port,
+                                                                      const std::string& endpoint,
+                                                                      const std::string& user_agent) {
+        auto logger = self->logger_->getLogger();
+        std::unique_ptr<WsStream> ws;
+
+        // A standby already has TCP and TLS up; only the WebSocket upgrade is left
+        if (self->standby_ && self->standby_host_ == host && self->standby_port_ == port &&
+            Clock::now() - self->standby_at_ < self->standby_refresh_) {
+            ws = std::move(self->standby_);
+            self->standby_timer_.cancel();      // Prepare the next one now
+            bool upgraded = false;
+            try {
+                ws->set_option(beast::websocket::stream_base::decorator([user_agent](beast::websocket::request_type& req) {
+                    req.set(beast::http::field::user_agent, user_agent);
+                }));
+                co_await ws->async_handshake(host, endpoint, use_awaitable);
+                upgraded = true;
+            } catch (const std::exception& e) {
+                logger->warn("Standby connection unusable ({}); connecting afresh", e.what());
+            }
+            if (upgraded) {
+                self->standby_used_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                ws.reset();
+            }
+        } else {
+            self->standby_.reset();
+        }
 
+        if (!ws) {
+            ws = co_await connectTls(self, host, port);
+            ws->set_option(beast::websocket::stream_base::decorator([user_agent](beast::websocket::request_type& req) {
+                req.set(beast::http::field::user_agent, user_agent);
+            }));
             co_await ws->async_handshake(host, endpoint, use_awaitable);
-            logger->info("WebSocket handshake successful.");
+        }
 
-            // Only send subscription message if using combined stream endpoint
-            if (endpoint.rfind("/stream", 0) == 0) {
-                json subscribe = self->config_["exchange"]["websocket_subscription"];
-                co_await ws->async_write(net::buffer(subscribe.dump()), use_awaitable);
-                logger->info("Subscribed to streams");
+        WsStream* stream = ws.get();
+        ws->control_callback([self, stream](beast::websocket::frame_type kind, boost::string_view payload) {
+            if (kind == beast::websocket::frame_type::ping) {
+                self->logger_->getLogger()->debug("Received ping frame: {}",
+                                              std::string(payload.data(), payload.size()));
+                beast::websocket::ping_data ping_payload;
+                if (!payload.empty()) {
+                    ping_payload.assign(payload.data(), std::min(payload.size(), ping_payload.max_size()));
+                }
+                stream->async_pong(ping_payload, [self](boost::system::error_code ec) {
+                    if (ec) {
+                        self->logger_->getLogger()->error("Failed to send pong: {}", ec.message());
+                    }
+                });
+            } else if (kind == beast::websocket::frame_type::pong) {
+                self->logger_->getLogger()->debug("Received pong frame: {}",
+                                              std::string(payload.data(), payload.size()));
             }
+        });
+        co_return ws;
+    }
 
-            for (;;) {
-                buffer.clear();
-                co_await ws->async_read(buffer, use_awaitable);
-                auto data = beast::buffers_to_string(buffer.data());
-                logger->debug("Received data: {}", data);
-                try {
-                    json j = json::parse(data);
-                    // Handle combined stream payloads
-                    if (j.contains("stream") && j.contains("data")) {
-                        self->processMessage(j["data"]);
+    awaitable<std::unique_ptr<Network::WsStream>> Network::connectTls(std::shared_ptr<Network> self,
+                                                                      const std::string& host,
+                                                                      const std::string& port) {
+        auto logger = self->logger_->getLogger();
+        auto ws = std::make_unique<WsStream>(co_await this_coro::executor, self->ssl_ctx_);
+        SSL* ssl = ws->next_layer().native_handle();
+        if (!SSL_set_tlsext_host_name(ssl, host.c_str())) {
+            throw beast::system_error{
+                beast::error_code{static_cast<int>(::ERR_get_error()), net::error::get_ssl_category()},
+                "Failed to set SNI"};
+        }
+        if (self->session_ && self->session_host_ == host) {
+            SSL_set_session(ssl, self->session_.get());
+        }
+
+        auto results = co_await resolve(self, host, port);
+        try {
+            co_await beast::get_lowest_layer(ws->next_layer()).async_connect(results, use_awaitable);
+        } catch (...) {
+            // The cached addresses may be stale; the next attempt resolves again
+            self->resolved_ = {};
+            throw;
+        }
+        logger->info("TCP connected to {}:{}", host, port);
+        // Without it a resumed handshake's last flight and the upgrade request wait out a delayed ACK
+        beast::get_lowest_layer(ws->next_layer()).socket().set_option(net::ip::tcp::no_delay(true));
+
+        co_await ws->next_layer().async_handshake(ssl::stream_base::client, use_awaitable);
+        bool resumed = SSL_session_reused(ssl) == 1;
+        if (resumed) self->sessions_resumed_.fetch_add(1, std::memory_order_relaxed);
+        logger->info("SSL handshake successful{}.", resumed ? " (session resumed)" : "");
+        co_return ws;
+    }
+
+    awaitable<net::ip::tcp::resolver::results_type> Network::resolve(std::shared_ptr<Network> self,
+                                                                     const std::string& host,
+                                                                     const std::string& port) {
+        if (!self->resolved_.empty() && self->resolved_host_ == host && self->resolved_port_ == port) {
+            self->dns_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+            co_return self->resolved_;
+        }
+        net::ip::tcp::resolver resolver(co_await this_coro::executor);
+        auto results = co_await resolver.async_resolve(host, port, use_awaitable);
+        bool first = self->resolved_host_.empty();
+        self->resolved_host_ = host;
+        self->resolved_port_ = port;
+        self->resolved_ = results;
+        if (first) self->scheduleDnsRefresh();
+        co_return results;
+    }
+
+    void Network::scheduleDnsRefresh() {
+        if (dns_refresh_.count() <= 0 || stopping_) return;
+        dns_timer_.expires_after(dns_refresh_);
+        dns_timer_.async_wait([weak = weak_from_this()](const boost::system::error_code& ec) {
+            auto self = weak.lock();
+            if (ec || !self || self->stopping_) return;
+            self->resolver_.async_resolve(self->resolved_host_, self->resolved_port_,
+                [weak](const boost::system::error_code& ec, net::ip::tcp::resolver::results_type results) {
+                    auto self = weak.lock();
+                    if (!self) return;
+                    if (ec) {
+                        // Keep the old addresses; a failed connect drops them
+                        self->logger_->getLogger()->warn("DNS refresh for {} failed: {}", self->resolved_host_,
+                                                         ec.message());
                     } else {
-                        self->processMessage(j);
+                        self->resolved_ = std::move(results);
+                        self->dns_refreshes_.fetch_add(1, std::memory_order_relaxed);
                     }
-                } catch (const std::exception& e) {
-                    logger->error("Failed to process data: {}", e.what());
-                }
-            }
-        } catch (const boost::system::system_error& e) {
-            if (e.code() == net::error::operation_aborted) {
-                logger->info("WebSocket operation canceled.");
-            } else {
-                logger->error("WebSocket connection failed (system error): {}", e.what());
+                    self->scheduleDnsRefresh();
+                });
+        });
+    }
+
+    awaitable<void> Network::keepStandby(std::shared_ptr<Network> self, std::string host, std::string port) {
+        auto logger = self->logger_->getLogger();
+        while (!self->stopping_) {
+            try {
+                auto ws = co_await connectTls(self, host, port);
+                if (self->stopping_) break;
+                self->standby_ = std::move(ws);
+                self->standby_host_ = host;
+                self->standby_port_ = port;
+                self->standby_at_ = Clock::now();
+                logger->debug("Standby connection to {}:{} ready", host, port);
+            } catch (const std::exception& e) {
+                logger->warn("Standby connection to {}:{} failed: {}", host, port, e.what());
             }
-        } catch (const std::exception& e) {
-            logger->error("WebSocket connection failed: {}", e.what());
+            // Replaced before servers drop it as idle; cancelled early when it is taken
+            boost::system::error_code ec;
+            self->standby_timer_.expires_after(self->standby_refresh_ * 3 / 4);
+            co_await self->standby_timer_.async_wait(net::redirect_error(use_awaitable, ec));
         }
+        self->standby_.reset();
+    }
+
+    void Network::onFirstMessage(WsStream& stream, const std::string& host, const std::string& port,
+                                 std::optional<Clock::time_point>& down_since) {
+        // Sessions from TLS 1.3 tickets are only available once the handshake has settled
+        SSL_SESSION* session = SSL_get1_session(stream.next_layer().native_handle());
+        if (session) {
+            session_.reset(session, SSL_SESSION_free);
+            session_host_ = host;
+        }
+
+        connects_.fetch_add(1, std::memory_order_relaxed);
+        if (down_since) {
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - *down_since).count();
+            uint64_t count = reconnects_.fetch_add(1, std::memory_order_relaxed);
+            double avg = recovery_avg_ms_.load(std::memory_order_relaxed);
+            recovery_last_ms_.store(ms, std::memory_order_relaxed);
+            recovery_avg_ms_.store(count == 0 ? ms : avg + (ms - avg) / 8.0, std::memory_order_relaxed);
+            recovery_max_ms_.store(std::max(ms, recovery_max_ms_.load(std::memory_order_relaxed)),
+                                   std::memory_order_relaxed);
+            logger_->getLogger()->info("Reconnected to {}:{}; first message {:.1f} ms after the failure", host, port, ms);
+            down_since.reset();
+        }
+
+        if (standby_enabled_ && !standby_running_) {
+            standby_running_ = true;
+            co_spawn(ioc_, keepStandby(shared_from_this(), host, port), detached);
+        }
+    }
+
+    std::chrono::milliseconds Network::backoff(int attempt) {
+        // Exponential, with the top `jitter` fraction randomized so clients don't reconnect in step
+        double delay = static_cast<double>(backoff_initial_.count()) * std::pow(2.0, std::min(attempt, 20));
+        delay = std::min(delay, static_cast<double>(backoff_max_.count()));
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        delay *= 1.0 - backoff_jitter_ * unit(jitter_rng_);
+        return std::chrono::milliseconds(static_cast<int64_t>(delay));
+    }
+
+    json Network::getStats() const {
+        return {
+            {"connected", stream_open_.load() || user_data_open_.load()},
+            {"connects", connects_.load(std::memory_order_relaxed)},
+            {"reconnects", reconnects_.load(std::memory_order_relaxed)},
+            {"sessions_resumed", sessions_resumed_.load(std::memory_order_relaxed)},
+            {"standby_used", standby_used_.load(std::memory_order_relaxed)},
+            {"dns_cache_hits", dns_cache_hits_.load(std::memory_order_relaxed)},
+            {"dns_refreshes", dns_refreshes_.load(std::memory_order_relaxed)},
+            {"recovery_last_ms", recovery_last_ms_.load(std::memory_order_relaxed)},
+            {"recovery_avg_ms", recovery_avg_ms_.load(std::memory_order_relaxed)},
+            {"recovery_max_ms", recovery_max_ms_.load(std::memory_order_relaxed)}
+        };
+    }
+
+    void Network::subscribe(const std::vector<std::string>& streams) {
+        if (streams.empty()) return;
+        send(json{{"method", "SUBSCRIBE"}, {"params", streams}, {"id", 0}}.dump());
+    }
+
+    void Network::unsubscribe(const std::vector<std::string>& streams) {
+        if (streams.empty()) return;
+        send(json{{"method", "UNSUBSCRIBE"}, {"params", streams}, {"id", 0}}.dump());
+    }
+
+    void Network::send(std::string message) {
+        net::post(strand_, [self = shared_from_this(), message = std::move(message)]() mutable {
+            if (self->stopping_) return;
+            // Request ids are assigned here so they are unique per connection
+            json request = json::parse(message);
+            request["id"] = self->request_id_++;
+            self->outbox_.push_back(request.dump());
+            // While connecting it waits for the initial subscribe
+            if (self->ws_ && self->stream_open_ && !self->writing_) self->writeNext();
+        });
+    }
+
+    void Network::writeNext() {
+        writing_ = true;
+        ws_->async_write(net::buffer(outbox_.front()),
+                         [self = shared_from_this(), epoch = outbox_epoch_](beast::error_code ec, std::size_t) {
+            // Back onto the strand that owns the outbox
+            net::post(self->strand_, [self, ec, epoch]() {
+                if (epoch != self->outbox_epoch_) return;     // Reconnected since; the outbox is the new one's
+                self->writing_ = false;
+                if (ec) {
+                    // The connection is failing; its reconnect subscribes to the current set
+                    self->logger_->getLogger()->error("Failed to send control message: {}", ec.message());
+                    self->outbox_.clear();
+                    return;
+                }
+                self->outbox_.pop_front();
+                if (!self->outbox_.empty() && self->stream_open_) self->writeNext();
+            });
+        });
     }
 
     void Network::processMessage(const json& message) {
@@ -160,83 +435,158 @@ namespace moneybot {
     }
 
     void Network::run(const std::string& host, const std::string& port, const std::string& endpoint) {
+        stopping_ = false;
         co_spawn(
             ioc_, [self = shared_from_this(), host, port, endpoint]() {
                 return connectWebSocket(self, host, port, endpoint);
             },
             detached);
-        ioc_.run();
+        if (own_ioc_) ioc_.run();
     }
 
     void Network::runUserDataStream(const std::string& listenKey) {
         using namespace std::chrono_literals;
         std::string host = "stream.binance.us";
         std::string port = "9443";
-        std::string endpoint = "/ws/" + listenKey;
         auto logger = logger_->getLogger();
         auto& ws = ws_;
         auto& buffer = buffer_;
+        listen_key_ = listenKey;
+        stopping_ = false;
 
-        co_spawn(ioc_, [self = shared_from_this(), host, port, endpoint, logger, &ws, &buffer]() -> net::awaitable<void> {
-            try {
-                ws = std::make_unique<beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>>>(
-                    co_await this_coro::executor, self->ssl_ctx_);
-                ws->set_option(beast::websocket::stream_base::decorator([&self](beast::websocket::request_type& req) {
-                    req.set(beast::http::field::user_agent, "MoneyBot/1.0");
-                }));
-                if (!SSL_set_tlsext_host_name(ws->next_layer().native_handle(), host.c_str())) {
-                    throw beast::system_error{
-                        beast::error_code{static_cast<int>(::ERR_get_error()), net::error::get_ssl_category()},
-                        "Failed to set SNI"};
-                }
-                net::ip::tcp::resolver resolver(co_await this_coro::executor);
-                auto results = co_await resolver.async_resolve(host, port, use_awaitable);
-                co_await beast::get_lowest_layer(ws->next_layer()).async_connect(results, use_awaitable);
-                logger->info("TCP connected to {}:{} (user data stream)", host, port);
-                co_await ws->next_layer().async_handshake(ssl::stream_base::client, use_awaitable);
-                logger->info("SSL handshake successful (user data stream)");
-                co_await ws->async_handshake(host, endpoint, use_awaitable);
-                logger->info("WebSocket handshake successful (user data stream)");
-                for (;;) {
-                    buffer.clear();
-                    co_await ws->async_read(buffer, use_awaitable);
-                    auto data = beast::buffers_to_string(buffer.data());
-                    logger->debug("[UserData] Received data: {}", data);
-                    try {
-                        json j = json::parse(data);
-                        // Route to order/account update handlers if present
-                        if (j.contains("e")) {
-                            std::string event_type = j["e"].get<std::string>();
-                            if (event_type == "executionReport") {
-                                if (self->order_manager_)
-                                    self->order_manager_->handleOrderUpdate(j);
-                            } else if (event_type == "outboundAccountPosition") {
-                                if (self->order_manager_)
-                                    self->order_manager_->handleAccountUpdate(j);
+        co_spawn(ioc_, [self = shared_from_this(), host, port, logger, &ws, &buffer]() -> net::awaitable<void> {
+            int attempt = 0;
+            std::optional<Clock::time_point> down_since;
+            while (!self->stopping_) {
+                try {
+                    ws = co_await openStream(self, host, port, "/ws/" + self->listen_key_, "MoneyBot/1.0");
+                    logger->info("WebSocket handshake successful (user data stream)");
+                    self->user_data_open_ = true;
+                    bool first = true;
+                    for (;;) {
+                        buffer.clear();
+                        co_await ws->async_read(buffer, use_awaitable);
+                        if (self->stopping_) {
+                            self->user_data_open_ = false;
+                            co_return;
+                        }
+                        if (first) {
+                            first = false;
+                            attempt = 0;
+                            self->onFirstMessage(*ws, host, port, down_since);
+                        }
+                        auto data = beast::buffers_to_string(buffer.data());
+                        logger->debug("[UserData] Received data: {}", data);
+                        json j;
+                        try {
+                            j = json::parse(data);
+                        } catch (const std::exception& e) {
+                            logger->error("[UserData] Failed to process data: {}", e.what());
+                            continue;
+                        }
+                        // Nothing more arrives on an expired key; reconnect with a new one
+                        if (j.value("e", "") == "listenKeyExpired") {
+                            throw std::runtime_error("listenKey expired");
+                        }
+                        try {
+                            // Route to order/account update handlers if present
+                            if (j.contains("e")) {
+                                std::string event_type = j["e"].get<std::string>();
+                                if (event_type == "executionReport") {
+                                    if (self->user_data_handler_)
+                                        self->user_data_handler_(j);
+                                    else if (self->order_manager_)
+                                        self->order_manager_->handleOrderUpdate(j);
+                                } else if (event_type == "outboundAccountPosition") {
+                                    if (self->order_manager_)
+                                        self->order_manager_->handleAccountUpdate(j);
+                                }
                             }
+                        } catch (const std::exception& e) {
+                            logger->error("[UserData] Failed to process data: {}", e.what());
                         }
-                    } catch (const std::exception& e) {
-                        logger->error("[UserData] Failed to process data: {}", e.what());
                     }
+                } catch (const std::exception& e) {
+                    self->user_data_open_ = false;
+                    if (self->stopping_) co_return;
+                    logger->error("User data WebSocket connection failed: {}", e.what());
+                }
+                if (self->stopping_) co_return;
+                if (!down_since) down_since = Clock::now();
+                auto wait = self->backoff(attempt++);
+                logger->info("Reconnecting user data stream in {} ms (attempt {})", wait.count(), attempt);
+                boost::system::error_code ec;
+                self->user_data_retry_timer_.expires_after(wait);
+                co_await self->user_data_retry_timer_.async_wait(net::redirect_error(use_awaitable, ec));
+                if (self->stopping_ || !self->order_manager_) continue;
+
+                // The old key may be what failed; the exchange hands back the same one while it is valid
+                auto order_manager = self->order_manager_;
+                std::string key = co_await co_spawn(self->rest_pool_, [order_manager]() -> net::awaitable<std::string> {
+                    co_return order_manager->createUserDataStream();
+                }, use_awaitable);
+                if (key.empty()) {
+                    logger->warn("Could not renew the listenKey; retrying with the current one");
+                } else {
+                    self->listen_key_ = key;
                 }
-            } catch (const std::exception& e) {
-                logger->error("User data WebSocket connection failed: {}", e.what());
             }
         }, detached);
-        ioc_.run();
+        if (order_manager_) co_spawn(ioc_, keepListenKey(shared_from_this()), detached);
+        if (own_ioc_) ioc_.run();
+    }
+
+    awaitable<void> Network::keepListenKey(std::shared_ptr<Network> self) {
+        auto logger = self->logger_->getLogger();
+        while (!self->stopping_) {
+            boost::system::error_code ec;
+            self->listen_key_timer_.expires_after(LISTEN_KEY_KEEPALIVE);
+            co_await self->listen_key_timer_.async_wait(net::redirect_error(use_awaitable, ec));
+            if (ec || self->stopping_) co_return;
+
+            auto order_manager = self->order_manager_;
+            std::string key = self->listen_key_;
+            bool kept = co_await co_spawn(self->rest_pool_, [order_manager, key]() -> net::awaitable<bool> {
+                co_return order_manager->keepAliveUserDataStream(key);
+            }, use_awaitable);
+            if (kept || self->stopping_) continue;
+            // Close the connection; the reconnect fetches a new key
+            logger->warn("listenKey keepalive failed; reconnecting the user data stream");
+            if (self->ws_ && self->user_data_open_) {
+                beast::get_lowest_layer(*self->ws_).cancel();
+            }
+        }
     }
 
     void Network::stop() {
-        net::post(ioc_, [this]() {
-            if (ws_) {
-                boost::system::error_code ec;
-                ws_->close(beast::websocket::close_code::normal, ec);
-                logger_->getLogger()->info("WebSocket closed: {}", ec ? ec.message() : "success");
-                ws_.reset();
+        stopping_ = true;
+        // On a shared context the close may run after this Network is gone (stop() from
+        // the destructor); then there is nothing left to close
+        net::post(ioc_, [weak = weak_from_this()]() {
+            auto self = weak.lock();
+            if (!self) return;
+            self->retry_timer_.cancel();
+            self->user_data_retry_timer_.cancel();
+            self->listen_key_timer_.cancel();
+            self->dns_timer_.cancel();
+            self->resolver_.cancel();
+            self->standby_timer_.cancel();
+            self->standby_.reset();
+            if (!self->ws_) {
+                if (self->own_ioc_) self->ioc_.stop();
+                return;
             }
+            // Never a blocking close: other leases' handlers share this thread. The pending
+            // read ends with the close (or the deadline) and its loop returns on stopping_;
+            // the stream stays in ws_ until then, and this handler keeps the Network alive
+            beast::websocket::stream_base::timeout timeout;
+            self->ws_->get_option(timeout);
+            timeout.handshake_timeout = CLOSE_TIMEOUT;
+            self->ws_->set_option(timeout);
+            self->ws_->async_close(beast::websocket::close_code::normal, [self](boost::system::error_code ec) {
+                self->logger_->getLogger()->info("WebSocket closed: {}", ec ? ec.message() : "success");
+                if (self->own_ioc_) self->ioc_.stop();
+            });
         });
-        if (ioc_.stopped())
-            return;
-        ioc_.stop();
     }
 } // namespace moneybot
\ No newline at end of file
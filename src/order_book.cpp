@@ -22,6 +22,24 @@ namespace moneybot {
         }
         return result;
     }
+
+    size_t OrderBook::copyTopBids(double* prices, double* sizes, size_t n) const {
+        size_t count = 0;
+        for (auto it = bids_.begin(); it != bids_.end() && count < n; ++it, ++count) {
+            prices[count] = it->first;
+            sizes[count] = it->second;
+        }
+        return count;
+    }
+
+    size_t OrderBook::copyTopAsks(double* prices, double* sizes, size_t n) const {
+        size_t count = 0;
+        for (auto it = asks_.begin(); it != asks_.end() && count < n; ++it, ++count) {
+            prices[count] = it->first;
+            sizes[count] = it->second;
+        }
+        return count;
+    }
     OrderBook::OrderBook(std::shared_ptr<Logger> logger) : logger_(logger) {
         openDatabase();
         initializeSchema();
@@ -0,0 +1,159 @@
+#include "order_intent_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace moneybot {
+
+OrderIntentManager::OrderIntentManager(std::shared_ptr<Logger> logger,
+                                       std::shared_ptr<OrderManager> order_manager,
+                                       const QuoteTolerance& tolerance)
+    : logger_(logger), order_manager_(order_manager), tolerance_(tolerance) {}
+
+bool OrderIntentManager::withinTolerance(const LiveQuote& live, const QuoteIntent& desired) const {
+    if (desired.price <= 0 || desired.quantity <= 0) return false;
+
+    double price_diff_bps = std::abs(live.price - desired.price) / desired.price * 10000.0;
+    double size_diff = std::abs(live.quantity - desired.quantity) / desired.quantity;
+    return price_diff_bps <= tolerance_.price_bps && size_diff <= tolerance_.size_ratio;
+}
+
+std::vector<QuoteAction> OrderIntentManager::plan(const std::vector<LiveQuote>& live,
+                                                  const std::vector<QuoteIntent>& desired) const {
+    std::vector<QuoteAction> actions;
+
+    for (OrderSide side : {OrderSide::BUY, OrderSide::SELL}) {
+        std::vector<const LiveQuote*> live_side;
+        for (const auto& quote : live) {
+            if (quote.side == side) live_side.push_back(&quote);
+        }
+        std::vector<const QuoteIntent*> desired_side;
+        for (const auto& intent : desired) {
+            if (intent.side == side && intent.quantity > 0 && intent.price > 0) {
+                desired_side.push_back(&intent);
+            }
+        }
+
+        std::vector<bool> used(live_side.size(), false);
+        auto closestUnused = [&](const QuoteIntent& intent) -> int {
+            int best = -1;
+            double best_dist = std::numeric_limits<double>::max();
+            for (size_t i = 0; i < live_side.size(); ++i) {
+                if (used[i]) continue;
+                double dist = std::abs(live_side[i]->price - intent.price);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best = static_cast<int>(i);
+                }
+            }
+            return best;
+        };
+
+        // First pass: keep quotes that are already good enough
+        std::vector<const QuoteIntent*> unmatched;
+        for (const auto* intent : desired_side) {
+            int idx = closestUnused(*intent);
+            if (idx >= 0 && withinTolerance(*live_side[idx], *intent)) {
+                used[idx] = true;
+                actions.push_back({QuoteActionType::KEEP, live_side[idx]->order_id, side,
+                                   live_side[idx]->price, live_side[idx]->quantity});
+            } else {
+                unmatched.push_back(intent);
+            }
+        }
+
+        // Second pass: move a leftover live quote onto each remaining target
+        for (const auto* intent : unmatched) {
+            int idx = closestUnused(*intent);
+            if (idx < 0) {
+                actions.push_back({QuoteActionType::PLACE, "", side, intent->price, intent->quantity});
+                continue;
+            }
+            used[idx] = true;
+            if (tolerance_.amend_supported) {
+                actions.push_back({QuoteActionType::AMEND, live_side[idx]->order_id, side,
+                                   intent->price, intent->quantity});
+            } else {
+                actions.push_back({QuoteActionType::PLACE, "", side, intent->price, intent->quantity});
+                actions.push_back({QuoteActionType::CANCEL, live_side[idx]->order_id, side,
+                                   live_side[idx]->price, live_side[idx]->quantity});
+            }
+        }
+
+        // Anything left over is no longer wanted
+        for (size_t i = 0; i < live_side.size(); ++i) {
+            if (!used[i]) {
+                actions.push_back({QuoteActionType::CANCEL, live_side[i]->order_id, side,
+                                   live_side[i]->price, live_side[i]->quantity});
+            }
+        }
+    }
+
+    return actions;
+}
+
+std::vector<QuoteActionResult> OrderIntentManager::execute(const std::string& symbol,
+                                                           const std::vector<QuoteAction>& actions) {
+    std::vector<QuoteActionResult> results;
+    results.reserve(actions.size());
+
+    auto makeOrder = [&symbol](const QuoteAction& action) {
+        Order order;
+        order.symbol = symbol;
+        order.side = action.side;
+        order.type = OrderType::LIMIT;
+        order.quantity = action.quantity;
+        order.price = action.price;
+        order.status = OrderStatus::PENDING;
+        return order;
+    };
+
+    // Cancels go out first, as one batch for the symbol, so a requote never has the old
+    // and new quotes resting at once
+    std::vector<std::string> cancel_ids;
+    std::vector<const QuoteAction*> cancel_actions;
+    for (const auto& action : actions) {
+        if (action.type == QuoteActionType::CANCEL) {
+            cancel_ids.push_back(action.order_id);
+            cancel_actions.push_back(&action);
+        }
+    }
+    if (!cancel_ids.empty()) {
+        int requests = 0;
+        std::vector<bool> cancelled = order_manager_ ? order_manager_->cancelOrders(symbol, cancel_ids, &requests)
+                                                     : std::vector<bool>(cancel_ids.size(), false);
+        messages_sent_ += requests;
+        for (size_t i = 0; i < cancel_actions.size(); ++i) {
+            results.push_back({*cancel_actions[i], cancelled[i], ""});
+        }
+    }
+
+    // Amends replace a quote in one request, never adding exposure
+    for (const auto& action : actions) {
+        if (action.type == QuoteActionType::KEEP) {
+            quotes_kept_++;
+            results.push_back({action, true, ""});
+        } else if (action.type == QuoteActionType::AMEND) {
+            std::string new_id = order_manager_ ? order_manager_->replaceOrder(action.order_id, makeOrder(action)) : "";
+            messages_sent_++;
+            results.push_back({action, !new_id.empty(), new_id});
+        }
+    }
+
+    // New quotes last
+    for (const auto& action : actions) {
+        if (action.type != QuoteActionType::PLACE) continue;
+        std::string new_id = order_manager_ ? order_manager_->placeOrder(makeOrder(action)) : "";
+        messages_sent_++;
+        results.push_back({action, !new_id.empty(), new_id});
+    }
+
+    if (logger_) {
+        logger_->getLogger()->debug("Quote update for {}: {} actions, {} messages sent, {} kept total",
+                                    symbol, actions.size(), messages_sent_, quotes_kept_);
+    }
+
+    return results;
+}
+
+} // namespace moneybot
@@ -9,9 +9,38 @@
 #include <sstream>
 #include <iomanip>
 #include <random>
+#include <algorithm>
+#include <future>
 
 namespace moneybot {
 
+namespace {
+
+// Binance sends numeric ids in the user data stream and strings elsewhere
+std::string jsonToString(const nlohmann::json& value) {
+    return value.is_string() ? value.get<std::string>() : value.dump();
+}
+
+OrderStatus parseOrderStatus(const std::string& status) {
+    if (status == "NEW") return OrderStatus::ACKNOWLEDGED;
+    if (status == "PARTIALLY_FILLED") return OrderStatus::PARTIALLY_FILLED;
+    if (status == "FILLED") return OrderStatus::FILLED;
+    if (status == "CANCELED" || status == "EXPIRED") return OrderStatus::CANCELLED;
+    if (status == "REJECTED") return OrderStatus::REJECTED;
+    return OrderStatus::PENDING;
+}
+
+// Binance REQUEST_WEIGHT cost of the endpoints we call
+int requestWeight(const std::string& endpoint, const std::string& method, const nlohmann::json& data) {
+    if (endpoint == "/api/v3/account") return 20;
+    if (endpoint == "/api/v3/openOrders" && method == "GET") return data.contains("symbol") ? 6 : 80;
+    return 1;
+}
+
+constexpr uint32_t VENUE_KEY = 0;
+
+} // namespace
+
 OrderManager::OrderManager(std::shared_ptr<Logger> logger, const nlohmann::json& config)
     : logger_(logger), config_(config), running_(false) {
     
@@ -19,10 +48,18 @@ OrderManager::OrderManager(std::shared_ptr<Logger> logger, const nlohmann::json&
     api_key_ = config["exchange"]["rest_api"]["api_key"].get<std::string>();
     secret_key_ = config["exchange"]["rest_api"]["secret_key"].get<std::string>();
     base_url_ = config["exchange"]["rest_api"]["base_url"].get<std::string>();
+    reconcile_interval_ms_ = config["exchange"]["rest_api"].value("reconcile_interval_ms", 30000);
     
     // Initialize HTTP client
     resolver_ = std::make_unique<boost::asio::ip::tcp::resolver>(ioc_);
     
+    // Client order ids: OM_<start ms>_<random>_<sequence>, at most 36 characters
+    std::random_device rd;
+    auto started = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    client_id_prefix_ = "OM_" + std::to_string(started) + "_" +
+                        std::to_string(std::uniform_int_distribution<>(100000, 999999)(rd)) + "_";
+    
     logger_->getLogger()->info("OrderManager initialized for {}", base_url_);
 }
 
@@ -80,6 +117,14 @@ std::string OrderManager::placeOrder(const Order& order, OrderCallback ack_cb,
             ack.client_order_id = order_id;
             ack.timestamp = std::chrono::system_clock::now();
             
+            // Mirror the new order immediately; the stream confirms it later
+            Order placed = order;
+            placed.order_id = server_order_id;
+            placed.client_order_id = order_id;
+            placed.status = OrderStatus::ACKNOWLEDGED;
+            placed.timestamp = ack.timestamp;
+            mirror_.applyOrder(placed);
+            
             logger_->getLogger()->info("Order placed successfully: {} {} {} @ {}", 
                                       order.symbol, 
                                       order.side == OrderSide::BUY ? "BUY" : "SELL",
@@ -131,6 +176,7 @@ bool OrderManager::cancelOrder(const std::string& order_id) {
         
         if (response.contains("orderId")) {
             logger_->getLogger()->info("Order cancelled successfully: {}", order_id);
+            mirror_.removeOrder(order_id);
             
             // Remove callbacks
             {
@@ -166,6 +212,7 @@ bool OrderManager::cancelAllOrders(const std::string& symbol) {
         
         if (response.is_array()) {
             logger_->getLogger()->info("Cancelled {} orders for symbol: {}", response.size(), symbol);
+            mirror_.removeOrders(symbol);
             
             // Clear all callbacks
             {
@@ -185,43 +232,176 @@ bool OrderManager::cancelAllOrders(const std::string& symbol) {
     }
 }
 
-std::vector<Balance> OrderManager::getBalances() {
+std::string OrderManager::replaceOrder(const std::string& order_id, const Order& order) {
+    if (!running_) {
+        logger_->getLogger()->warn("OrderManager not running, cannot replace order");
+        return "";
+    }
+    
+    std::string client_order_id = generateClientOrderId();
+    
+    // Atomic cancel-replace: the new order only goes out if the cancel succeeds
+    nlohmann::json replace_data;
+    replace_data["symbol"] = order.symbol;
+    replace_data["side"] = (order.side == OrderSide::BUY) ? "BUY" : "SELL";
+    replace_data["type"] = "LIMIT";
+    replace_data["timeInForce"] = "GTC";
+    replace_data["quantity"] = std::to_string(order.quantity);
+    replace_data["price"] = std::to_string(order.price);
+    replace_data["cancelOrderId"] = order_id;
+    replace_data["cancelReplaceMode"] = "STOP_ON_FAILURE";
+    replace_data["newClientOrderId"] = client_order_id;
+    
     try {
-        nlohmann::json response = makeRequest("/api/v3/account", "GET");
+        nlohmann::json response = makeRequest("/api/v3/order/cancelReplace", "POST", replace_data);
         
-        std::vector<Balance> balances;
-        if (response.contains("balances")) {
-            for (const auto& balance_data : response["balances"]) {
-                Balance balance(balance_data);
-                if (balance.total > 0) { // Only include non-zero balances
-                    balances.push_back(balance);
+        if (response.contains("newOrderResponse") && response["newOrderResponse"].contains("orderId")) {
+            std::string new_order_id = jsonToString(response["newOrderResponse"]["orderId"]);
+            
+            // Carry callbacks over to the replacement
+            {
+                std::lock_guard<std::mutex> lock(callbacks_mutex_);
+                auto it = callbacks_.find(order_id);
+                if (it != callbacks_.end()) {
+                    callbacks_[new_order_id] = it->second;
+                    callbacks_.erase(order_id);
                 }
             }
+            
+            Order placed = order;
+            placed.order_id = new_order_id;
+            placed.client_order_id = client_order_id;
+            placed.status = OrderStatus::ACKNOWLEDGED;
+            placed.timestamp = std::chrono::system_clock::now();
+            mirror_.removeOrder(order_id);
+            mirror_.applyOrder(placed);
+            
+            logger_->getLogger()->info("Order replaced: {} -> {} {} @ {}", order_id, new_order_id,
+                                      order.quantity, order.price);
+            return new_order_id;
         }
         
-        return balances;
+        std::string error_msg = response.contains("msg") ? response["msg"].get<std::string>() : "Unknown error";
+        logger_->getLogger()->error("Order replace failed: {}", error_msg);
+        return "";
     } catch (const std::exception& e) {
-        logger_->getLogger()->error("Failed to get balances: {}", e.what());
-        return {};
+        logger_->getLogger()->error("Order replace exception: {}", e.what());
+        return "";
+    }
+}
+
+std::vector<bool> OrderManager::cancelOrders(const std::string& symbol, const std::vector<std::string>& order_ids,
+                                             int* requests_sent) {
+    std::vector<bool> results(order_ids.size(), false);
+    int requests = 0;
+    
+    // If we are pulling every open order on the symbol, one request does it
+    auto open_orders = mirror_.getOpenOrders(symbol);
+    bool covers_all = order_ids.size() > 1 && open_orders.size() == order_ids.size() &&
+        std::all_of(open_orders.begin(), open_orders.end(), [&order_ids](const Order& o) {
+            return std::find(order_ids.begin(), order_ids.end(), o.order_id) != order_ids.end();
+        });
+    
+    if (covers_all) {
+        requests++;
+        if (cancelAllOrders(symbol)) {
+            std::fill(results.begin(), results.end(), true);
+        }
+    } else if (order_ids.size() > 1) {
+        // The venue has no cancel-by-ids request, so the batch goes out concurrently:
+        // one round trip for the symbol instead of one per order
+        std::vector<std::future<bool>> pending;
+        pending.reserve(order_ids.size());
+        for (const auto& order_id : order_ids) {
+            pending.push_back(std::async(std::launch::async, [this, &order_id]() { return cancelOrder(order_id); }));
+        }
+        for (size_t i = 0; i < pending.size(); ++i) {
+            results[i] = pending[i].get();
+        }
+        requests += static_cast<int>(order_ids.size());
+    } else if (!order_ids.empty()) {
+        requests++;
+        results[0] = cancelOrder(order_ids[0]);
     }
+    
+    if (requests_sent) *requests_sent = requests;
+    return results;
+}
+
+std::vector<Balance> OrderManager::getBalances() {
+    return mirror_.getBalances();
 }
 
 std::vector<Position> OrderManager::getPositions() {
-    // Binance US doesn't support futures, so positions are always zero
-    std::vector<Position> positions;
-    
-    Position btc_position;
-    btc_position.symbol = "BTCUSDT";
-    btc_position.quantity = 0.0;
-    btc_position.avg_price = 0.0;
-    btc_position.unrealized_pnl = 0.0;
-    btc_position.realized_pnl = 0.0;
-    positions.push_back(btc_position);
-    
-    return positions;
+    // Binance US doesn't support futures; positions are derived from stream fills
+    return mirror_.getPositions();
 }
 
 std::vector<Order> OrderManager::getOpenOrders(const std::string& symbol) {
+    return mirror_.getOpenOrders(symbol);
+}
+
+bool OrderManager::reconcile() {
+    uint64_t token = mirror_.beginReconcile();
+    auto orders = fetchOpenOrders();
+    auto balances = fetchBalances();
+    
+    // An empty answer from a failed request is not an empty account
+    if (!orders || !balances) {
+        logger_->getLogger()->warn("Mirror reconcile skipped: REST snapshot unavailable");
+        return false;
+    }
+    
+    if (!mirror_.reconcile(token, *orders, *balances)) {
+        logger_->getLogger()->debug("Mirror reconcile skipped: a newer snapshot was already merged");
+        return false;
+    }
+    
+    logger_->getLogger()->debug("Mirror reconciled: {} open orders, {} balances", orders->size(), balances->size());
+    return true;
+}
+
+void OrderManager::reconcileLoop() {
+    std::unique_lock<std::mutex> lock(reconcile_mutex_);
+    while (running_) {
+        reconcile_cv_.wait_for(lock, std::chrono::milliseconds(reconcile_interval_ms_),
+                               [this] { return !running_; });
+        if (!running_) break;
+        
+        lock.unlock();
+        try {
+            reconcile();
+        } catch (const std::exception& e) {
+            logger_->getLogger()->error("Mirror reconcile failed: {}", e.what());
+        }
+        lock.lock();
+    }
+}
+
+std::optional<std::vector<Balance>> OrderManager::fetchBalances() {
+    try {
+        nlohmann::json response = makeRequest("/api/v3/account", "GET");
+        if (!response.contains("balances")) {
+            logger_->getLogger()->error("Failed to get balances: {}", response.dump());
+            return std::nullopt;
+        }
+        
+        std::vector<Balance> balances;
+        for (const auto& balance_data : response["balances"]) {
+            Balance balance(balance_data);
+            if (balance.total > 0) { // Only include non-zero balances
+                balances.push_back(balance);
+            }
+        }
+        
+        return balances;
+    } catch (const std::exception& e) {
+        logger_->getLogger()->error("Failed to get balances: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+std::optional<std::vector<Order>> OrderManager::fetchOpenOrders(const std::string& symbol) {
     try {
         std::string endpoint = "/api/v3/openOrders";
         if (!symbol.empty()) {
@@ -229,18 +409,20 @@ std::vector<Order> OrderManager::getOpenOrders(const std::string& symbol) {
         }
         
         nlohmann::json response = makeRequest(endpoint, "GET");
+        if (!response.is_array()) {
+            logger_->getLogger()->error("Failed to get open orders: {}", response.dump());
+            return std::nullopt;
+        }
         
         std::vector<Order> orders;
-        if (response.is_array()) {
-            for (const auto& order_data : response) {
-                orders.emplace_back(order_data);
-            }
+        for (const auto& order_data : response) {
+            orders.emplace_back(order_data);
         }
         
         return orders;
     } catch (const std::exception& e) {
         logger_->getLogger()->error("Failed to get open orders: {}", e.what());
-        return {};
+        return std::nullopt;
     }
 }
 
@@ -251,6 +433,13 @@ void OrderManager::start() {
     }
     
     running_ = true;
+    
+    // Seed the mirror once, then keep it honest in the background
+    if (!reconcile()) {
+        logger_->getLogger()->warn("Initial mirror seed failed, will retry in background");
+    }
+    worker_thread_ = std::thread(&OrderManager::reconcileLoop, this);
+    
     logger_->getLogger()->info("OrderManager started");
 }
 
@@ -259,7 +448,14 @@ void OrderManager::stop() {
         return;
     }
     
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(reconcile_mutex_);
+        running_ = false;
+    }
+    reconcile_cv_.notify_all();
+    if (worker_thread_.joinable()) {
+        worker_thread_.join();
+    }
     
     // Cancel all orders
     cancelAllOrders("");
@@ -281,6 +477,13 @@ void OrderManager::updateConfig(const nlohmann::json& config) {
 
 nlohmann::json OrderManager::makeRequest(const std::string& endpoint, const std::string& method, 
                                         const nlohmann::json& data) {
+    if (rate_limiter_ &&
+        !rate_limiter_->tryAcquire(RateScope::VENUE, VENUE_KEY, RateLimiter::nowMs(),
+                                   requestWeight(endpoint, method, data))) {
+        logger_->getLogger()->warn("API {} {} held back: request weight budget exhausted", method, endpoint);
+        return {{"code", -1003}, {"msg", "Local request weight limit reached"}};
+    }
+    
     try {
         // Parse URL
         std::string host = base_url_.substr(base_url_.find("://") + 3);
@@ -377,16 +580,34 @@ void OrderManager::handleOrderUpdate(const nlohmann::json& data) {
     
     // Handle order status updates
     if (data.contains("e") && data["e"].get<std::string>() == "executionReport") {
-        std::string order_id = data["i"].get<std::string>();
+        std::string order_id = jsonToString(data["i"]);
         std::string status = data["X"].get<std::string>();
         
+        // Keep the mirror current
+        Order order;
+        order.order_id = order_id;
+        order.client_order_id = data.value("c", "");
+        order.symbol = data.value("s", "");
+        order.side = data.value("S", "") == "BUY" ? OrderSide::BUY : OrderSide::SELL;
+        order.type = data.value("o", "") == "MARKET" ? OrderType::MARKET : OrderType::LIMIT;
+        order.quantity = std::stod(data.value("q", "0"));
+        order.price = std::stod(data.value("p", "0"));
+        order.status = parseOrderStatus(status);
+        order.timestamp = std::chrono::system_clock::now();
+        mirror_.applyOrder(order);
+        
+        if (data.value("x", "") == "TRADE") {
+            mirror_.applyFill(order.symbol, order.side, std::stod(data.value("l", "0")),
+                              std::stod(data.value("L", "0")));
+        }
+        
         std::lock_guard<std::mutex> lock(callbacks_mutex_);
         auto it = callbacks_.find(order_id);
         if (it != callbacks_.end()) {
             if (status == "FILLED" && it->second.fill_callback) {
                 OrderFill fill;
                 fill.order_id = order_id;
-                fill.trade_id = data["t"].get<std::string>();
+                fill.trade_id = jsonToString(data["t"]);
                 fill.price = std::stod(data["L"].get<std::string>());
                 fill.quantity = std::stod(data["l"].get<std::string>());
                 fill.commission = std::stod(data["n"].get<std::string>());
@@ -401,20 +622,23 @@ void OrderManager::handleOrderUpdate(const nlohmann::json& data) {
 
 void OrderManager::handleAccountUpdate(const nlohmann::json& data) {
     logger_->getLogger()->debug("Received account update: {}", data.dump());
+    
+    if (!data.contains("B")) return;
+    
+    for (const auto& entry : data["B"]) {
+        Balance balance;
+        balance.asset = entry.value("a", "");
+        balance.free = std::stod(entry.value("f", "0"));
+        balance.locked = std::stod(entry.value("l", "0"));
+        balance.total = balance.free + balance.locked;
+        mirror_.applyBalance(balance);
+    }
 }
 
 std::string OrderManager::generateClientOrderId() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(100000, 999999);
-    
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
-    
-    std::stringstream ss;
-    ss << "OM_" << timestamp << "_" << dis(gen);
-    return ss.str();
+    // Shared by every caller thread: only the counter moves, and the prefix keeps ids
+    // from one run apart from the last
+    return client_id_prefix_ + std::to_string(next_client_id_.fetch_add(1, std::memory_order_relaxed));
 }
 
 void OrderManager::registerCallbacks(const std::string& order_id, OrderCallback ack_cb, 
@@ -430,14 +654,33 @@ void OrderManager::registerCallbacks(const std::string& order_id, OrderCallback
 }
 
 std::string OrderManager::createUserDataStream() {
+    auto response = userDataStreamRequest(boost::beast::http::verb::post, "");
+    if (response && response->contains("listenKey")) {
+        return (*response)["listenKey"].get<std::string>();
+    }
+    if (response) logger_->getLogger()->error("Failed to get listenKey from user data stream response");
+    return "";
+}
+
+bool OrderManager::keepAliveUserDataStream(const std::string& listen_key) {
+    auto response = userDataStreamRequest(boost::beast::http::verb::put, listen_key);
+    // Success is an empty object; an expired or unknown key comes back as {"code": ..., "msg": ...}
+    return response && !response->contains("code");
+}
+
+std::optional<nlohmann::json> OrderManager::userDataStreamRequest(boost::beast::http::verb method,
+                                                                  const std::string& listen_key) {
     try {
         std::string host = base_url_.substr(base_url_.find("://") + 3);
         std::string port = "443";
         std::string path = "/api/v3/userDataStream";
+        if (!listen_key.empty()) {
+            path += "?listenKey=" + listen_key;
+        }
 
-        // Create HTTP POST request
+        // Create HTTP request
         boost::beast::http::request<boost::beast::http::string_body> req;
-        req.method(boost::beast::http::verb::post);
+        req.method(method);
         req.target(path);
         req.version(11);
         req.set(boost::beast::http::field::host, host);
@@ -459,14 +702,11 @@ std::string OrderManager::createUserDataStream() {
         boost::beast::http::read(socket, buffer, res);
         nlohmann::json response = nlohmann::json::parse(res.body());
         logger_->getLogger()->info("User data stream response: {}", response.dump());
-        if (response.contains("listenKey")) {
-            return response["listenKey"].get<std::string>();
-        }
-        logger_->getLogger()->error("Failed to get listenKey from user data stream response");
-        return "";
+        return response;
     } catch (const std::exception& e) {
-        logger_->getLogger()->error("Failed to create user data stream: {}", e.what());
-        return "";
+        logger_->getLogger()->error("User data stream request ({}) failed: {}",
+                                    std::string(boost::beast::http::to_string(method)), e.what());
+        return std::nullopt;
     }
 }
 
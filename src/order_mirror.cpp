@@ -0,0 +1,214 @@
+#include "order_mirror.h"
+#include <algorithm>
+#include <cmath>
+
+namespace moneybot {
+
+OrderMirror::OrderMirror()
+    : snapshot_(std::make_shared<const AccountSnapshot>()) {}
+
+std::shared_ptr<const AccountSnapshot> OrderMirror::snapshot() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+}
+
+std::vector<Order> OrderMirror::getOpenOrders(const std::string& symbol) const {
+    auto snap = snapshot();
+    std::vector<Order> orders;
+    orders.reserve(snap->open_orders.size());
+    for (const auto& [order_id, order] : snap->open_orders) {
+        if (symbol.empty() || order.symbol == symbol) {
+            orders.push_back(order);
+        }
+    }
+    return orders;
+}
+
+std::vector<Balance> OrderMirror::getBalances() const {
+    auto snap = snapshot();
+    std::vector<Balance> balances;
+    balances.reserve(snap->balances.size());
+    for (const auto& [asset, balance] : snap->balances) {
+        if (balance.total > 0) { // Only include non-zero balances
+            balances.push_back(balance);
+        }
+    }
+    return balances;
+}
+
+std::vector<Position> OrderMirror::getPositions() const {
+    auto snap = snapshot();
+    std::vector<Position> positions;
+    positions.reserve(snap->positions.size());
+    for (const auto& [symbol, position] : snap->positions) {
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+Balance OrderMirror::getBalance(const std::string& asset) const {
+    auto snap = snapshot();
+    auto it = snap->balances.find(asset);
+    if (it != snap->balances.end()) {
+        return it->second;
+    }
+    Balance empty;
+    empty.asset = asset;
+    empty.free = empty.locked = empty.total = 0.0;
+    return empty;
+}
+
+size_t OrderMirror::getOpenOrderCount() const {
+    return snapshot()->open_orders.size();
+}
+
+template<typename Fn>
+void OrderMirror::modify(Fn&& fn) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    uint64_t event = stream_events_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    auto next = std::make_shared<AccountSnapshot>(*snapshot_);
+    fn(*next, event);
+    next->version++;
+    std::atomic_store_explicit(&snapshot_, std::shared_ptr<const AccountSnapshot>(std::move(next)),
+                               std::memory_order_release);
+}
+
+void OrderMirror::applyOrder(const Order& order) {
+    modify([&](AccountSnapshot& snap, uint64_t event) {
+        order_changed_[order.order_id] = event;
+        bool terminal = order.status == OrderStatus::FILLED ||
+                        order.status == OrderStatus::CANCELLED ||
+                        order.status == OrderStatus::REJECTED;
+        if (terminal) {
+            snap.open_orders.erase(order.order_id);
+        } else {
+            snap.open_orders[order.order_id] = order;
+        }
+    });
+}
+
+void OrderMirror::removeOrder(const std::string& order_id) {
+    modify([&](AccountSnapshot& snap, uint64_t event) {
+        order_changed_[order_id] = event;
+        snap.open_orders.erase(order_id);
+    });
+}
+
+void OrderMirror::removeOrders(const std::string& symbol) {
+    modify([&](AccountSnapshot& snap, uint64_t event) {
+        if (symbol.empty()) {
+            clear_all_event_ = event;
+            snap.open_orders.clear();
+            return;
+        }
+        symbol_cleared_[symbol] = event;
+        for (auto it = snap.open_orders.begin(); it != snap.open_orders.end();) {
+            if (it->second.symbol == symbol) {
+                it = snap.open_orders.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    });
+}
+
+void OrderMirror::applyBalance(const Balance& balance) {
+    modify([&](AccountSnapshot& snap, uint64_t event) {
+        balance_changed_[balance.asset] = event;
+        snap.balances[balance.asset] = balance;
+    });
+}
+
+void OrderMirror::applyFill(const std::string& symbol, OrderSide side, double quantity, double price) {
+    modify([&](AccountSnapshot& snap, uint64_t) {
+        auto [it, inserted] = snap.positions.try_emplace(symbol);
+        Position& pos = it->second;
+        if (inserted) {
+            pos.symbol = symbol;
+            pos.quantity = pos.avg_price = pos.unrealized_pnl = pos.realized_pnl = 0.0;
+        }
+
+        double signed_qty = side == OrderSide::BUY ? quantity : -quantity;
+        double new_qty = pos.quantity + signed_qty;
+
+        if (pos.quantity != 0.0 && (pos.quantity > 0) != (signed_qty > 0)) {
+            // Reducing or flipping: realize PnL on the closed part
+            double closed = std::min(std::abs(signed_qty), std::abs(pos.quantity));
+            double direction = pos.quantity > 0 ? 1.0 : -1.0;
+            pos.realized_pnl += closed * (price - pos.avg_price) * direction;
+            if ((new_qty > 0) != (pos.quantity > 0) && new_qty != 0.0) {
+                pos.avg_price = price;
+            }
+        } else if (new_qty != 0.0) {
+            pos.avg_price = (pos.avg_price * pos.quantity + price * signed_qty) / new_qty;
+        }
+
+        pos.quantity = new_qty;
+        if (pos.quantity == 0.0) {
+            pos.avg_price = 0.0;
+        }
+    });
+}
+
+uint64_t OrderMirror::beginReconcile() const {
+    return stream_events_.load(std::memory_order_acquire);
+}
+
+bool OrderMirror::reconcile(uint64_t token, const std::vector<Order>& open_orders,
+                            const std::vector<Balance>& balances) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    // Merging a snapshot older than the last one would undo what that one fixed
+    if (token < reconciled_through_) {
+        return false;
+    }
+
+    // Changed after the fetch began: the mirror is newer than REST for this key
+    auto changed = [token](const std::unordered_map<std::string, uint64_t>& journal, const std::string& key) {
+        auto it = journal.find(key);
+        return it != journal.end() && it->second > token;
+    };
+
+    auto next = std::make_shared<AccountSnapshot>(*snapshot_);
+    std::unordered_map<std::string, Order> orders;
+    for (auto& [order_id, order] : next->open_orders) {
+        if (changed(order_changed_, order_id)) {
+            orders.emplace(order_id, std::move(order));
+        }
+    }
+    for (const auto& order : open_orders) {
+        if (changed(order_changed_, order.order_id) || changed(symbol_cleared_, order.symbol) ||
+            clear_all_event_ > token) {
+            continue;
+        }
+        orders[order.order_id] = order;
+    }
+    next->open_orders = std::move(orders);
+
+    std::unordered_map<std::string, Balance> merged_balances;
+    for (auto& [asset, balance] : next->balances) {
+        if (changed(balance_changed_, asset)) {
+            merged_balances.emplace(asset, std::move(balance));
+        }
+    }
+    for (const auto& balance : balances) {
+        if (!changed(balance_changed_, balance.asset)) {
+            merged_balances[balance.asset] = balance;
+        }
+    }
+    next->balances = std::move(merged_balances);
+
+    next->last_reconcile = std::chrono::system_clock::now();
+    next->version++;
+    std::atomic_store_explicit(&snapshot_, std::shared_ptr<const AccountSnapshot>(std::move(next)),
+                               std::memory_order_release);
+
+    // Later reconciles start past this token, so older changes no longer matter
+    reconciled_through_ = token;
+    for (auto* journal : {&order_changed_, &symbol_cleared_, &balance_changed_}) {
+        std::erase_if(*journal, [token](const auto& entry) { return entry.second <= token; });
+    }
+    seeded_.store(true, std::memory_order_release);
+    return true;
+}
+
+} // namespace moneybot
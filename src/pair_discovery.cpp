@@ -0,0 +1,491 @@
+#include "pair_discovery.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sqlite3.h>
+
+namespace moneybot {
+
+namespace {
+
+constexpr size_t TILE_ROWS = 4;
+constexpr size_t TILE_COLS = 8;
+constexpr size_t CHUNK_BARS = 128;   // Bars per float accumulation pass; the chunk stays in L2
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs fn(worker) on `threads` threads, the calling thread being worker 0
+template <typename Fn>
+void runWorkers(size_t threads, Fn fn) {
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < threads; ++w) {
+        workers.emplace_back(fn, w);
+    }
+    fn(0);
+    for (auto& worker : workers) worker.join();
+}
+
+// Four floats in one SIMD register (SSE on x86, NEON on ARM); GCC/Clang vector extension
+typedef float float4 __attribute__((vector_size(16)));
+
+// Accumulates the 4x8 tile of R'R at (i0, j0) over `rows` bars of a bar-major chunk.
+// The eight accumulators are named so they stay in registers: per bar, two loads of
+// the hedge columns, four broadcasts and eight vector multiply-adds.
+void tileKernel(const float* chunk, size_t rows, size_t stride, size_t i0, size_t j0,
+                double* out, size_t ldo) {
+    float4 c00 = {}, c01 = {}, c10 = {}, c11 = {}, c20 = {}, c21 = {}, c30 = {}, c31 = {};
+    for (size_t t = 0; t < rows; ++t) {
+        const float* row = chunk + t * stride;
+        const float* a = row + i0;
+        float4 b0, b1;
+        std::memcpy(&b0, row + j0, sizeof(float4));
+        std::memcpy(&b1, row + j0 + 4, sizeof(float4));
+        c00 += a[0] * b0; c01 += a[0] * b1;
+        c10 += a[1] * b0; c11 += a[1] * b1;
+        c20 += a[2] * b0; c21 += a[2] * b1;
+        c30 += a[3] * b0; c31 += a[3] * b1;
+    }
+    const float4 acc[TILE_ROWS][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+    for (size_t r = 0; r < TILE_ROWS; ++r) {
+        double* dst = out + (i0 + r) * ldo + j0;
+        for (size_t c = 0; c < TILE_COLS; ++c) {
+            dst[c] += acc[r][c / 4][c % 4];
+        }
+    }
+}
+
+// Solves the k x k system a * x = b in place (Gaussian elimination, partial pivoting)
+// for two right-hand sides; false if singular.
+bool solve(std::vector<double>& a, std::vector<double>& b0, std::vector<double>& b1, size_t k) {
+    for (size_t col = 0; col < k; ++col) {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < k; ++r) {
+            if (std::abs(a[r * k + col]) > std::abs(a[pivot * k + col])) pivot = r;
+        }
+        if (std::abs(a[pivot * k + col]) < 1e-300) return false;
+        if (pivot != col) {
+            for (size_t c = 0; c < k; ++c) std::swap(a[col * k + c], a[pivot * k + c]);
+            std::swap(b0[col], b0[pivot]);
+            std::swap(b1[col], b1[pivot]);
+        }
+        for (size_t r = col + 1; r < k; ++r) {
+            double f = a[r * k + col] / a[col * k + col];
+            for (size_t c = col; c < k; ++c) a[r * k + c] -= f * a[col * k + c];
+            b0[r] -= f * b0[col];
+            b1[r] -= f * b1[col];
+        }
+    }
+    for (size_t i = k; i-- > 0;) {
+        for (size_t c = i + 1; c < k; ++c) {
+            b0[i] -= a[i * k + c] * b0[c];
+            b1[i] -= a[i * k + c] * b1[c];
+        }
+        b0[i] /= a[i * k + i];
+        b1[i] /= a[i * k + i];
+    }
+    return true;
+}
+
+} // namespace
+
+PairDiscoveryParams::PairDiscoveryParams(const nlohmann::json& j) {
+    bar_ms = j.value("bar_ms", bar_ms);
+    lookback_days = j.value("lookback_days", lookback_days);
+    min_coverage = j.value("min_coverage", min_coverage);
+    min_correlation = j.value("min_correlation", min_correlation);
+    max_candidates = j.value("max_candidates", max_candidates);
+    adf_lags = j.value("adf_lags", adf_lags);
+    adf_critical = j.value("adf_critical", adf_critical);
+    min_half_life_minutes = j.value("min_half_life_minutes", min_half_life_minutes);
+    max_half_life_minutes = j.value("max_half_life_minutes", max_half_life_minutes);
+    max_pairs = j.value("max_pairs", max_pairs);
+    threads = j.value("threads", threads);
+}
+
+nlohmann::json PairDiscoveryReport::toConfigPairs() const {
+    nlohmann::json out = nlohmann::json::array();
+    for (const auto& pair : pairs) {
+        out.push_back({
+            {"base_symbol", pair.base_symbol},
+            {"hedge_symbol", pair.hedge_symbol},
+            {"hedge_ratio", pair.hedge_ratio},
+            {"correlation", pair.correlation},
+            {"adf_stat", pair.adf_stat},
+            {"half_life_minutes", pair.half_life_minutes}
+        });
+    }
+    return out;
+}
+
+nlohmann::json PairDiscoveryReport::toJson() const {
+    return {
+        {"symbols", symbols},
+        {"bars", bars},
+        {"candidates", candidates},
+        {"cointegrated", cointegrated},
+        {"correlation_ms", correlation_ms},
+        {"cointegration_ms", cointegration_ms},
+        {"pairs", toConfigPairs()}
+    };
+}
+
+PairDiscovery::PairDiscovery(PairDiscoveryParams params, std::shared_ptr<Logger> logger)
+    : params_(params), logger_(std::move(logger)) {
+    params_.bar_ms = std::max<int64_t>(params_.bar_ms, 1);
+    params_.adf_lags = std::max(params_.adf_lags, 0);
+}
+
+size_t PairDiscovery::threadCount() const {
+    if (params_.threads > 0) return params_.threads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+BarMatrix PairDiscovery::loadBars(const std::string& db_path, int64_t end_ms) const {
+    BarMatrix matrix;
+    matrix.bar_ms = params_.bar_ms;
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(db_path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        if (logger_) logger_->getLogger()->error("Failed to open {}: {}", db_path, sqlite3_errmsg(db));
+        sqlite3_close(db);
+        return matrix;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (end_ms <= 0) {
+        if (sqlite3_prepare_v2(db, "SELECT MAX(timestamp) FROM ticks;", -1, &stmt, nullptr) == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) end_ms = sqlite3_column_int64(stmt, 0) + 1;
+            sqlite3_finalize(stmt);
+        }
+    }
+    const int64_t bar_ms = params_.bar_ms;
+    const int64_t lookback_ms = static_cast<int64_t>(params_.lookback_days * 86400000.0);
+    const int64_t start_ms = (end_ms - lookback_ms) / bar_ms * bar_ms;
+    const size_t bar_count = end_ms > start_ms ? static_cast<size_t>((end_ms - start_ms + bar_ms - 1) / bar_ms) : 0;
+    if (bar_count < 3) {
+        sqlite3_close(db);
+        return matrix;
+    }
+
+    const char* sql = "SELECT symbol, timestamp, bid_price, ask_price FROM ticks "
+                      "WHERE timestamp >= ? AND timestamp < ? ORDER BY symbol, timestamp;";
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        if (logger_) logger_->getLogger()->error("Query failed: {}", sqlite3_errmsg(db));
+        sqlite3_close(db);
+        return matrix;
+    }
+    sqlite3_bind_int64(stmt, 1, start_ms);
+    sqlite3_bind_int64(stmt, 2, end_ms);
+
+    // Last mid per bar, one symbol at a time; a symbol is kept if it traded in enough bars
+    std::vector<double> bars(bar_count);
+    std::string symbol;
+    size_t covered = 0;
+    auto finishSymbol = [&]() {
+        if (symbol.empty() || covered < params_.min_coverage * bar_count) return;
+        // Forward-fill gaps, back-filling the leading ones from the first print
+        double last = std::numeric_limits<double>::quiet_NaN();
+        for (double v : bars) {
+            if (v > 0.0) { last = v; break; }
+        }
+        for (double& v : bars) {
+            if (v > 0.0) last = v; else v = last;
+        }
+        matrix.symbols.push_back(symbol);
+        for (double v : bars) matrix.log_prices.push_back(std::log(v));
+    };
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        if (!text) continue;
+        if (symbol != text) {
+            finishSymbol();
+            symbol = text;
+            std::fill(bars.begin(), bars.end(), 0.0);
+            covered = 0;
+        }
+        double bid = sqlite3_column_double(stmt, 2);
+        double ask = sqlite3_column_double(stmt, 3);
+        if (!(bid > 0.0) || !(ask > 0.0)) continue;
+        size_t bar = static_cast<size_t>((sqlite3_column_int64(stmt, 1) - start_ms) / bar_ms);
+        if (bars[bar] == 0.0) ++covered;
+        bars[bar] = 0.5 * (bid + ask);
+    }
+    finishSymbol();
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+
+    matrix.timestamps.resize(bar_count);
+    for (size_t t = 0; t < bar_count; ++t) {
+        matrix.timestamps[t] = start_ms + static_cast<int64_t>(t) * bar_ms;
+    }
+    if (logger_) {
+        logger_->getLogger()->info("Pair discovery loaded {} symbols x {} bars from {}",
+                                   matrix.symbols.size(), bar_count, db_path);
+    }
+    return matrix;
+}
+
+std::vector<double> PairDiscovery::correlationMatrix(const BarMatrix& bars) const {
+    const size_t n = bars.symbols.size();
+    const size_t t_count = bars.bars() > 0 ? bars.bars() - 1 : 0;   // Returns
+    std::vector<double> corr(n * n, 0.0);
+    if (n == 0 || t_count < 2) return corr;
+
+    // Standardized returns (zero mean, unit norm), bar-major with rows padded to the tile width
+    const size_t stride = (n + TILE_COLS - 1) / TILE_COLS * TILE_COLS;
+    std::vector<float> returns(t_count * stride, 0.0f);
+    for (size_t s = 0; s < n; ++s) {
+        const double* p = bars.series(s);
+        double mean = (p[t_count] - p[0]) / t_count;
+        double ss = 0.0;
+        for (size_t t = 0; t < t_count; ++t) {
+            double r = p[t + 1] - p[t] - mean;
+            ss += r * r;
+        }
+        if (ss <= 0.0) continue;   // Flat series correlates with nothing
+        double scale = 1.0 / std::sqrt(ss);
+        for (size_t t = 0; t < t_count; ++t) {
+            returns[t * stride + s] = static_cast<float>((p[t + 1] - p[t] - mean) * scale);
+        }
+    }
+
+    // Upper block triangle of R'R. Row blocks are dealt out zig-zag so every worker gets a
+    // similar share of the triangle; each worker streams the bars once, in chunks, and
+    // owns its rows of the product.
+    std::vector<double> product(stride * stride, 0.0);
+    const size_t row_blocks = stride / TILE_ROWS;
+    const size_t threads = std::min(threadCount(), row_blocks);
+    runWorkers(threads, [&](size_t worker) {
+        std::vector<size_t> mine;
+        for (size_t b = 0; b < row_blocks; ++b) {
+            size_t lane = b % (2 * threads);
+            if (lane == worker || lane == 2 * threads - 1 - worker) mine.push_back(b);
+        }
+        for (size_t t0 = 0; t0 < t_count; t0 += CHUNK_BARS) {
+            const size_t rows = std::min(CHUNK_BARS, t_count - t0);
+            const float* chunk = returns.data() + t0 * stride;
+            for (size_t b : mine) {
+                const size_t i0 = b * TILE_ROWS;
+                for (size_t j0 = i0 / TILE_COLS * TILE_COLS; j0 < stride; j0 += TILE_COLS) {
+                    tileKernel(chunk, rows, stride, i0, j0, product.data(), stride);
+                }
+            }
+        }
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i; j < n; ++j) {
+            double c = std::clamp(product[i * stride + j], -1.0, 1.0);
+            corr[i * n + j] = c;
+            corr[j * n + i] = c;
+        }
+    }
+    return corr;
+}
+
+PairCandidate PairDiscovery::testPair(const BarMatrix& bars, size_t base, size_t hedge) const {
+    PairCandidate result;
+    result.base_symbol = bars.symbols[base];
+    result.hedge_symbol = bars.symbols[hedge];
+
+    const size_t t_count = bars.bars();
+    const size_t lags = static_cast<size_t>(params_.adf_lags);
+    const size_t k = lags + 1;
+    if (t_count < k + 10) return result;
+    const double* y = bars.series(base);
+    const double* x = bars.series(hedge);
+
+    // Cointegrating regression: log(base) = alpha + beta * log(hedge) + e
+    double mx = 0.0, my = 0.0;
+    for (size_t t = 0; t < t_count; ++t) {
+        mx += x[t];
+        my += y[t];
+    }
+    mx /= t_count;
+    my /= t_count;
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t t = 0; t < t_count; ++t) {
+        double dx = x[t] - mx;
+        sxx += dx * dx;
+        sxy += dx * (y[t] - my);
+    }
+    if (sxx <= 0.0) return result;
+    const double beta = sxy / sxx;
+    result.hedge_ratio = beta;
+    auto resid = [&](size_t t) { return (y[t] - my) - beta * (x[t] - mx); };
+
+    // ADF on the residuals, no constant:
+    // de[t] = gamma * e[t-1] + sum phi_i * de[t-i] + u, regressors z = (e[t-1], de[t-1..t-lags])
+    // plus an AR(1) with constant for the half-life: de[t] = lambda * e[t-1] + c
+    std::vector<double> xtx(k * k, 0.0), xty(k, 0.0), z(k);
+    std::vector<double> de(lags + 1, 0.0);   // Ring of recent differences
+    double yty = 0.0;
+    double sl = 0.0, sll = 0.0, sd = 0.0, sdl = 0.0;
+    size_t obs = 0, ar_obs = 0;
+    double prev = resid(0);
+    for (size_t t = 1; t < t_count; ++t) {
+        double e = resid(t);
+        double d = e - prev;
+        ++ar_obs;
+        sl += prev;
+        sll += prev * prev;
+        sd += d;
+        sdl += d * prev;
+        if (t > lags) {
+            z[0] = prev;
+            for (size_t i = 1; i <= lags; ++i) z[i] = de[(t - i) % (lags + 1)];
+            for (size_t r = 0; r < k; ++r) {
+                xty[r] += z[r] * d;
+                for (size_t c = r; c < k; ++c) xtx[r * k + c] += z[r] * z[c];
+            }
+            yty += d * d;
+            ++obs;
+        }
+        de[t % (lags + 1)] = d;
+        prev = e;
+    }
+    for (size_t r = 0; r < k; ++r) {
+        for (size_t c = 0; c < r; ++c) xtx[r * k + c] = xtx[c * k + r];
+    }
+
+    std::vector<double> coef = xty;
+    std::vector<double> inv0(k, 0.0);   // First column of (X'X)^-1, for the standard error
+    inv0[0] = 1.0;
+    std::vector<double> a = xtx;
+    if (!solve(a, coef, inv0, k) || obs <= k) return result;
+    double rss = yty;
+    for (size_t r = 0; r < k; ++r) rss -= coef[r] * xty[r];
+    double sigma2 = std::max(rss, 0.0) / (obs - k);
+    double se = std::sqrt(sigma2 * inv0[0]);
+    if (!(se > 0.0)) return result;
+    result.adf_stat = coef[0] / se;
+    result.cointegrated = result.adf_stat < params_.adf_critical;
+
+    double m = static_cast<double>(ar_obs);
+    double denom = m * sll - sl * sl;
+    double lambda = denom > 0.0 ? (m * sdl - sd * sl) / denom : 0.0;
+    if (lambda < 0.0 && lambda > -1.0) {
+        double half_life_bars = -std::log(2.0) / std::log1p(lambda);
+        result.half_life_minutes = half_life_bars * bars.bar_ms / 60000.0;
+    }
+    return result;
+}
+
+PairDiscoveryReport PairDiscovery::run(const BarMatrix& bars) const {
+    PairDiscoveryReport report;
+    const size_t n = bars.symbols.size();
+    report.symbols = n;
+    report.bars = bars.bars();
+    if (n < 2) return report;
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<double> corr = correlationMatrix(bars);
+    report.correlation_ms = elapsedMs(started);
+
+    // Screen: the most correlated pairs, up to max_candidates
+    struct Candidate { size_t a, b; double corr; };
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            if (corr[i * n + j] >= params_.min_correlation) candidates.push_back({i, j, corr[i * n + j]});
+        }
+    }
+    if (candidates.size() > params_.max_candidates) {
+        std::nth_element(candidates.begin(), candidates.begin() + params_.max_candidates, candidates.end(),
+                         [](const Candidate& l, const Candidate& r) { return l.corr > r.corr; });
+        candidates.resize(params_.max_candidates);
+    }
+    report.candidates = candidates.size();
+
+    // Engle-Granger both ways round; the stronger rejection picks the base leg
+    started = std::chrono::steady_clock::now();
+    std::vector<PairCandidate> tested(candidates.size());
+    std::atomic<size_t> next{0};
+    runWorkers(std::min(threadCount(), std::max<size_t>(candidates.size(), 1)), [&](size_t) {
+        for (size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < candidates.size();) {
+            PairCandidate forward = testPair(bars, candidates[c].a, candidates[c].b);
+            PairCandidate reverse = testPair(bars, candidates[c].b, candidates[c].a);
+            tested[c] = reverse.adf_stat < forward.adf_stat ? std::move(reverse) : std::move(forward);
+            tested[c].correlation = candidates[c].corr;
+        }
+    });
+    report.cointegration_ms = elapsedMs(started);
+
+    for (auto& pair : tested) {
+        if (!pair.cointegrated) continue;
+        ++report.cointegrated;
+        if (pair.half_life_minutes >= params_.min_half_life_minutes &&
+            pair.half_life_minutes <= params_.max_half_life_minutes) {
+            report.pairs.push_back(std::move(pair));
+        }
+    }
+    std::sort(report.pairs.begin(), report.pairs.end(),
+              [](const PairCandidate& l, const PairCandidate& r) { return l.adf_stat < r.adf_stat; });
+    if (report.pairs.size() > params_.max_pairs) report.pairs.resize(params_.max_pairs);
+
+    if (logger_) {
+        logger_->getLogger()->info("Pair discovery: {} symbols, {} candidates, {} cointegrated, {} ranked "
+                                   "(correlation {:.0f}ms, cointegration {:.0f}ms)",
+                                   n, report.candidates, report.cointegrated, report.pairs.size(),
+                                   report.correlation_ms, report.cointegration_ms);
+    }
+    return report;
+}
+
+PairDiscoveryJob::PairDiscoveryJob(PairDiscoveryParams params, std::string db_path, std::string output_path,
+                                   std::chrono::minutes interval, std::shared_ptr<Logger> logger)
+    : discovery_(params, logger), db_path_(std::move(db_path)), output_path_(std::move(output_path)),
+      interval_(interval), logger_(std::move(logger)) {}
+
+PairDiscoveryJob::~PairDiscoveryJob() {
+    stop();
+}
+
+void PairDiscoveryJob::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&PairDiscoveryJob::loop, this);
+}
+
+void PairDiscoveryJob::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) return;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+PairDiscoveryReport PairDiscoveryJob::runOnce() {
+    PairDiscoveryReport report = discovery_.run(discovery_.loadBars(db_path_));
+    if (!output_path_.empty()) {
+        std::ofstream out(output_path_);
+        if (out) {
+            out << report.toJson().dump(4) << std::endl;
+        } else if (logger_) {
+            logger_->getLogger()->error("Failed to write discovered pairs to {}", output_path_);
+        }
+    }
+    if (callback_) callback_(report);
+    return report;
+}
+
+void PairDiscoveryJob::loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        lock.unlock();
+        try {
+            runOnce();
+        } catch (const std::exception& e) {
+            if (logger_) logger_->getLogger()->error("Pair discovery failed: {}", e.what());
+        }
+        lock.lock();
+        cv_.wait_for(lock, interval_, [this]() { return !running_; });
+    }
+}
+
+} // namespace moneybot
@@ -0,0 +1,229 @@
+#include "pair_stats_engine.h"
+#include <algorithm>
+#include <cmath>
+
+namespace moneybot {
+
+PairStatsEngine::PairStatsEngine(PairStatsParams params) : params_(params) {
+    params_.window = std::max<size_t>(params_.window, 3);
+    if (params_.recompute_interval == 0) {
+        params_.recompute_interval = params_.window;
+    }
+}
+
+size_t PairStatsEngine::addSymbol(const std::string& symbol) {
+    auto it = symbol_index_.find(symbol);
+    if (it != symbol_index_.end()) return it->second;
+
+    Series series;
+    series.symbol = symbol;
+    series.ring.assign(params_.window + 1, 0.0);
+    series_.push_back(std::move(series));
+    symbol_index_[symbol] = series_.size() - 1;
+    return series_.size() - 1;
+}
+
+size_t PairStatsEngine::addPair(const std::string& base, const std::string& hedge) {
+    size_t b = addSymbol(base);
+    size_t h = addSymbol(hedge);
+    for (size_t i = 0; i < pairs_.size(); ++i) {
+        if (pairs_[i].base == b && pairs_[i].hedge == h) return i;
+    }
+    Pair pair;
+    pair.base = b;
+    pair.hedge = h;
+    pairs_.push_back(pair);
+    return pairs_.size() - 1;
+}
+
+int PairStatsEngine::findSymbol(const std::string& symbol) const {
+    auto it = symbol_index_.find(symbol);
+    return it != symbol_index_.end() ? static_cast<int>(it->second) : -1;
+}
+
+void PairStatsEngine::onPrice(size_t symbol, double price) {
+    if (symbol >= series_.size() || !(price > 0.0)) return;
+    series_[symbol].latest_log = std::log(price);
+    series_[symbol].has_price = true;
+}
+
+void PairStatsEngine::onPrice(const std::string& symbol, double price) {
+    int index = findSymbol(symbol);
+    if (index >= 0) onPrice(static_cast<size_t>(index), price);
+}
+
+void PairStatsEngine::sample() {
+    ++samples_;
+    for (auto& series : series_) {
+        if (series.has_price) pushSeries(series);
+    }
+    for (auto& pair : pairs_) {
+        if (series_[pair.base].has_price && series_[pair.hedge].has_price) updatePair(pair);
+    }
+    if (samples_ % params_.recompute_interval == 0) {
+        recompute();
+    }
+    for (auto& pair : pairs_) {
+        computeStats(pair);
+    }
+}
+
+void PairStatsEngine::pushSeries(Series& s) {
+    const size_t window = params_.window;
+    if (s.pushed == 0) {
+        s.shift = s.latest_log;
+    }
+    double x = s.latest_log - s.shift;
+    s.ring[s.pushed % s.ring.size()] = x;
+    ++s.pushed;
+
+    s.sx += x;
+    s.sxx += x * x;
+    if (++s.n > window) {
+        double old = s.at(window);
+        s.sx -= old;
+        s.sxx -= old * old;
+        s.n = window;
+    }
+
+    if (s.pushed >= 2) {
+        double lag = s.at(1);
+        double d = x - lag;
+        s.sl += lag;
+        s.sll += lag * lag;
+        s.sd += d;
+        s.sdl += d * lag;
+        if (++s.m > window - 1) {
+            double old_lag = s.at(window);
+            double old_d = s.at(window - 1) - old_lag;
+            s.sl -= old_lag;
+            s.sll -= old_lag * old_lag;
+            s.sd -= old_d;
+            s.sdl -= old_d * old_lag;
+            s.m = window - 1;
+        }
+    }
+}
+
+void PairStatsEngine::updatePair(Pair& p) {
+    const size_t window = params_.window;
+    const Series& b = series_[p.base];
+    const Series& h = series_[p.hedge];
+    bool has_lag = p.n > 0; // Previous bar is inside this pair's history
+
+    p.sxy += b.at(0) * h.at(0);
+    if (++p.n > window) {
+        p.sxy -= b.at(window) * h.at(window);
+        p.n = window;
+    }
+
+    if (has_lag) {
+        double bl = b.at(1), hl = h.at(1);
+        p.sl_xy += bl * hl;
+        p.sd_x_l_y += (b.at(0) - bl) * hl;
+        p.sd_y_l_x += (h.at(0) - hl) * bl;
+        if (++p.m > window - 1) {
+            double obl = b.at(window), ohl = h.at(window);
+            p.sl_xy -= obl * ohl;
+            p.sd_x_l_y -= (b.at(window - 1) - obl) * ohl;
+            p.sd_y_l_x -= (h.at(window - 1) - ohl) * obl;
+            p.m = window - 1;
+        }
+    }
+}
+
+void PairStatsEngine::computeStats(Pair& p) {
+    const Series& b = series_[p.base];
+    const Series& h = series_[p.hedge];
+    PairStats& st = p.stats;
+    st.samples = p.n;
+    st.ready = false;
+    if (p.n < params_.window || p.m < params_.window - 1) return;
+
+    // Level regression: base on hedge
+    const double n = static_cast<double>(p.n);
+    double mx = b.sx / n, my = h.sx / n;
+    double vx = b.sxx / n - mx * mx;
+    double vy = h.sxx / n - my * my;
+    double cxy = p.sxy / n - mx * my;
+    if (vx <= 0.0 || vy <= 0.0) return; // Flat series
+
+    double beta = cxy / vy;
+    double alpha = mx - beta * my;
+    double resid_var = std::max(0.0, vx - beta * cxy);
+
+    st.ready = true;
+    st.hedge_ratio = beta;
+    st.correlation = std::clamp(cxy / std::sqrt(vx * vy), -1.0, 1.0);
+    st.intercept = alpha + b.shift - beta * h.shift;
+    st.spread_mean = st.intercept;
+    st.spread = (b.at(0) + b.shift) - beta * (h.at(0) + h.shift);
+    st.spread_std = std::sqrt(resid_var);
+    st.z_score = st.spread_std > 0.0 ? (st.spread - st.spread_mean) / st.spread_std : 0.0;
+
+    // AR(1) on the spread at the current beta: d(s) = lambda * s' + c
+    const double m = static_cast<double>(p.m);
+    double s_l = b.sl - beta * h.sl;
+    double s_ll = b.sll - 2.0 * beta * p.sl_xy + beta * beta * h.sll;
+    double s_d = b.sd - beta * h.sd;
+    double s_dl = b.sdl - beta * p.sd_x_l_y - beta * p.sd_y_l_x + beta * beta * h.sdl;
+    double denom = m * s_ll - s_l * s_l;
+    double lambda = denom > 0.0 ? (m * s_dl - s_d * s_l) / denom : 0.0;
+
+    st.ar_coefficient = lambda;
+    st.half_life_sec = (lambda < 0.0 && lambda > -1.0)
+        ? -std::log(2.0) / std::log1p(lambda) * params_.sample_interval_sec
+        : 0.0;
+}
+
+void PairStatsEngine::rebuildSeries(Series& s) {
+    if (s.pushed == 0) return;
+
+    // Re-centre on the newest value so the sums stay small
+    size_t stored = static_cast<size_t>(std::min<uint64_t>(s.pushed, s.ring.size()));
+    double new_shift = s.at(0) + s.shift;
+    double delta = s.shift - new_shift;
+    for (size_t ago = 0; ago < stored; ++ago) {
+        s.ring[(s.pushed - 1 - ago) % s.ring.size()] += delta;
+    }
+    s.shift = new_shift;
+
+    s.sx = s.sxx = 0.0;
+    for (size_t ago = 0; ago < s.n; ++ago) {
+        double x = s.at(ago);
+        s.sx += x;
+        s.sxx += x * x;
+    }
+    s.sl = s.sll = s.sd = s.sdl = 0.0;
+    for (size_t ago = 0; ago < s.m; ++ago) {
+        double lag = s.at(ago + 1);
+        double d = s.at(ago) - lag;
+        s.sl += lag;
+        s.sll += lag * lag;
+        s.sd += d;
+        s.sdl += d * lag;
+    }
+}
+
+void PairStatsEngine::rebuildPair(Pair& p) {
+    const Series& b = series_[p.base];
+    const Series& h = series_[p.hedge];
+    p.sxy = 0.0;
+    for (size_t ago = 0; ago < p.n; ++ago) {
+        p.sxy += b.at(ago) * h.at(ago);
+    }
+    p.sl_xy = p.sd_x_l_y = p.sd_y_l_x = 0.0;
+    for (size_t ago = 0; ago < p.m; ++ago) {
+        double bl = b.at(ago + 1), hl = h.at(ago + 1);
+        p.sl_xy += bl * hl;
+        p.sd_x_l_y += (b.at(ago) - bl) * hl;
+        p.sd_y_l_x += (h.at(ago) - hl) * bl;
+    }
+}
+
+void PairStatsEngine::recompute() {
+    for (auto& series : series_) rebuildSeries(series);
+    for (auto& pair : pairs_) rebuildPair(pair);
+}
+
+} // namespace moneybot
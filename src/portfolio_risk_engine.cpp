@@ -0,0 +1,234 @@
+#include "portfolio_risk_engine.h"
+#include "symbol_registry.h"
+#include <algorithm>
+#include <cmath>
+
+namespace moneybot {
+
+namespace {
+
+// Acklam's rational approximation of the inverse standard normal CDF
+double inverseNormal(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    const double low = 0.02425;
+
+    if (p < low) {
+        double q = std::sqrt(-2 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    if (p > 1 - low) {
+        double q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+// Four independent accumulators so the compiler can vectorize without -ffast-math
+double dot(const double* a, const double* b, size_t n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+} // namespace
+
+PortfolioRiskConfig::PortfolioRiskConfig(const nlohmann::json& j) {
+    lambda = j.value("lambda", 0.94);
+    confidence = j.value("confidence", 0.99);
+    sample_interval_ms = j.value("sample_interval_ms", 1000);
+    horizon_ms = j.value("horizon_ms", static_cast<int64_t>(86400000));
+    max_symbols = j.value("max_symbols", static_cast<size_t>(512));
+    max_var = j.value("max_var", 0.0);
+}
+
+PortfolioRiskEngine::PortfolioRiskEngine(const PortfolioRiskConfig& config)
+    : config_(config),
+      capacity_(std::min<size_t>(config.max_symbols, SymbolRegistry::MAX_SYMBOLS)),
+      slot_of_(SymbolRegistry::MAX_SYMBOLS, -1),
+      covariance_(capacity_ * capacity_, 0.0),
+      price_(capacity_, 0.0),
+      sample_price_(capacity_, 0.0),
+      quantity_(capacity_, 0.0),
+      exposure_(capacity_, 0.0),
+      cov_exposure_(capacity_, 0.0),
+      returns_(capacity_, 0.0) {
+    z_score_ = inverseNormal(config_.confidence);
+    es_factor_ = std::exp(-0.5 * z_score_ * z_score_) / std::sqrt(2.0 * M_PI) / (1.0 - config_.confidence);
+    horizon_scale_ = std::sqrt(static_cast<double>(config_.horizon_ms) / std::max(1, config_.sample_interval_ms));
+    has_limit_.store(config_.max_var > 0.0, std::memory_order_relaxed);
+}
+
+int32_t PortfolioRiskEngine::slotFor(uint32_t symbol_id) {
+    if (symbol_id >= slot_of_.size()) return -1;
+    if (slot_of_[symbol_id] < 0 && count_ < capacity_) {
+        slot_of_[symbol_id] = static_cast<int32_t>(count_++);
+    }
+    return slot_of_[symbol_id];
+}
+
+void PortfolioRiskEngine::onPrice(uint32_t symbol_id, double price, int64_t now_ms) {
+    if (price <= 0) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int32_t slot = slotFor(symbol_id);
+    if (slot < 0) return;
+
+    price_[slot] = price;
+    if (sample_price_[slot] <= 0) sample_price_[slot] = price;
+    setExposure(slot, quantity_[slot] * price);
+
+    if (last_sample_ms_ < 0) {
+        last_sample_ms_ = now_ms;
+    } else if (now_ms - last_sample_ms_ >= config_.sample_interval_ms) {
+        last_sample_ms_ = now_ms;
+        sampleReturns();
+    }
+}
+
+void PortfolioRiskEngine::setPosition(uint32_t symbol_id, double quantity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int32_t slot = slotFor(symbol_id);
+    if (slot < 0) return;
+
+    quantity_[slot] = quantity;
+    setExposure(slot, quantity * price_[slot]);
+}
+
+void PortfolioRiskEngine::sampleReturns() {
+    const size_t n = count_;
+    for (size_t i = 0; i < n; ++i) {
+        returns_[i] = price_[i] > 0 && sample_price_[i] > 0 ? std::log(price_[i] / sample_price_[i]) : 0.0;
+        sample_price_[i] = price_[i];
+    }
+
+    // Rank-1 EWMA update: C = lambda * C + (1 - lambda) * r r'
+    const double lambda = config_.lambda;
+    const double* r = returns_.data();
+    for (size_t i = 0; i < n; ++i) {
+        double* row = covariance_.data() + i * capacity_;
+        const double scaled = (1.0 - lambda) * r[i];
+        for (size_t j = 0; j < n; ++j) {
+            row[j] = lambda * row[j] + scaled * r[j];
+        }
+    }
+    samples_++;
+
+    rebuildExposureProduct();
+}
+
+void PortfolioRiskEngine::rebuildExposureProduct() {
+    const size_t n = count_;
+    const double* w = exposure_.data();
+    for (size_t i = 0; i < n; ++i) {
+        cov_exposure_[i] = dot(covariance_.data() + i * capacity_, w, n);
+    }
+    // Full recompute also clears drift from the incremental updates
+    variance_ = std::max(0.0, dot(w, cov_exposure_.data(), n));
+}
+
+void PortfolioRiskEngine::setExposure(size_t slot, double exposure) {
+    const double delta = exposure - exposure_[slot];
+    if (delta == 0.0) return;
+
+    // w' C w moves by 2 d (Cw)_k + d^2 C_kk; Cw moves by d * C[:, k] (= row k)
+    const double* row = covariance_.data() + slot * capacity_;
+    variance_ = std::max(0.0, variance_ + 2.0 * delta * cov_exposure_[slot] + delta * delta * row[slot]);
+    const size_t n = count_;
+    for (size_t i = 0; i < n; ++i) {
+        cov_exposure_[i] += delta * row[i];
+    }
+    exposure_[slot] = exposure;
+}
+
+double PortfolioRiskEngine::varFromVariance(double variance) const {
+    return z_score_ * std::sqrt(std::max(0.0, variance)) * horizon_scale_;
+}
+
+double PortfolioRiskEngine::varWithPositionLocked(uint32_t symbol_id, double new_quantity) const {
+    if (symbol_id >= slot_of_.size() || slot_of_[symbol_id] < 0) return varFromVariance(variance_);
+
+    const size_t slot = static_cast<size_t>(slot_of_[symbol_id]);
+    const double delta = (new_quantity - quantity_[slot]) * price_[slot];
+    const double c_kk = covariance_[slot * capacity_ + slot];
+    return varFromVariance(variance_ + 2.0 * delta * cov_exposure_[slot] + delta * delta * c_kk);
+}
+
+double PortfolioRiskEngine::varWithPosition(uint32_t symbol_id, double new_quantity) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return varWithPositionLocked(symbol_id, new_quantity);
+}
+
+bool PortfolioRiskEngine::isPositionAllowed(uint32_t symbol_id, double new_quantity) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (config_.max_var <= 0) return true;
+
+    // Risk-reducing changes are always allowed, even when already over the limit
+    double new_var = varWithPositionLocked(symbol_id, new_quantity);
+    return new_var <= config_.max_var || new_var <= varFromVariance(variance_);
+}
+
+double PortfolioRiskEngine::getPrice(uint32_t symbol_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (symbol_id >= slot_of_.size() || slot_of_[symbol_id] < 0) return 0.0;
+    return price_[slot_of_[symbol_id]];
+}
+
+void PortfolioRiskEngine::setMaxVaR(double max_var) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_.max_var = max_var;
+    has_limit_.store(max_var > 0.0, std::memory_order_relaxed);
+}
+
+PortfolioRiskSnapshot PortfolioRiskEngine::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    PortfolioRiskSnapshot snap;
+    double sigma = std::sqrt(variance_) * horizon_scale_;
+    snap.var = z_score_ * sigma;
+    snap.expected_shortfall = es_factor_ * sigma;
+    for (size_t i = 0; i < count_; ++i) {
+        snap.gross_exposure += std::abs(exposure_[i]);
+        snap.net_exposure += exposure_[i];
+    }
+    snap.max_var = config_.max_var;
+    snap.symbols = count_;
+    snap.samples = samples_;
+    return snap;
+}
+
+nlohmann::json PortfolioRiskEngine::getReport() const {
+    PortfolioRiskSnapshot snap = snapshot();
+    return {
+        {"var", snap.var},
+        {"expected_shortfall", snap.expected_shortfall},
+        {"confidence", config_.confidence},
+        {"horizon_ms", config_.horizon_ms},
+        {"gross_exposure", snap.gross_exposure},
+        {"net_exposure", snap.net_exposure},
+        {"symbols", snap.symbols},
+        {"samples", snap.samples},
+        {"max_var", snap.max_var}
+    };
+}
+
+} // namespace moneybot
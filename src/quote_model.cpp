@@ -0,0 +1,143 @@
+#include "quote_model.h"
+#include <algorithm>
+#include <cmath>
+
+namespace moneybot {
+
+QuoteModelType parseQuoteModelType(const std::string& name) {
+    if (name == "avellaneda_stoikov" || name == "as") return QuoteModelType::AVELLANEDA_STOIKOV;
+    return QuoteModelType::HEURISTIC;
+}
+
+std::string quoteModelName(QuoteModelType type) {
+    return type == QuoteModelType::AVELLANEDA_STOIKOV ? "avellaneda_stoikov" : "heuristic";
+}
+
+double HeuristicQuoteModel::spreadBps(double volatility, double position) const {
+    double spread_bps = params_.base_spread_bps;
+
+    // Adjust for volatility
+    if (volatility > 0) {
+        spread_bps += volatility * params_.volatility_multiplier * 10000; // Convert to bps
+    }
+
+    // Adjust for inventory (wider spread if we have large position)
+    double inventory_factor = std::abs(position) / params_.max_position;
+    spread_bps += inventory_factor * params_.base_spread_bps * 0.5;
+
+    return std::max(params_.min_spread_bps, std::min(params_.max_spread_bps, spread_bps));
+}
+
+double HeuristicQuoteModel::skewBps(double position) const {
+    if (params_.max_position <= 0) return 0.0;
+
+    // If long, skew towards selling; if short, skew towards buying
+    double position_ratio = position / params_.max_position;
+    return position_ratio * params_.inventory_skew_factor;
+}
+
+QuotePrices HeuristicQuoteModel::quote(double mid, double position, double volatility) const {
+    QuotePrices quote;
+    quote.spread_bps = spreadBps(volatility, position);
+    quote.skew_bps = skewBps(position);
+
+    double half_spread = mid * (quote.spread_bps / 10000.0) / 2.0;
+    double skew_adjustment = mid * (quote.skew_bps / 10000.0);
+    quote.bid = mid - half_spread + skew_adjustment;
+    quote.ask = mid + half_spread + skew_adjustment;
+    return quote;
+}
+
+AvellanedaStoikovModel::AvellanedaStoikovModel(const AvellanedaStoikovParams& params)
+    : params_(params) {
+    reset();
+}
+
+void AvellanedaStoikovModel::reset() {
+    last_mid_ = 0.0;
+    last_mid_ms_ = 0;
+    variance_rate_ = 0.0;
+    variance_seeded_ = false;
+    k_ = std::max(params_.initial_k, 1e-6);
+    mean_distance_bps_ = 1.0 / k_;
+    mean_interarrival_sec_ = 0.0;
+    last_trade_ms_ = 0;
+    refreshTerms();
+}
+
+void AvellanedaStoikovModel::setParams(const AvellanedaStoikovParams& params) {
+    params_ = params;
+    refreshTerms();
+}
+
+void AvellanedaStoikovModel::onMid(double mid, int64_t timestamp_ms) {
+    if (mid <= 0) return;
+    if (last_mid_ > 0 && timestamp_ms > last_mid_ms_) {
+        double dt_sec = (timestamp_ms - last_mid_ms_) / 1000.0;
+        double ret_bps = (mid - last_mid_) / last_mid_ * 10000.0;
+        double sample = ret_bps * ret_bps / dt_sec;
+
+        if (!variance_seeded_) {
+            variance_rate_ = sample;
+            variance_seeded_ = true;
+        } else {
+            // Time-decayed EWMA so irregular update intervals weigh correctly
+            double alpha = 1.0 - std::exp(-dt_sec * M_LN2 / params_.volatility_halflife_sec);
+            variance_rate_ += alpha * (sample - variance_rate_);
+        }
+        refreshTerms();
+    }
+    if (timestamp_ms >= last_mid_ms_) {
+        last_mid_ = mid;
+        last_mid_ms_ = timestamp_ms;
+    }
+}
+
+void AvellanedaStoikovModel::onTrade(double price, double mid, int64_t timestamp_ms) {
+    if (price <= 0 || mid <= 0) return;
+
+    double alpha = 2.0 / (std::max(params_.trade_window, 1) + 1.0);
+    double distance_bps = std::max(params_.min_trade_distance_bps, std::abs(price - mid) / mid * 10000.0);
+    mean_distance_bps_ += alpha * (distance_bps - mean_distance_bps_);
+    k_ = 1.0 / mean_distance_bps_;
+
+    if (last_trade_ms_ > 0 && timestamp_ms >= last_trade_ms_) {
+        double gap_sec = (timestamp_ms - last_trade_ms_) / 1000.0;
+        mean_interarrival_sec_ = mean_interarrival_sec_ > 0 ?
+            mean_interarrival_sec_ + alpha * (gap_sec - mean_interarrival_sec_) : gap_sec;
+    }
+    last_trade_ms_ = timestamp_ms;
+
+    refreshTerms();
+}
+
+void AvellanedaStoikovModel::refreshTerms() {
+    double gamma = std::max(params_.gamma, 1e-9);
+    inventory_term_bps_ = gamma * variance_rate_ * params_.horizon_sec;
+    spread_bps_ = inventory_term_bps_ + (2.0 / gamma) * std::log1p(gamma / k_);
+    spread_bps_ = std::max(params_.min_spread_bps, std::min(params_.max_spread_bps, spread_bps_));
+}
+
+QuotePrices AvellanedaStoikovModel::quote(double mid, double position) const {
+    double lots = params_.order_size > 0 ? position / params_.order_size : position;
+
+    QuotePrices quote;
+    quote.spread_bps = spread_bps_;
+    quote.skew_bps = -lots * inventory_term_bps_;
+
+    double reservation = mid * (1.0 + quote.skew_bps / 10000.0);
+    double half_spread = mid * (spread_bps_ / 10000.0) / 2.0;
+    quote.bid = reservation - half_spread;
+    quote.ask = reservation + half_spread;
+    return quote;
+}
+
+double AvellanedaStoikovModel::sigmaBps() const {
+    return std::sqrt(variance_rate_);
+}
+
+double AvellanedaStoikovModel::arrivalRate() const {
+    return mean_interarrival_sec_ > 0 ? 1.0 / mean_interarrival_sec_ : 0.0;
+}
+
+} // namespace moneybot
@@ -4,6 +4,14 @@
 
 namespace moneybot {
 
+namespace {
+
+// Single account and venue for now; keys exist so more can be added
+constexpr uint32_t ACCOUNT_KEY = 0;
+constexpr uint32_t VENUE_KEY = 0;
+
+} // namespace
+
 RiskLimits::RiskLimits(const nlohmann::json& j) {
     max_position_size = j["max_position_size"].get<double>();
     max_order_size = j["max_order_size"].get<double>();
@@ -16,47 +24,108 @@ RiskLimits::RiskLimits(const nlohmann::json& j) {
 
 RiskManager::RiskManager(std::shared_ptr<Logger> logger, const nlohmann::json& config)
     : logger_(logger), limits_(config["risk"]), total_realized_pnl_(0.0), 
-      peak_equity_(0.0), current_equity_(0.0), emergency_stopped_(false),
+      peak_equity_(0.0), current_equity_(0.0),
+      var_engine_(PortfolioRiskConfig(config["risk"].value("var", nlohmann::json::object()))),
       session_start_(std::chrono::system_clock::now()),
       last_pnl_update_(std::chrono::system_clock::now()) {
+    gate_.setLimits(limits_.max_order_size, limits_.max_position_size);
+    rate_limiter_ = std::make_shared<RateLimiter>();
+    
+    // Per-symbol minute window from max_orders_per_minute unless configured explicitly
+    nlohmann::json rate_limits = config["risk"].value("rate_limits", nlohmann::json::object());
+    if (!rate_limits.contains("symbol")) {
+        rate_limits["symbol"] = {{{"window_ms", 60000}, {"max", limits_.max_orders_per_minute}}};
+    }
+    rate_limiter_->configure(rate_limits);
+    
+    nlohmann::json stress = config["risk"].value("stress", nlohmann::json::object());
+    stress_engine_ = std::make_unique<StressScenarioEngine>(stress.value("threads", 0));
+    stress_engine_->loadScenarios(stress);
     logger_->getLogger()->info("RiskManager initialized with limits: max_position={}, max_order={}, max_daily_loss={}",
                               limits_.max_position_size, limits_.max_order_size, limits_.max_daily_loss);
 }
 
 bool RiskManager::checkOrderRisk(const Order& order) {
-    if (emergency_stopped_) {
-        logger_->getLogger()->warn("Order rejected: Emergency stop active");
-        return false;
+    return checkOrderRisk(SymbolRegistry::getInstance().getOrRegister(order.symbol), order);
+}
+
+bool RiskManager::checkOrderRisk(uint32_t symbol_id, const Order& order) {
+    uint32_t reasons = gate_.check(symbol_id, order.side, order.quantity);
+    if (reasons == PreTradeRiskGate::PASS && var_engine_.hasLimit()) {
+        // Correlation-aware portfolio limit; takes the VaR engine's lock, so only when one is set
+        double signed_qty = order.side == OrderSide::BUY ? order.quantity : -order.quantity;
+        if (!var_engine_.isPositionAllowed(symbol_id, gate_.getPosition(symbol_id) + signed_qty)) {
+            reasons = PreTradeRiskGate::REJECT_PORTFOLIO_VAR;
+        }
     }
-    
-    if (order.quantity > limits_.max_order_size) {
-        logger_->getLogger()->warn("Order rejected: Quantity {} exceeds max order size {}", 
-                                  order.quantity, limits_.max_order_size);
-        return false;
+    if (reasons == PreTradeRiskGate::PASS) {
+        // Only orders that pass everything else consume rate budget. The venue
+        // request budget is only peeked; OrderManager spends it when sending.
+        int64_t now_ms = RateLimiter::nowMs();
+        if (rate_limiter_->canAcquire(RateScope::VENUE, VENUE_KEY, now_ms) &&
+            rate_limiter_->tryAcquireOrder(symbol_id, ACCOUNT_KEY, now_ms)) {
+            return true;
+        }
+        reasons = PreTradeRiskGate::REJECT_ORDER_RATE;
     }
     
-    if (!checkOrderRate(order.symbol)) {
-        logger_->getLogger()->warn("Order rejected: Rate limit exceeded for symbol {}", order.symbol);
-        return false;
+    // Slow path: explain the rejection
+    if (reasons & PreTradeRiskGate::REJECT_EMERGENCY_STOP) {
+        logger_->getLogger()->warn("Order rejected: Emergency stop active");
     }
-    
-    return true;
+    if (reasons & PreTradeRiskGate::REJECT_ORDER_SIZE) {
+        logger_->getLogger()->warn("Order rejected: Quantity {} exceeds max order size", order.quantity);
+    }
+    if (reasons & PreTradeRiskGate::REJECT_POSITION) {
+        logger_->getLogger()->warn("Order rejected: {} {} would exceed max position size",
+                                  order.symbol, order.quantity);
+    }
+    if (reasons & PreTradeRiskGate::REJECT_PORTFOLIO_VAR) {
+        double signed_qty = order.side == OrderSide::BUY ? order.quantity : -order.quantity;
+        logger_->getLogger()->warn("Order rejected: {} {} would push portfolio VaR to {:.2f}", order.symbol,
+                                  order.quantity, var_engine_.varWithPosition(symbol_id, gate_.getPosition(symbol_id) + signed_qty));
+    }
+    if (reasons & PreTradeRiskGate::REJECT_ORDER_RATE) {
+        // Peek each limiter again to say which one is full
+        int64_t now_ms = RateLimiter::nowMs();
+        std::string limiters;
+        auto full = [&](RateScope scope, uint32_t key, const char* name) {
+            if (rate_limiter_->canAcquire(scope, key, now_ms)) return;
+            if (!limiters.empty()) limiters += ", ";
+            limiters += name;
+        };
+        full(RateScope::VENUE, VENUE_KEY, "venue request weight");
+        full(RateScope::ACCOUNT, ACCOUNT_KEY, "account orders");
+        full(RateScope::SYMBOL, symbol_id, "symbol orders");
+        if (limiters.empty()) limiters = "freed since";
+        logger_->getLogger()->warn("Order rejected: Rate limit exceeded for {} ({})", order.symbol, limiters);
+    }
+    if (reasons & PreTradeRiskGate::REJECT_UNKNOWN_SYMBOL) {
+        logger_->getLogger()->warn("Order rejected: Symbol table full, cannot track {}", order.symbol);
+    }
+    return false;
 }
 
 bool RiskManager::checkPositionRisk(const std::string& symbol, double new_position) {
-    if (emergency_stopped_) return false;
-    
-    if (std::abs(new_position) > limits_.max_position_size) {
-        logger_->getLogger()->warn("Position risk check failed: {} exceeds max position size {}", 
-                                  new_position, limits_.max_position_size);
+    uint32_t symbol_id = SymbolRegistry::getInstance().getOrRegister(symbol);
+    if (!gate_.isPositionAllowed(symbol_id, new_position)) {
+        if (!gate_.isEmergencyStopped()) {
+            logger_->getLogger()->warn("Position risk check failed: {} exceeds max position size", new_position);
+        }
         return false;
     }
     
+    // Correlation-aware portfolio limit, on the same VaR engine state checkOrderRisk reads
+    if (var_engine_.hasLimit() && !var_engine_.isPositionAllowed(symbol_id, new_position)) {
+        logger_->getLogger()->warn("Position risk check failed: {} {} would push portfolio VaR to {:.2f}",
+                                  symbol, new_position, var_engine_.varWithPosition(symbol_id, new_position));
+        return false;
+    }
     return true;
 }
 
 bool RiskManager::checkDailyLoss(double current_pnl) {
-    if (emergency_stopped_) return false;
+    if (gate_.isEmergencyStopped()) return false;
     
     if (current_pnl < limits_.max_daily_loss) {
         logger_->getLogger()->error("Daily loss limit exceeded: {} < {}", current_pnl, limits_.max_daily_loss);
@@ -68,7 +137,7 @@ bool RiskManager::checkDailyLoss(double current_pnl) {
 }
 
 bool RiskManager::checkDrawdown(double current_drawdown) {
-    if (emergency_stopped_) return false;
+    if (gate_.isEmergencyStopped()) return false;
     
     if (current_drawdown < limits_.max_drawdown) {
         logger_->getLogger()->error("Drawdown limit exceeded: {} < {}", current_drawdown, limits_.max_drawdown);
@@ -80,23 +149,9 @@ bool RiskManager::checkDrawdown(double current_drawdown) {
 }
 
 bool RiskManager::checkOrderRate(const std::string& symbol) {
-    std::lock_guard<std::mutex> lock(rates_mutex_);
-    
-    auto now = std::chrono::system_clock::now();
-    auto& rate_info = order_rates_[symbol];
-    
-    // Reset window if more than 1 minute has passed
-    if (now - rate_info.window_start > std::chrono::minutes(1)) {
-        rate_info.order_count = 0;
-        rate_info.window_start = now;
-    }
-    
-    if (rate_info.order_count >= limits_.max_orders_per_minute) {
-        return false;
-    }
-    
-    rate_info.order_count++;
-    return true;
+    uint32_t symbol_id = SymbolRegistry::getInstance().getOrRegister(symbol);
+    if (symbol_id == SymbolRegistry::INVALID_ID) return false;
+    return rate_limiter_->tryAcquireOrder(symbol_id, ACCOUNT_KEY, RateLimiter::nowMs());
 }
 
 void RiskManager::updatePosition(const std::string& symbol, double quantity, double price) {
@@ -113,9 +168,18 @@ void RiskManager::updatePosition(const std::string& symbol, double quantity, dou
     pos.quantity += quantity;
     pos.last_update = std::chrono::system_clock::now();
     
+    // Publish to the pre-trade gate (we are its single writer, serialized by positions_mutex_)
+    uint32_t symbol_id = SymbolRegistry::getInstance().getOrRegister(symbol);
+    gate_.setPosition(symbol_id, pos.quantity);
+    var_engine_.setPosition(symbol_id, pos.quantity);
+    
     logger_->getLogger()->debug("Position updated: {} = {} @ {}", symbol, pos.quantity, pos.avg_price);
 }
 
+void RiskManager::onPrice(const std::string& symbol, double price) {
+    var_engine_.onPrice(SymbolRegistry::getInstance().getOrRegister(symbol), price, RateLimiter::nowMs());
+}
+
 void RiskManager::updatePnL(const std::string& symbol, double pnl) {
     std::lock_guard<std::mutex> lock(positions_mutex_);
     
@@ -140,6 +204,8 @@ void RiskManager::updatePnL(const std::string& symbol, double pnl) {
 void RiskManager::setRiskLimits(const RiskLimits& limits) {
     std::lock_guard<std::mutex> lock(limits_mutex_);
     limits_ = limits;
+    gate_.setLimits(limits_.max_order_size, limits_.max_position_size);
+    rate_limiter_->setMaxCount(RateScope::SYMBOL, 60000, limits_.max_orders_per_minute);
     logger_->getLogger()->info("Risk limits updated");
 }
 
@@ -149,17 +215,39 @@ RiskLimits RiskManager::getRiskLimits() const {
 }
 
 void RiskManager::emergencyStop() {
-    emergency_stopped_ = true;
+    gate_.setEmergencyStop(true);
     logger_->getLogger()->error("EMERGENCY STOP ACTIVATED");
 }
 
 void RiskManager::resume() {
-    emergency_stopped_ = false;
+    gate_.setEmergencyStop(false);
     logger_->getLogger()->info("Risk manager resumed");
 }
 
 bool RiskManager::isEmergencyStopped() const {
-    return emergency_stopped_;
+    return gate_.isEmergencyStopped();
+}
+
+nlohmann::json RiskManager::runStressTest() {
+    std::vector<StressPosition> positions;
+    {
+        std::lock_guard<std::mutex> lock(positions_mutex_);
+        positions.reserve(positions_.size());
+        for (const auto& [symbol, pos] : positions_) {
+            if (pos.quantity == 0) continue;
+            double mark = var_engine_.getPrice(SymbolRegistry::getInstance().find(symbol));
+            positions.push_back({symbol, pos.quantity, mark > 0 ? mark : pos.avg_price});
+        }
+    }
+    
+    nlohmann::json result = StressScenarioEngine::toJson(stress_engine_->run(positions));
+    logger_->getLogger()->debug("Stress test: {} scenarios in {}us, worst loss {:.2f}",
+                               result["scenarios"].get<size_t>(), result["elapsed_us"].get<int64_t>(),
+                               result["worst_loss"].get<double>());
+    
+    std::lock_guard<std::mutex> lock(stress_mutex_);
+    last_stress_ = result;
+    return result;
 }
 
 nlohmann::json RiskManager::getRiskReport() const {
@@ -167,7 +255,7 @@ nlohmann::json RiskManager::getRiskReport() const {
     std::lock_guard<std::mutex> lock_limits(limits_mutex_);
     
     nlohmann::json report;
-    report["emergency_stopped"] = emergency_stopped_;
+    report["emergency_stopped"] = gate_.isEmergencyStopped();
     report["total_realized_pnl"] = total_realized_pnl_;
     report["current_equity"] = current_equity_;
     report["peak_equity"] = peak_equity_;
@@ -194,6 +282,12 @@ nlohmann::json RiskManager::getRiskReport() const {
         {"max_daily_loss", limits_.max_daily_loss},
         {"max_drawdown", limits_.max_drawdown}
     };
+    report["rate_limits"] = rate_limiter_->getStatus(RateLimiter::nowMs());
+    report["portfolio_var"] = var_engine_.getReport();
+    {
+        std::lock_guard<std::mutex> lock_stress(stress_mutex_);
+        report["stress"] = last_stress_;
+    }
     
     return report;
 }
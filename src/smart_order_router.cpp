@@ -0,0 +1,226 @@
+#include "smart_order_router.h"
+#include <algorithm>
+#include <thread>
+
+namespace moneybot {
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Positive when `price` is worse than `reference` for the side
+double slippageBps(OrderSide side, double price, double reference) {
+    if (reference <= 0.0) return 0.0;
+    double move = side == OrderSide::BUY ? price - reference : reference - price;
+    return move / reference * 10000.0;
+}
+
+} // namespace
+
+double ChildExecution::filledQuantity() const {
+    double filled = 0.0;
+    for (const auto& fill : fills) filled += fill.quantity;
+    return filled;
+}
+
+nlohmann::json RouteReport::toJson() const {
+    nlohmann::json j;
+    j["symbol"] = symbol;
+    j["side"] = plan.side == OrderSide::BUY ? "BUY" : "SELL";
+    j["requested"] = plan.requested;
+    j["routed"] = plan.routed;
+    j["expected_vwap"] = plan.expected_vwap;
+    j["arrival_mid"] = plan.arrival_mid;
+    j["filled_quantity"] = filled_quantity;
+    j["average_price"] = average_price;
+    j["commission"] = commission;
+    j["slippage_bps"] = slippage_bps;
+    j["touch_slippage_bps"] = touch_slippage_bps;
+    j["plan_slippage_bps"] = plan_slippage_bps;
+    j["elapsed_ms"] = elapsed_ms;
+    j["children"] = nlohmann::json::array();
+    for (size_t i = 0; i < children.size(); ++i) {
+        const auto& execution = children[i];
+        nlohmann::json child = {
+            {"exchange", execution.exchange},
+            {"order_id", execution.order_id},
+            {"requested", execution.requested},
+            {"filled", execution.filledQuantity()},
+            {"latency_ms", execution.latency_ms}
+        };
+        if (i < plan.children.size()) {
+            child["limit_price"] = plan.children[i].limit_price;
+            child["expected_vwap"] = plan.children[i].expected_vwap;
+        }
+        if (!execution.error.empty()) child["error"] = execution.error;
+        j["children"].push_back(child);
+    }
+    return j;
+}
+
+RoutePlan planRoute(const ConsolidatedBook& book, OrderSide side, double quantity, double limit_price,
+                    const std::vector<RouteVenue>& venues, const RouteParams& params) {
+    RoutePlan plan;
+    plan.side = side;
+    plan.requested = quantity;
+    const bool is_buy = side == OrderSide::BUY;
+    const auto& levels = is_buy ? book.asks : book.bids;
+    if (!book.bids.empty() && !book.asks.empty()) {
+        plan.arrival_mid = (book.bids.front().price + book.asks.front().price) / 2.0;
+    }
+    if (!levels.empty()) plan.arrival_touch = levels.front().price;
+
+    const size_t venue_count = std::min(book.venueCount(), venues.size());
+    if (quantity <= 0.0 || venue_count == 0) return plan;
+
+    // One slice per venue quoting a level; cost is per unit, lower is better on both sides
+    struct Slice {
+        double cost;
+        double price;
+        double quantity;
+        size_t venue;
+    };
+    std::vector<Slice> slices;
+    for (const auto& level : levels) {
+        if (limit_price > 0.0 && (is_buy ? level.price > limit_price : level.price < limit_price)) break;
+        for (size_t v = 0; v < venue_count; ++v) {
+            if (!venues[v].enabled || level.venue_quantity[v] <= 0.0) continue;
+            double penalty = venues[v].latency_ms * params.latency_cost_bps_per_ms / 10000.0;
+            double effective = book.effectivePrice(level, v, !is_buy);
+            double cost = is_buy ? effective * (1.0 + penalty) : -effective * (1.0 - penalty);
+            slices.push_back(Slice{cost, level.price, level.venue_quantity[v], v});
+        }
+    }
+    // Stable: equal costs keep price order, then venue order
+    std::stable_sort(slices.begin(), slices.end(), [](const Slice& a, const Slice& b) { return a.cost < b.cost; });
+
+    std::vector<double> child_quantity(venue_count), notional(venue_count), deepest(venue_count);
+    std::vector<size_t> child_levels(venue_count);
+    std::vector<bool> excluded(venue_count, false);
+    for (;;) {
+        std::fill(child_quantity.begin(), child_quantity.end(), 0.0);
+        std::fill(notional.begin(), notional.end(), 0.0);
+        std::fill(child_levels.begin(), child_levels.end(), 0);
+        std::vector<double> budget(venue_count);
+        for (size_t v = 0; v < venue_count; ++v) budget[v] = venues[v].available;
+
+        double remaining = quantity;
+        for (const auto& slice : slices) {
+            if (remaining <= 0.0) break;
+            const size_t v = slice.venue;
+            if (excluded[v]) continue;
+            // A buy spends quote including the fee; a sell spends base
+            double fee = (*book.venues)[v].taker_fee;
+            double unit_spend = is_buy ? slice.price * (1.0 + fee) : 1.0;
+            double take = std::min({slice.quantity, remaining, budget[v] / unit_spend});
+            if (take <= 0.0) continue;
+            budget[v] -= take * unit_spend;
+            child_quantity[v] += take;
+            notional[v] += take * slice.price;
+            deepest[v] = slice.price;
+            ++child_levels[v];
+            remaining -= take;
+        }
+
+        // Drop the smallest undersized child and spread its share over the other venues
+        size_t smallest = venue_count;
+        for (size_t v = 0; v < venue_count; ++v) {
+            if (child_quantity[v] > 0.0 && child_quantity[v] < params.min_child_quantity &&
+                (smallest == venue_count || child_quantity[v] < child_quantity[smallest])) {
+                smallest = v;
+            }
+        }
+        if (smallest == venue_count) break;
+        excluded[smallest] = true;
+    }
+
+    double total_notional = 0.0;
+    for (size_t v = 0; v < venue_count; ++v) {
+        if (child_quantity[v] <= 0.0) continue;
+        ChildRoute child;
+        child.venue = v;
+        child.exchange = (*book.venues)[v].exchange;
+        child.quantity = child_quantity[v];
+        child.limit_price = deepest[v];
+        child.expected_vwap = notional[v] / child_quantity[v];
+        child.taker_fee = (*book.venues)[v].taker_fee;
+        child.levels = child_levels[v];
+        plan.routed += child.quantity;
+        plan.expected_fees += notional[v] * child.taker_fee;
+        total_notional += notional[v];
+        plan.children.push_back(std::move(child));
+    }
+    if (plan.routed > 0.0) plan.expected_vwap = total_notional / plan.routed;
+    return plan;
+}
+
+SmartOrderRouter::SmartOrderRouter(ChildSender sender, RouteParams params)
+    : sender_(std::move(sender)), params_(params) {}
+
+RouteReport SmartOrderRouter::route(const Order& parent, const ConsolidatedBook& book,
+                                    const std::vector<RouteVenue>& venues) const {
+    double limit_price = parent.type == OrderType::LIMIT ? parent.price : 0.0;
+    return execute(parent, planRoute(book, parent.side, parent.quantity, limit_price, venues, params_));
+}
+
+RouteReport SmartOrderRouter::execute(const Order& parent, const RoutePlan& plan) const {
+    RouteReport report;
+    report.symbol = parent.symbol;
+    report.plan = plan;
+    report.children.resize(plan.children.size());
+
+    auto start = std::chrono::steady_clock::now();
+    auto send = [&](size_t i) {
+        const ChildRoute& route = plan.children[i];
+        Order child;
+        child.client_order_id = parent.client_order_id + "-" + std::to_string(i + 1);
+        child.symbol = parent.symbol;
+        child.side = plan.side;
+        child.type = OrderType::LIMIT;
+        child.quantity = route.quantity;
+        child.price = route.limit_price;
+        child.status = OrderStatus::PENDING;
+        child.timestamp = std::chrono::system_clock::now();
+
+        auto sent = std::chrono::steady_clock::now();
+        ChildExecution& execution = report.children[i];
+        try {
+            execution = sender_(route.exchange, child);
+        } catch (const std::exception& e) {
+            execution.error = e.what();
+        }
+        execution.exchange = route.exchange;
+        execution.requested = route.quantity;
+        execution.latency_ms = elapsedMs(sent);
+    };
+
+    // Each child blocks on its venue's round trip, so every child but the first gets a
+    // thread and the slowest venue bounds the whole dispatch
+    std::vector<std::thread> senders;
+    for (size_t i = 1; i < plan.children.size(); ++i) {
+        senders.emplace_back(send, i);
+    }
+    if (!plan.children.empty()) send(0);
+    for (auto& sender : senders) sender.join();
+    report.elapsed_ms = elapsedMs(start);
+
+    double notional = 0.0;
+    for (const auto& execution : report.children) {
+        for (const auto& fill : execution.fills) {
+            report.filled_quantity += fill.quantity;
+            notional += fill.quantity * fill.price;
+            report.commission += fill.commission;
+        }
+    }
+    if (report.filled_quantity > 0.0) {
+        report.average_price = notional / report.filled_quantity;
+        report.slippage_bps = slippageBps(plan.side, report.average_price, plan.arrival_mid);
+        report.touch_slippage_bps = slippageBps(plan.side, report.average_price, plan.arrival_touch);
+        report.plan_slippage_bps = slippageBps(plan.side, report.average_price, plan.expected_vwap);
+    }
+    return report;
+}
+
+} // namespace moneybot
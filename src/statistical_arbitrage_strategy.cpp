@@ -0,0 +1,45 @@
+#include "statistical_arbitrage_strategy.h"
+#include <algorithm>
+
+namespace moneybot {
+
+void StatisticalArbitrageStrategy::setTimerWheel(TimerWheel* timers) {
+    // Called from the hosting actor before its thread starts; moving to another wheel
+    // drops the sampler on the old one
+    if (timers_ && sample_timer_ != TimerWheel::INVALID_TIMER) {
+        timers_->cancel(sample_timer_);
+    }
+    timers_ = timers;
+    sample_timer_ = TimerWheel::INVALID_TIMER;
+    if (!timers_) return;
+
+    uint64_t interval = static_cast<uint64_t>(std::max(1, config_.sample_interval_ms));
+    sample_timer_ = timers_->scheduleEvery(interval, [this]() { samplePairStatistics(); });
+}
+
+void StatisticalArbitrageStrategy::samplePairStatistics() {
+    pair_stats_.sample();
+    for (auto& pair : active_pairs_) {
+        const PairStats* stats = getPairStats(pair);
+        if (!stats || !stats->ready) continue;
+        // With the Kalman filter on, it owns the hedge ratio
+        if (!config_.use_kalman_filter) pair.hedge_ratio = stats->hedge_ratio;
+        pair.correlation = stats->correlation;
+        pair.z_score = stats->z_score;
+        pair.mean_spread = stats->spread_mean;
+        pair.std_spread = stats->spread_std;
+        pair.half_life = stats->half_life_sec / 60.0;
+    }
+}
+
+const PairStats* StatisticalArbitrageStrategy::getPairStats(const CryptoPair& pair) const {
+    auto it = pair_stats_index_.find(getPairId(pair));
+    if (it == pair_stats_index_.end()) return nullptr;
+    return &pair_stats_.stats(it->second);
+}
+
+std::string StatisticalArbitrageStrategy::getPairId(const CryptoPair& pair) const {
+    return pair.base_symbol + "/" + pair.hedge_symbol;
+}
+
+} // namespace moneybot
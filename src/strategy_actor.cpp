@@ -0,0 +1,343 @@
+#include "strategy_actor.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace moneybot {
+
+namespace {
+
+std::string idToString(const nlohmann::json& value) {
+    if (value.is_string()) return value.get<std::string>();
+    if (value.is_number_integer()) return std::to_string(value.get<int64_t>());
+    return "";
+}
+
+} // namespace
+
+StrategyActor::StrategyActor(std::shared_ptr<Logger> logger, size_t index)
+    : logger_(logger), index_(index),
+      slot_index_(SymbolRegistry::MAX_SYMBOLS, -1), latest_book_event_(SymbolRegistry::MAX_SYMBOLS, 0) {
+}
+
+StrategyActor::~StrategyActor() {
+    shutdown();
+}
+
+void StrategyActor::addStrategy(uint32_t symbol_id, const std::string& symbol, std::shared_ptr<Strategy> strategy) {
+    if (symbol_id >= slot_index_.size() || slot_index_[symbol_id] >= 0) {
+        logger_->getLogger()->warn("Actor {}: cannot host '{}' (invalid or duplicate symbol)", index_, symbol);
+        return;
+    }
+    auto slot = std::make_unique<Slot>();
+    slot->symbol_id = symbol_id;
+    slot->symbol = symbol;
+    slot->book = std::make_unique<OrderBook>(logger_);
+    slot->strategy = std::move(strategy);
+    slot->strategy->setTimerWheel(&timers_);
+    slot_index_[symbol_id] = static_cast<int>(slots_.size());
+    slots_.push_back(std::move(slot));
+}
+
+StrategyActor::Slot* StrategyActor::findSlot(uint32_t symbol_id) {
+    if (symbol_id >= slot_index_.size() || slot_index_[symbol_id] < 0) return nullptr;
+    return slots_[slot_index_[symbol_id]].get();
+}
+
+void StrategyActor::initialize() {
+    if (running_) return;
+    running_ = true;
+    stopping_ = false;
+
+    // Strategies initialize on their own thread, ahead of any market data
+    post([this]() {
+        for (auto& slot : slots_) slot->strategy->initialize();
+    });
+    thread_ = std::thread(&StrategyActor::run, this);
+    if (core_ >= 0) {
+        pinThread();
+    }
+}
+
+void StrategyActor::shutdown() {
+    if (!running_) return;
+    running_ = false;
+
+    post([this]() {
+        for (auto& slot : slots_) slot->strategy->shutdown();
+    });
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        stopping_ = true;
+    }
+    inbox_cv_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+void StrategyActor::pinThread() {
+#ifdef __linux__
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(static_cast<size_t>(core_) % cores, &cpuset);
+    if (pthread_setaffinity_np(thread_.native_handle(), sizeof(cpu_set_t), &cpuset) != 0) {
+        logger_->getLogger()->warn("Actor {}: failed to pin to core {}", index_, static_cast<size_t>(core_) % cores);
+    }
+#endif
+}
+
+void StrategyActor::enqueue(Event event) {
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        inbox_.push_back(std::move(event));
+    }
+    inbox_cv_.notify_one();
+}
+
+void StrategyActor::postMarketData(uint32_t symbol_id, bool is_trade, const nlohmann::json& data) {
+    // Ids index per-symbol tables on the actor thread; unknown symbols stop here
+    if (symbol_id >= SymbolRegistry::MAX_SYMBOLS) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    enqueue(MarketDataEvent{symbol_id, is_trade, data});
+}
+
+void StrategyActor::postExecution(uint32_t symbol_id, const nlohmann::json& data) {
+    if (symbol_id >= SymbolRegistry::MAX_SYMBOLS) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    enqueue(ExecutionEvent{symbol_id, data});
+}
+
+void StrategyActor::post(Task task) {
+    enqueue(std::move(task));
+}
+
+void StrategyActor::run() {
+    std::vector<Event> batch;
+    for (;;) {
+        {
+            // Sleep until the next event or the next timer, whichever comes first
+            std::unique_lock<std::mutex> lock(inbox_mutex_);
+            auto ready = [&] { return stopping_ || !inbox_.empty(); };
+            uint64_t next_timer = timers_.nextExpiry();
+            if (next_timer == TimerWheel::NEVER) {
+                inbox_cv_.wait(lock, ready);
+            } else {
+                inbox_cv_.wait_until(lock, TimerWheel::toTimePoint(next_timer), ready);
+            }
+            if (stopping_ && inbox_.empty()) return; // Stopping and drained
+            batch.swap(inbox_);
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        // Due timers run first; this also brings the wheel up to date for timers the batch schedules
+        try {
+            timers_fired_.fetch_add(timers_.advance(TimerWheel::nowMs()), std::memory_order_relaxed);
+        } catch (const std::exception& e) {
+            logger_->getLogger()->error("Actor {} timer error: {}", index_, e.what());
+        }
+
+        // Book messages are full snapshots, so only the newest per symbol is worth applying
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (auto* md = std::get_if<MarketDataEvent>(&batch[i]); md && !md->is_trade) {
+                latest_book_event_[md->symbol_id] = static_cast<uint32_t>(i);
+            }
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (auto* md = std::get_if<MarketDataEvent>(&batch[i]);
+                md && !md->is_trade && latest_book_event_[md->symbol_id] != i) {
+                conflated_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            try {
+                process(batch[i]);
+            } catch (const std::exception& e) {
+                logger_->getLogger()->error("Actor {} event error: {}", index_, e.what());
+            }
+        }
+
+        events_.fetch_add(batch.size(), std::memory_order_relaxed);
+        busy_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+        if (batch.size() > max_batch_.load(std::memory_order_relaxed)) {
+            max_batch_.store(batch.size(), std::memory_order_relaxed);
+        }
+        batch.clear();
+    }
+}
+
+void StrategyActor::process(Event& event) {
+    if (auto* md = std::get_if<MarketDataEvent>(&event)) {
+        if (Slot* slot = findSlot(md->symbol_id)) processMarketData(*slot, *md);
+    } else if (auto* exec = std::get_if<ExecutionEvent>(&event)) {
+        // The order manager sees every report, hosted symbol or not
+        if (order_manager_) order_manager_->handleOrderUpdate(exec->data);
+        if (Slot* slot = findSlot(exec->symbol_id)) processExecution(*slot, exec->data);
+    } else if (auto* trade = std::get_if<Trade>(&event)) {
+        if (Slot* slot = findSlot(SymbolRegistry::getInstance().find(trade->symbol))) {
+            slot->strategy->onTrade(*trade);
+        }
+    } else if (auto* ack = std::get_if<OrderAck>(&event)) {
+        for (auto& slot : slots_) slot->strategy->onOrderAck(*ack);
+    } else if (auto* reject = std::get_if<OrderReject>(&event)) {
+        for (auto& slot : slots_) slot->strategy->onOrderReject(*reject);
+    } else if (auto* fill = std::get_if<OrderFill>(&event)) {
+        for (auto& slot : slots_) slot->strategy->onOrderFill(*fill);
+    } else if (auto* task = std::get_if<Task>(&event)) {
+        (*task)();
+    }
+}
+
+void StrategyActor::processMarketData(Slot& slot, const MarketDataEvent& event) {
+    const auto& data = event.data;
+    if (event.is_trade) {
+        Trade trade;
+        trade.trade_id = idToString(data.value("t", nlohmann::json()));
+        trade.symbol = slot.symbol;
+        trade.price = std::stod(data.value("p", "0"));
+        trade.quantity = std::stod(data.value("q", "0"));
+        trade.side = data.value("m", false) ? OrderSide::SELL : OrderSide::BUY; // m=true means maker was seller
+        trade.timestamp = std::chrono::system_clock::now();
+        slot.strategy->onTrade(trade);
+        return;
+    }
+
+    // Partial book snapshots (depthN) come without symbol/time; normalize for OrderBook
+    nlohmann::json depth = {
+        {"s", slot.symbol},
+        {"E", data.contains("E") ? data["E"].get<int64_t>() :
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::system_clock::now().time_since_epoch()).count()},
+        {"bids", data.contains("bids") ? data["bids"] : data.value("b", nlohmann::json::array())},
+        {"asks", data.contains("asks") ? data["asks"] : data.value("a", nlohmann::json::array())}
+    };
+    slot.book->update(depth);
+    slot.strategy->onOrderBookUpdate(*slot.book);
+}
+
+void StrategyActor::processExecution(Slot& slot, const nlohmann::json& data) {
+    std::string order_id = idToString(data.value("i", nlohmann::json()));
+    std::string client_order_id = data.value("c", "");
+    std::string execution = data.value("x", "");
+    if (execution == "NEW") {
+        slot.strategy->onOrderAck({order_id, client_order_id, std::chrono::system_clock::now()});
+    } else if (execution == "REJECTED") {
+        slot.strategy->onOrderReject({order_id, client_order_id, data.value("r", "rejected"),
+                                      std::chrono::system_clock::now()});
+    } else if (execution == "TRADE") {
+        OrderFill fill;
+        fill.order_id = order_id;
+        fill.trade_id = idToString(data.value("t", nlohmann::json()));
+        fill.price = std::stod(data.value("L", "0"));
+        fill.quantity = std::stod(data.value("l", "0"));
+        fill.commission = std::stod(data.value("n", "0"));
+        fill.commission_asset = data.value("N", "");
+        fill.timestamp = std::chrono::system_clock::now();
+        slot.strategy->onOrderFill(fill);
+    }
+}
+
+void StrategyActor::onOrderBookUpdate(const OrderBook& order_book) {
+    // OrderBook carries no symbol and belongs to another thread; feed postMarketData instead
+    (void)order_book;
+}
+
+void StrategyActor::onTrade(const Trade& trade) {
+    enqueue(trade);
+}
+
+void StrategyActor::onOrderAck(const OrderAck& ack) {
+    enqueue(ack);
+}
+
+void StrategyActor::onOrderReject(const OrderReject& reject) {
+    enqueue(reject);
+}
+
+void StrategyActor::onOrderFill(const OrderFill& fill) {
+    enqueue(fill);
+}
+
+std::string StrategyActor::getName() const {
+    return slots_.empty() ? "StrategyActor" : slots_.front()->strategy->getName();
+}
+
+void StrategyActor::updateConfig(const nlohmann::json& config) {
+    post([this, config]() {
+        for (auto& slot : slots_) slot->strategy->updateConfig(config);
+    });
+}
+
+nlohmann::json StrategyActor::getSnapshot() const {
+    // Slots are fixed once running and snapshots are published atomically
+    nlohmann::json snapshot = nlohmann::json::object();
+    for (const auto& slot : slots_) {
+        snapshot[slot->symbol] = slot->strategy->getSnapshot();
+    }
+    return snapshot;
+}
+
+std::vector<std::string> StrategyActor::getSymbols() const {
+    std::vector<std::string> symbols;
+    for (const auto& slot : slots_) symbols.push_back(slot->symbol);
+    return symbols;
+}
+
+nlohmann::json StrategyActor::getStatus() const {
+    size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        queued = inbox_.size();
+    }
+    return {
+        {"actor", index_},
+        {"symbols", getSymbols()},
+        {"events", events_.load(std::memory_order_relaxed)},
+        {"conflated", conflated_.load(std::memory_order_relaxed)},
+        {"dropped", dropped_.load(std::memory_order_relaxed)},
+        {"busy_ms", busy_ns_.load(std::memory_order_relaxed) / 1000000},
+        {"max_batch", max_batch_.load(std::memory_order_relaxed)},
+        {"timers_fired", timers_fired_.load(std::memory_order_relaxed)},
+        {"queued", queued}
+    };
+}
+
+std::vector<std::string> StrategyActor::streamNames(const std::vector<std::string>& symbols) {
+    std::vector<std::string> streams;
+    for (const auto& symbol : symbols) {
+        std::string lower = symbol;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        streams.push_back(lower + "@depth10@100ms");
+        streams.push_back(lower + "@trade");
+    }
+    return streams;
+}
+
+std::string StrategyActor::streamEndpoint(const std::vector<std::string>& symbols) {
+    std::string endpoint = "/stream?streams=";
+    bool first = true;
+    for (const auto& stream : streamNames(symbols)) {
+        endpoint += (first ? "" : "/") + stream;
+        first = false;
+    }
+    return endpoint;
+}
+
+std::string StrategyActor::streamSymbol(const std::string& stream, const nlohmann::json& data) {
+    if (data.contains("s")) return data["s"].get<std::string>();
+    std::string symbol = stream.substr(0, stream.find('@'));
+    std::transform(symbol.begin(), symbol.end(), symbol.begin(), [](unsigned char c) { return std::toupper(c); });
+    return symbol;
+}
+
+bool StrategyActor::isTradeStream(const std::string& stream) {
+    return stream.find("@trade") != std::string::npos || stream.find("@aggTrade") != std::string::npos;
+}
+
+} // namespace moneybot
@@ -0,0 +1,501 @@
+#include "stream_subscription_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <numeric>
+#include <boost/asio/post.hpp>
+
+namespace moneybot {
+
+namespace {
+
+constexpr size_t NONE = StreamLoad::NO_CONNECTION;
+
+} // namespace
+
+std::vector<size_t> planStreamShards(const std::vector<StreamLoad>& streams, size_t open,
+                                     const StreamShardParams& params) {
+    const size_t n = streams.size();
+    std::vector<size_t> target(n, NONE);
+    if (n == 0) return target;
+    const size_t max_connections = std::max<size_t>(params.max_connections, 1);
+    const size_t cap = std::max<size_t>(params.max_streams_per_connection, 1);
+
+    auto shared_needed = [&](size_t count, double rate) {
+        size_t by_count = (count + cap - 1) / cap;
+        size_t by_rate = params.connection_target_rate > 0.0
+                             ? static_cast<size_t>(std::ceil(rate / params.connection_target_rate)) : 1;
+        return std::min(std::max<size_t>({1, by_count, by_rate}), max_connections);
+    };
+
+    // Hottest first; each hot stream leaves the shared pool only while that still fits
+    std::vector<size_t> by_rate(n);
+    std::iota(by_rate.begin(), by_rate.end(), 0);
+    std::stable_sort(by_rate.begin(), by_rate.end(),
+                     [&streams](size_t a, size_t b) { return streams[a].rate > streams[b].rate; });
+    double cold_rate = 0.0;
+    for (const auto& stream : streams) cold_rate += stream.rate;
+    size_t hot_count = 0;
+    while (hot_count < n && streams[by_rate[hot_count]].rate >= params.hot_stream_rate) {
+        double rest = cold_rate - streams[by_rate[hot_count]].rate;
+        size_t cold_left = n - hot_count - 1;
+        if (hot_count + 1 + (cold_left > 0 ? shared_needed(cold_left, rest) : 0) > max_connections) break;
+        cold_rate = rest;
+        ++hot_count;
+    }
+    const size_t cold_count = n - hot_count;
+    const size_t shared = cold_count > 0 ? std::min(shared_needed(cold_count, cold_rate), max_connections - hot_count) : 0;
+    std::vector<bool> hot(n, false);
+    for (size_t k = 0; k < hot_count; ++k) hot[by_rate[k]] = true;
+
+    const size_t slots = std::max(open, max_connections);
+    std::vector<size_t> now_on(slots, 0), cold_on(slots, 0);
+    for (size_t i = 0; i < n; ++i) {
+        size_t c = streams[i].connection;
+        if (c == NONE || c >= slots) continue;
+        ++now_on[c];
+        if (!hot[i]) ++cold_on[c];
+    }
+
+    // Hot streams keep a connection they already have to themselves
+    std::vector<bool> taken(slots, false);
+    for (size_t k = 0; k < hot_count; ++k) {
+        size_t i = by_rate[k];
+        size_t c = streams[i].connection;
+        if (c != NONE && c < slots && now_on[c] == 1) {
+            target[i] = c;
+            taken[c] = true;
+        }
+    }
+
+    // Shared connections: those holding the most cold streams now, then free ones
+    std::vector<size_t> candidates;
+    for (size_t c = 0; c < slots; ++c) {
+        if (!taken[c] && cold_on[c] > 0) candidates.push_back(c);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&cold_on](size_t a, size_t b) { return cold_on[a] > cold_on[b]; });
+    std::vector<size_t> shared_ids;
+    for (size_t c : candidates) {
+        if (shared_ids.size() == shared) break;
+        shared_ids.push_back(c);
+        taken[c] = true;
+    }
+    auto next_free = [&taken, slots]() {
+        for (size_t c = 0; c < slots; ++c) {
+            if (!taken[c]) {
+                taken[c] = true;
+                return c;
+            }
+        }
+        return NONE;
+    };
+    while (shared_ids.size() < shared) shared_ids.push_back(next_free());
+    for (size_t k = 0; k < hot_count; ++k) {
+        if (target[by_rate[k]] == NONE) target[by_rate[k]] = next_free();
+    }
+
+    // Cold streams stay put while their connection is shared and under the cap
+    std::vector<size_t> slot_of(slots, NONE);
+    for (size_t s = 0; s < shared_ids.size(); ++s) slot_of[shared_ids[s]] = s;
+    std::vector<double> load(shared, 0.0);
+    std::vector<size_t> count(shared, 0);
+    std::vector<size_t> movers;
+    for (size_t k = hot_count; k < n; ++k) {
+        size_t i = by_rate[k];
+        size_t c = streams[i].connection;
+        size_t s = c != NONE && c < slots ? slot_of[c] : NONE;
+        if (s != NONE && count[s] < cap) {
+            target[i] = c;
+            load[s] += streams[i].rate;
+            ++count[s];
+        } else {
+            movers.push_back(i);
+        }
+    }
+    auto lightest = [&]() {
+        size_t best = NONE;
+        for (size_t s = 0; s < shared; ++s) {
+            if (count[s] >= cap) continue;
+            if (best == NONE || load[s] < load[best] || (load[s] == load[best] && count[s] < count[best])) best = s;
+        }
+        return best;
+    };
+    // Movers are in rate order already; beyond every connection's cap they stay unassigned
+    for (size_t i : movers) {
+        size_t s = lightest();
+        if (s == NONE) break;
+        target[i] = shared_ids[s];
+        load[s] += streams[i].rate;
+        ++count[s];
+    }
+
+    // Shed from the busiest to the lightest; moving less than the gap lowers the maximum
+    const double mean = shared > 0 ? std::accumulate(load.begin(), load.end(), 0.0) / shared : 0.0;
+    for (size_t moves = 0; moves < params.max_moves && shared > 1; ++moves) {
+        size_t busiest = static_cast<size_t>(std::max_element(load.begin(), load.end()) - load.begin());
+        if (load[busiest] <= mean * (1.0 + params.imbalance)) break;
+        size_t to = lightest();
+        if (to == NONE || to == busiest) break;
+        double gap = load[busiest] - load[to];
+        size_t pick = NONE;
+        for (size_t k = hot_count; k < n; ++k) {
+            size_t i = by_rate[k];
+            if (target[i] == shared_ids[busiest] && streams[i].rate > 0.0 && streams[i].rate < gap) {
+                pick = i;   // Hottest that fits
+                break;
+            }
+        }
+        if (pick == NONE) break;
+        target[pick] = shared_ids[to];
+        load[busiest] -= streams[pick].rate;
+        load[to] += streams[pick].rate;
+        --count[busiest];
+        ++count[to];
+    }
+    return target;
+}
+
+StreamSubscriptionManager::StreamSubscriptionManager(std::shared_ptr<Logger> logger,
+                                                     std::shared_ptr<IoRuntime> io_runtime,
+                                                     const nlohmann::json& config, Network::StreamHandler handler)
+    : logger_(logger), io_runtime_(io_runtime), config_(config), handler_(std::move(handler)) {
+    nlohmann::json sharding = config.value("stream_sharding", nlohmann::json::object());
+    params_.max_connections = std::max<size_t>(1, sharding.value("max_connections", params_.max_connections));
+    params_.max_streams_per_connection = sharding.value("max_streams_per_connection", params_.max_streams_per_connection);
+    params_.connection_target_rate = sharding.value("connection_target_rate", params_.connection_target_rate);
+    params_.hot_stream_rate = sharding.value("hot_stream_rate", params_.hot_stream_rate);
+    params_.imbalance = sharding.value("imbalance", params_.imbalance);
+    params_.max_moves = sharding.value("max_moves", params_.max_moves);
+    rebalance_interval_ = std::chrono::milliseconds(std::max(100, sharding.value("rebalance_ms", 10000)));
+    rate_halflife_sec_ = std::max(0.1, sharding.value("rate_halflife_sec", 30.0));
+
+    // Every shard opens one connection per feed; without a list, one to the exchange
+    for (const auto& feed : sharding.value("feeds", nlohmann::json::array())) {
+        feed_endpoints_.push_back(FeedEndpoint{
+            feed.value("host", config["exchange"]["websocket_host"].get<std::string>()),
+            feed.value("port", config["exchange"]["websocket_port"].get<std::string>())});
+    }
+    if (feed_endpoints_.empty()) {
+        feed_endpoints_.push_back(FeedEndpoint{config["exchange"]["websocket_host"].get<std::string>(),
+                                               config["exchange"]["websocket_port"].get<std::string>()});
+    }
+    if (feed_endpoints_.size() > 1) arbiter_ = std::make_unique<FeedArbiter>(feed_endpoints_.size());
+
+    for (size_t i = 0; i < params_.max_connections; ++i) {
+        connections_.push_back(std::make_unique<Connection>());
+        connections_.back()->index = i;
+        for (size_t f = 0; f < feed_endpoints_.size(); ++f) {
+            connections_.back()->feeds.push_back(std::make_unique<Feed>());
+        }
+    }
+}
+
+StreamSubscriptionManager::~StreamSubscriptionManager() {
+    stop();
+}
+
+void StreamSubscriptionManager::addStreams(const std::vector<std::string>& streams) {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        for (const auto& name : streams) {
+            auto& stream = streams_[name];
+            if (!stream) {
+                stream = std::make_unique<Stream>();
+                stream->name = name;
+            }
+        }
+    }
+    if (running_) {
+        boost::asio::post(lease_.context(), [this]() { rebalance(); });
+    }
+}
+
+void StreamSubscriptionManager::removeStreams(const std::vector<std::string>& streams) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    for (const auto& name : streams) {
+        auto it = streams_.find(name);
+        if (it == streams_.end()) continue;
+        for (auto& connection : connections_) {
+            bool erased;
+            {
+                std::lock_guard<std::mutex> connection_lock(connection->mutex);
+                erased = connection->streams.erase(name) > 0;
+            }
+            if (erased) changeSubscription(*connection, {name}, false);
+        }
+        // A message handler may still hold the stream; it is freed with the manager
+        retired_.push_back(std::move(it->second));
+        streams_.erase(it);
+    }
+}
+
+void StreamSubscriptionManager::start() {
+    if (running_.exchange(true)) return;
+    lease_ = io_runtime_->acquire("stream-subscriptions", 0.0);
+    rebalance_timer_ = std::make_unique<boost::asio::steady_timer>(lease_.context());
+    last_pass_ = std::chrono::steady_clock::now();
+    rebalance();    // Initial placement opens the connections
+    scheduleRebalance();
+}
+
+void StreamSubscriptionManager::stop() {
+    if (!running_.exchange(false)) return;
+
+    // The timer is cancelled on its own thread, as in BaseExchangeConnector::disconnect
+    auto cancel = [this]() { rebalance_timer_->cancel(); };
+    auto& context = lease_.context();
+    if (context.get_executor().running_in_this_thread() || !io_runtime_->isRunning()) {
+        cancel();
+    } else {
+        std::promise<void> cancelled;
+        boost::asio::post(context, [&]() {
+            cancel();
+            cancelled.set_value();
+        });
+        cancelled.get_future().wait();
+    }
+
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    for (auto& connection : connections_) {
+        if (connection->open) closeConnection(*connection);
+    }
+}
+
+void StreamSubscriptionManager::rebalance() {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last_pass_).count();
+    last_pass_ = now;
+    double alpha = elapsed > 0.0 ? 1.0 - std::exp2(-elapsed / rate_halflife_sec_) : 0.0;
+
+    std::vector<Stream*> order;
+    std::vector<StreamLoad> loads;
+    for (auto& [name, stream] : streams_) {
+        // Handovers the new connection hasn't claimed by now are of quiet streams; finish them,
+        // but only once it is subscribed, or the old one would unsubscribe with nothing to take over
+        size_t pending = stream->pending.load();
+        if (pending != NONE && isSubscribed(*connections_[pending])) completeHandover(*stream, pending);
+
+        uint64_t messages = stream->messages.exchange(0, std::memory_order_relaxed);
+        if (elapsed > 0.0) stream->rate += alpha * (messages / elapsed - stream->rate);
+
+        order.push_back(stream.get());
+        loads.push_back(StreamLoad{stream->rate, stream->owner.load()});
+    }
+
+    std::vector<size_t> targets = planStreamShards(loads, connections_.size(), params_);
+    std::vector<std::vector<std::string>> subscribe(connections_.size());
+    size_t unassigned = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        Stream& stream = *order[i];
+        size_t target = targets[i];
+        size_t owner = stream.owner.load();
+        if (target == NONE) {
+            if (owner == NONE) ++unassigned;
+            continue;
+        }
+        if (target == owner) continue;
+
+        Connection& connection = *connections_[target];
+        {
+            std::lock_guard<std::mutex> connection_lock(connection.mutex);
+            connection.streams[stream.name] = &stream;
+        }
+        if (owner == NONE) {
+            stream.owner = target;
+        } else {
+            stream.pending = target;    // The old connection delivers until the new one does
+            ++moves_;
+        }
+        subscribe[target].push_back(stream.name);
+    }
+    if (unassigned > 0 && logger_) {
+        logger_->getLogger()->warn("{} streams over the connection caps are not subscribed", unassigned);
+    }
+
+    for (auto& connection : connections_) {
+        bool has_streams;
+        {
+            std::lock_guard<std::mutex> connection_lock(connection->mutex);
+            has_streams = !connection->streams.empty();
+        }
+        if (has_streams && !connection->open) {
+            openConnection(*connection);    // Subscribes to everything on connect
+        } else if (has_streams && !subscribe[connection->index].empty()) {
+            changeSubscription(*connection, subscribe[connection->index], true);
+        } else if (!has_streams && connection->open) {
+            closeConnection(*connection);
+        }
+    }
+}
+
+nlohmann::json StreamSubscriptionManager::getStatus() const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    std::vector<double> rate(connections_.size(), 0.0);
+    std::vector<size_t> owned(connections_.size(), 0);
+    for (const auto& [name, stream] : streams_) {
+        size_t owner = stream->owner.load();
+        if (owner == NONE) continue;
+        rate[owner] += stream->rate;
+        ++owned[owner];
+    }
+    nlohmann::json connections = nlohmann::json::array();
+    for (const auto& connection : connections_) {
+        if (!connection->open && owned[connection->index] == 0) continue;
+        nlohmann::json feeds = nlohmann::json::array();
+        for (size_t i = 0; i < connection->feeds.size(); ++i) {
+            const Feed& feed = *connection->feeds[i];
+            auto network = std::atomic_load(&feed.network);
+            nlohmann::json entry = network ? network->getStats() : nlohmann::json::object();
+            entry["feed"] = i;
+            entry["drops"] = feed.drops;
+            feeds.push_back(entry);
+        }
+        connections.push_back({
+            {"index", connection->index},
+            {"open", connection->open.load()},
+            {"streams", owned[connection->index]},
+            {"rate", rate[connection->index]},
+            {"feeds", feeds}
+        });
+    }
+    nlohmann::json status = {{"running", running_.load()}, {"streams", streams_.size()}, {"moves", moves_},
+                             {"connections", connections}};
+    if (arbiter_) status["arbitration"] = arbiter_->toJson();
+    return status;
+}
+
+void StreamSubscriptionManager::onMessage(Connection& connection, size_t feed, const std::string& name,
+                                          const nlohmann::json& data) {
+    Stream* stream = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(connection.mutex);
+        auto it = connection.streams.find(name);
+        if (it != connection.streams.end()) stream = it->second;
+    }
+    if (!stream) return;    // Unsubscribed here; the owner delivers it
+
+    if (stream->owner.load() != connection.index) {
+        if (stream->pending.load() != connection.index) return;
+        completeHandover(*stream, connection.index);
+        if (stream->owner.load() != connection.index) return;
+    }
+    // Feeds, and the old and new connection around a handover, deliver on different
+    // threads; deciding and applying under the stream's lock keeps its updates in id order.
+    // With redundant feeds the first copy of each update wins.
+    std::lock_guard<std::mutex> lock(stream->sequence.mutex);
+    if (arbiter_ ? !arbiter_->accept(stream->sequence, feed, data) : !FeedArbiter::advance(stream->sequence, data)) {
+        return;
+    }
+    stream->messages.fetch_add(1, std::memory_order_relaxed);
+    handler_(name, data);
+}
+
+void StreamSubscriptionManager::completeHandover(Stream& stream, size_t to) {
+    // Delivery switches at the new connection's first message, so there is no gap; the
+    // old one's copies of updates already applied are dropped by id in onMessage
+    size_t from = stream.owner.load();
+    if (stream.pending.load() != to || from == to) return;
+    if (!stream.owner.compare_exchange_strong(from, to)) return;    // Lost to the other caller
+    stream.pending = NONE;
+    if (from == NONE) return;
+
+    Connection& old = *connections_[from];
+    {
+        std::lock_guard<std::mutex> lock(old.mutex);
+        old.streams.erase(stream.name);
+    }
+    changeSubscription(old, {stream.name}, false);
+}
+
+bool StreamSubscriptionManager::isSubscribed(const Connection& connection) const {
+    for (const auto& feed : connection.feeds) {
+        auto network = std::atomic_load(&feed->network);
+        if (network && network->isConnected()) return true;
+    }
+    return false;
+}
+
+void StreamSubscriptionManager::openConnection(Connection& connection) {
+    connection.open = true;
+    for (size_t i = 0; i < connection.feeds.size(); ++i) openFeed(connection, i);
+}
+
+void StreamSubscriptionManager::closeConnection(Connection& connection) {
+    connection.open = false;
+    for (auto& feed : connection.feeds) closeFeed(*feed);
+}
+
+void StreamSubscriptionManager::openFeed(Connection& connection, size_t index) {
+    // Always a fresh Network: a closed one may still be unwinding its last read. A shard's
+    // feeds lease separately, so they tend to land on different contexts.
+    Feed& feed = *connection.feeds[index];
+    Connection* target = &connection;
+    uint64_t generation = ++feed.generation;
+    std::string name = "stream-" + std::to_string(connection.index);
+    if (connection.feeds.size() > 1) name += static_cast<char>('a' + index % 26);
+    auto network = std::make_shared<Network>(logger_, nullptr, config_, io_runtime_->acquire(name));
+    network->setStreamHandler([this, target, index](const std::string& stream, const nlohmann::json& data) {
+        onMessage(*target, index, stream, data);
+    });
+    network->setSubscriptionProvider([this, target]() { return subscribedOn(*target); });
+    network->setDisconnectHandler([this, target, index, generation](const std::string& reason) {
+        boost::asio::post(lease_.context(), [this, target, index, generation, reason]() {
+            if (target->feeds[index]->generation.load() == generation) onDisconnect(*target, index, reason);
+        });
+    });
+    std::atomic_store(&feed.network, network);
+    network->run(feed_endpoints_[index].host, feed_endpoints_[index].port, "/stream");
+}
+
+void StreamSubscriptionManager::closeFeed(Feed& feed) {
+    ++feed.generation;      // Its disconnect is expected
+    // stop() only posts the close, which keeps the Network alive until it finishes; the
+    // other feeds on its context keep running meanwhile
+    auto network = std::atomic_exchange(&feed.network, std::shared_ptr<Network>());
+    if (network) network->stop();
+}
+
+void StreamSubscriptionManager::changeSubscription(Connection& connection, const std::vector<std::string>& streams,
+                                                   bool subscribe) {
+    for (auto& feed : connection.feeds) {
+        auto network = std::atomic_load(&feed->network);
+        if (!network) continue;     // Resubscribes to the current set when it reconnects
+        if (subscribe) {
+            network->subscribe(streams);
+        } else {
+            network->unsubscribe(streams);
+        }
+    }
+}
+
+void StreamSubscriptionManager::onDisconnect(Connection& connection, size_t index, const std::string& reason) {
+    // Network reconnects and resubscribes on its own; the shard's other feeds cover the gap
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (!running_ || !connection.open) return;
+    ++connection.feeds[index]->drops;
+    if (logger_) {
+        logger_->getLogger()->warn("Stream connection {} feed {} dropped ({}); reconnecting", connection.index, index,
+                                   reason);
+    }
+}
+
+void StreamSubscriptionManager::scheduleRebalance() {
+    rebalance_timer_->expires_after(rebalance_interval_);
+    rebalance_timer_->async_wait([this](const boost::system::error_code& ec) {
+        if (ec || !running_) return;
+        rebalance();
+        scheduleRebalance();
+    });
+}
+
+std::vector<std::string> StreamSubscriptionManager::subscribedOn(const Connection& connection) const {
+    std::lock_guard<std::mutex> lock(connection.mutex);
+    std::vector<std::string> streams;
+    streams.reserve(connection.streams.size());
+    for (const auto& [name, stream] : connection.streams) streams.push_back(name);
+    return streams;
+}
+
+} // namespace moneybot
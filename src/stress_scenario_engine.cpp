@@ -0,0 +1,262 @@
+#include "../include/stress_scenario_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+namespace moneybot {
+
+namespace {
+
+constexpr size_t SCENARIOS_PER_CHUNK = 64;
+
+std::string formatMove(double move) {
+    std::ostringstream oss;
+    oss << (move >= 0 ? "+" : "") << std::round(move * 1000.0) / 10.0 << "%";
+    return oss.str();
+}
+
+} // namespace
+
+StressScenarioEngine::StressScenarioEngine(size_t threads, double liquidation_bps)
+    : liquidation_bps_(liquidation_bps) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The calling thread works too, so spawn one fewer
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back(&StressScenarioEngine::workerLoop, this);
+    }
+}
+
+StressScenarioEngine::~StressScenarioEngine() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        stopping_ = true;
+    }
+    pool_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void StressScenarioEngine::loadScenarios(const nlohmann::json& j) {
+    {
+        std::lock_guard<std::mutex> lock(library_mutex_);
+        liquidation_bps_ = j.value("liquidation_bps", liquidation_bps_);
+    }
+
+    if (j.contains("scenarios")) {
+        for (const auto& s : j["scenarios"]) {
+            StressScenario scenario;
+            scenario.name = s.value("name", "scenario");
+            for (const auto& shock : s.value("shocks", nlohmann::json::array())) {
+                scenario.shocks.push_back({shock.value("match", "*"), shock.value("price", 0.0),
+                                           shock.value("vol", 1.0)});
+            }
+            addScenario(scenario);
+        }
+    }
+
+    if (j.contains("grid")) {
+        const auto& grid = j["grid"];
+        addGrid(grid.value("leader", "BTC"),
+                grid.value("leader_moves", std::vector<double>{}),
+                grid.value("follower_moves", std::vector<double>{}),
+                grid.value("vol_multipliers", std::vector<double>{1.0}));
+    }
+}
+
+uint32_t StressScenarioEngine::internPattern(const std::string& match) {
+    auto it = std::find(patterns_.begin(), patterns_.end(), match);
+    if (it != patterns_.end()) return static_cast<uint32_t>(it - patterns_.begin());
+    patterns_.push_back(match);
+    return static_cast<uint32_t>(patterns_.size() - 1);
+}
+
+void StressScenarioEngine::addScenario(const StressScenario& scenario) {
+    std::lock_guard<std::mutex> lock(library_mutex_);
+
+    std::vector<CompiledShock> compiled;
+    compiled.reserve(scenario.shocks.size());
+    for (const auto& shock : scenario.shocks) {
+        compiled.push_back({internPattern(shock.match), 1.0 + shock.price_change, shock.vol_multiplier});
+    }
+    names_.push_back(scenario.name);
+    shocks_.push_back(std::move(compiled));
+}
+
+void StressScenarioEngine::addGrid(const std::string& leader, const std::vector<double>& leader_moves,
+                                   const std::vector<double>& follower_moves,
+                                   const std::vector<double>& vol_multipliers) {
+    for (double leader_move : leader_moves) {
+        for (double follower_move : follower_moves) {
+            for (double vol : vol_multipliers) {
+                StressScenario scenario;
+                scenario.name = leader + " " + formatMove(leader_move) + " / others " +
+                                formatMove(follower_move) + " / vol x" + std::to_string(vol).substr(0, 4);
+                scenario.shocks.push_back({leader, leader_move, vol});
+                scenario.shocks.push_back({"*", follower_move, vol});
+                addScenario(scenario);
+            }
+        }
+    }
+}
+
+size_t StressScenarioEngine::scenarioCount() const {
+    std::lock_guard<std::mutex> lock(library_mutex_);
+    return names_.size();
+}
+
+void StressScenarioEngine::workerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        std::function<void(size_t)> task;
+        size_t chunks = 0;
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex_);
+            pool_cv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+            task = task_;
+            chunks = task_chunks_;
+        }
+
+        for (size_t chunk = next_chunk_.fetch_add(1); chunk < chunks; chunk = next_chunk_.fetch_add(1)) {
+            task(chunk);
+        }
+
+        // Every worker checks in before the run returns, so no one can pick up a
+        // chunk index from the next run with this run's task
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (++workers_done_ == workers_.size()) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void StressScenarioEngine::runParallel(size_t chunks, const std::function<void(size_t)>& task) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        task_ = task;
+        task_chunks_ = chunks;
+        workers_done_ = 0;
+        next_chunk_.store(0);
+        generation_++;
+    }
+    pool_cv_.notify_all();
+
+    for (size_t chunk = next_chunk_.fetch_add(1); chunk < chunks; chunk = next_chunk_.fetch_add(1)) {
+        task(chunk);
+    }
+
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    done_cv_.wait(lock, [&] { return workers_done_ == workers_.size(); });
+    task_ = nullptr;
+}
+
+StressReport StressScenarioEngine::run(const std::vector<StressPosition>& positions, size_t worst_n) {
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    std::lock_guard<std::mutex> library_lock(library_mutex_);
+    auto start = std::chrono::steady_clock::now();
+
+    const size_t scenario_count = names_.size();
+    const size_t position_count = positions.size();
+
+    // Position exposures and pattern matches, resolved once per run
+    std::vector<double> exposure(position_count);
+    for (size_t p = 0; p < position_count; ++p) {
+        exposure[p] = positions[p].quantity * positions[p].price;
+    }
+    std::vector<uint8_t> matches(patterns_.size() * position_count, 0);
+    for (size_t k = 0; k < patterns_.size(); ++k) {
+        for (size_t p = 0; p < position_count; ++p) {
+            const std::string& pattern = patterns_[k];
+            matches[k * position_count + p] =
+                pattern == "*" || positions[p].symbol.compare(0, pattern.size(), pattern) == 0;
+        }
+    }
+
+    // Each scenario writes only its own slot
+    std::vector<double> pnl(scenario_count, 0.0);
+    std::vector<double> liquidation(scenario_count, 0.0);
+    const double liquidation_rate = liquidation_bps_ / 10000.0;
+
+    auto evaluateChunk = [&](size_t chunk) {
+        size_t end = std::min(scenario_count, (chunk + 1) * SCENARIOS_PER_CHUNK);
+        for (size_t s = chunk * SCENARIOS_PER_CHUNK; s < end; ++s) {
+            const auto& shocks = shocks_[s];
+            double scenario_pnl = 0.0;
+            double scenario_cost = 0.0;
+            for (size_t p = 0; p < position_count; ++p) {
+                double price_multiplier = 1.0;
+                double vol_multiplier = 1.0;
+                for (const auto& shock : shocks) {
+                    if (matches[shock.pattern * position_count + p]) {
+                        price_multiplier = shock.price_multiplier;
+                        vol_multiplier = shock.vol_multiplier;
+                        break;
+                    }
+                }
+                double shocked = exposure[p] * price_multiplier;
+                scenario_pnl += shocked - exposure[p];
+                scenario_cost += std::abs(shocked) * liquidation_rate * vol_multiplier;
+            }
+            pnl[s] = scenario_pnl;
+            liquidation[s] = scenario_cost;
+        }
+    };
+
+    size_t chunks = (scenario_count + SCENARIOS_PER_CHUNK - 1) / SCENARIOS_PER_CHUNK;
+    if (chunks > 1 && !workers_.empty()) {
+        runParallel(chunks, evaluateChunk);
+    } else {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) evaluateChunk(chunk);
+    }
+
+    // Rank
+    StressReport report;
+    report.scenarios = scenario_count;
+    std::vector<size_t> order(scenario_count);
+    std::iota(order.begin(), order.end(), 0);
+    auto total = [&](size_t s) { return pnl[s] - liquidation[s]; };
+    size_t keep = std::min(worst_n, scenario_count);
+    std::partial_sort(order.begin(), order.begin() + keep, order.end(),
+                      [&](size_t a, size_t b) { return total(a) < total(b); });
+    for (size_t i = 0; i < keep; ++i) {
+        size_t s = order[i];
+        report.worst.push_back({names_[s], pnl[s], liquidation[s], total(s)});
+    }
+    if (scenario_count > 0) {
+        double sum = 0.0;
+        for (size_t s = 0; s < scenario_count; ++s) sum += total(s);
+        report.mean_total = sum / scenario_count;
+        report.worst_loss = std::min(0.0, total(order[0]));
+    }
+
+    report.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+nlohmann::json StressScenarioEngine::toJson(const StressReport& report) {
+    nlohmann::json worst = nlohmann::json::array();
+    for (const auto& result : report.worst) {
+        worst.push_back({
+            {"name", result.name},
+            {"pnl", result.pnl},
+            {"liquidation_cost", result.liquidation_cost},
+            {"total", result.total}
+        });
+    }
+    return {
+        {"scenarios", report.scenarios},
+        {"worst_loss", report.worst_loss},
+        {"mean_total", report.mean_total},
+        {"elapsed_us", report.elapsed_us},
+        {"worst", worst}
+    };
+}
+
+} // namespace moneybot
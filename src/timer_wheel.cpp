@@ -0,0 +1,323 @@
+#include "timer_wheel.h"
+#include <algorithm>
+#include <exception>
+
+namespace moneybot {
+
+uint64_t TimerWheel::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::chrono::steady_clock::time_point TimerWheel::toTimePoint(uint64_t ms) {
+    return std::chrono::steady_clock::time_point(std::chrono::milliseconds(ms));
+}
+
+TimerWheel::TimerWheel(uint64_t now_ms) : current_(now_ms) {
+    for (auto& level : heads_) level.fill(NIL);
+}
+
+TimerWheel::TimerId TimerWheel::makeId(int32_t index, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(index);
+}
+
+int32_t TimerWheel::allocate() {
+    if (!free_.empty()) {
+        int32_t index = free_.back();
+        free_.pop_back();
+        return index;
+    }
+    nodes_.emplace_back();
+    return static_cast<int32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::release(int32_t index) {
+    Node& node = nodes_[index];
+    node.callback = nullptr;
+    node.state = NodeState::FREE;
+    if (++node.generation == 0) node.generation = 1; // Ids are never INVALID_TIMER
+    free_.push_back(index);
+}
+
+void TimerWheel::place(int32_t index) {
+    Node& node = nodes_[index];
+    uint64_t at = std::max(node.expiry, current_);
+    uint64_t delta = at - current_;
+
+    // Innermost level whose span covers the delay
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    uint32_t slot = (at >> (SLOT_BITS * level)) & SLOT_MASK;
+
+    node.level = static_cast<uint8_t>(level);
+    node.slot = static_cast<uint8_t>(slot);
+    node.prev = NIL;
+    node.next = heads_[level][slot];
+    if (node.next != NIL) nodes_[node.next].prev = index;
+    heads_[level][slot] = index;
+    ++level_counts_[level];
+}
+
+void TimerWheel::unlink(int32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.level][node.slot] = node.next;
+    }
+    if (node.next != NIL) nodes_[node.next].prev = node.prev;
+    node.prev = node.next = NIL;
+    --level_counts_[node.level];
+}
+
+TimerWheel::TimerId TimerWheel::schedule(uint64_t delay_ms, Callback callback) {
+    return scheduleAt(current_ + delay_ms, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::scheduleEvery(uint64_t interval_ms, Callback callback) {
+    interval_ms = std::max<uint64_t>(interval_ms, 1);
+    return scheduleAt(current_ + interval_ms, std::move(callback), interval_ms);
+}
+
+TimerWheel::TimerId TimerWheel::scheduleAt(uint64_t expiry_ms, Callback callback, uint64_t interval_ms) {
+    constexpr uint64_t max_delay = (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    expiry_ms = std::clamp(expiry_ms, current_ + 1, current_ + max_delay);
+
+    int32_t index = allocate();
+    Node& node = nodes_[index];
+    node.expiry = expiry_ms;
+    node.interval = std::min(interval_ms, max_delay);
+    node.callback = std::move(callback);
+    node.state = NodeState::PENDING;
+    place(index);
+    ++active_;
+    return makeId(index, node.generation);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    int32_t index = static_cast<int32_t>(id & 0xffffffffu);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (id == INVALID_TIMER || index < 0 || index >= static_cast<int32_t>(nodes_.size())) return false;
+
+    Node& node = nodes_[index];
+    if (node.generation != generation) return false;
+    if (node.state == NodeState::PENDING) {
+        unlink(index);
+        release(index);
+        --active_;
+        return true;
+    }
+    if (node.state == NodeState::FIRING && node.interval > 0) {
+        // Periodic timer cancelling itself from its callback; don't re-arm
+        node.state = NodeState::CANCELLED;
+        --active_;
+        return true;
+    }
+    return false;
+}
+
+void TimerWheel::cascade(int level) {
+    uint32_t slot = (current_ >> (SLOT_BITS * level)) & SLOT_MASK;
+    int32_t index = heads_[level][slot];
+    heads_[level][slot] = NIL;
+    while (index != NIL) {
+        int32_t next = nodes_[index].next;
+        --level_counts_[level];
+        place(index);
+        index = next;
+    }
+}
+
+size_t TimerWheel::fireSlot(uint32_t slot) {
+    size_t fired = 0;
+    std::exception_ptr error;
+    int32_t index;
+    while ((index = heads_[0][slot]) != NIL) {
+        unlink(index);
+        bool periodic = nodes_[index].interval > 0;
+        nodes_[index].state = NodeState::FIRING;
+        if (!periodic) --active_;
+
+        // The callback may schedule timers and reallocate nodes_; hold no references across it
+        Callback callback = std::move(nodes_[index].callback);
+        try {
+            callback();
+        } catch (...) {
+            // The timer is still settled below and the rest of the slot runs; the first error
+            // is rethrown once the slot is done
+            if (!error) error = std::current_exception();
+        }
+        ++fired;
+
+        Node& node = nodes_[index];
+        if (node.state == NodeState::FIRING && periodic) {
+            node.callback = std::move(callback);
+            node.expiry += node.interval;
+            if (node.expiry <= current_) {
+                node.expiry = current_ + node.interval; // Fell behind; skip the missed runs
+            }
+            node.state = NodeState::PENDING;
+            place(index);
+        } else {
+            release(index);
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    return fired;
+}
+
+size_t TimerWheel::advance(uint64_t now_ms) {
+    size_t fired = 0;
+    while (current_ < now_ms) {
+        if (active_ == 0) {
+            current_ = now_ms;
+            break;
+        }
+        if (level_counts_[0] == 0) {
+            // Nothing can fire before the next level-0 wrap
+            uint64_t boundary = (current_ | SLOT_MASK) + 1;
+            if (boundary > now_ms) {
+                current_ = now_ms;
+                break;
+            }
+            current_ = boundary - 1;
+        }
+
+        ++current_;
+        if ((current_ & SLOT_MASK) == 0) {
+            // Cascade outermost first so timers can drop more than one level at once
+            int top = 1;
+            while (top < LEVELS - 1 && ((current_ >> (SLOT_BITS * top)) & SLOT_MASK) == 0) {
+                ++top;
+            }
+            for (int level = top; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+        fired += fireSlot(current_ & SLOT_MASK);
+    }
+    return fired;
+}
+
+uint64_t TimerWheel::nextExpiry() const {
+    if (active_ == 0) return NEVER;
+
+    uint64_t next = NEVER;
+    bool outer = false;
+    for (int level = 1; level < LEVELS; ++level) {
+        outer = outer || level_counts_[level] > 0;
+    }
+    if (outer) {
+        next = (current_ | SLOT_MASK) + 1;
+    }
+    if (level_counts_[0] > 0) {
+        for (uint64_t tick = current_ + 1; tick <= current_ + SLOTS && tick < next; ++tick) {
+            if (heads_[0][tick & SLOT_MASK] != NIL) return tick;
+        }
+    }
+    return next;
+}
+
+TimerService::~TimerService() {
+    stop();
+}
+
+void TimerService::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    stopping_ = false;
+    thread_ = std::thread(&TimerService::run, this);
+}
+
+void TimerService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    wheel_ = TimerWheel();
+    due_.clear();
+}
+
+TimerWheel::TimerId TimerService::schedule(uint64_t delay_ms, TimerWheel::Callback callback) {
+    TimerWheel::TimerId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // The wheel only advances when the thread wakes; anchor to real time instead,
+        // rounded up a tick so timers never fire early
+        id = add(TimerWheel::nowMs() + delay_ms + 1, std::move(callback), 0);
+    }
+    cv_.notify_all();
+    return id;
+}
+
+TimerWheel::TimerId TimerService::scheduleEvery(uint64_t interval_ms, TimerWheel::Callback callback) {
+    TimerWheel::TimerId id;
+    interval_ms = std::max<uint64_t>(interval_ms, 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = add(TimerWheel::nowMs() + interval_ms + 1, std::move(callback), interval_ms);
+    }
+    cv_.notify_all();
+    return id;
+}
+
+TimerWheel::TimerId TimerService::add(uint64_t expiry_ms, TimerWheel::Callback callback, uint64_t interval_ms) {
+    // The wheel only queues the timer as due; run() calls it once the lock is released
+    auto entry = std::make_shared<Due>();
+    entry->callback = std::move(callback);
+    entry->id = wheel_.scheduleAt(expiry_ms, [this, entry]() { due_.push_back(entry); }, interval_ms);
+    return entry->id;
+}
+
+bool TimerService::cancel(TimerWheel::TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool cancelled = wheel_.cancel(id);
+    // Due but not yet run: skip it
+    for (auto& entry : due_) {
+        if (entry->id == id && !entry->cancelled) {
+            entry->cancelled = true;
+            cancelled = true;
+        }
+    }
+    return cancelled;
+}
+
+size_t TimerService::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wheel_.size();
+}
+
+void TimerService::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        wheel_.advance(TimerWheel::nowMs());
+        // Callbacks run unlocked so they can schedule and cancel, and so callers aren't held
+        // up behind them; cancel() may still skip one that hasn't started
+        while (!due_.empty() && !stopping_) {
+            std::shared_ptr<Due> entry = std::move(due_.front());
+            due_.pop_front();
+            if (entry->cancelled) continue;
+            lock.unlock();
+            entry->callback();
+            lock.lock();
+        }
+        if (stopping_) break;
+        uint64_t next = wheel_.nextExpiry();
+        if (next == TimerWheel::NEVER) {
+            cv_.wait(lock);
+        } else {
+            cv_.wait_until(lock, TimerWheel::toTimePoint(next));
+        }
+    }
+}
+
+} // namespace moneybot
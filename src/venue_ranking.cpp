@@ -0,0 +1,65 @@
+#include "venue_ranking.h"
+#include <utility>
+
+namespace moneybot {
+
+uint32_t VenueRanking::update(const std::string& exchange, double bid_price, double bid_size,
+                              double ask_price, double ask_size,
+                              std::chrono::steady_clock::time_point now) {
+    uint32_t index = 0;
+    while (index < venues_.size() && venues_[index].exchange != exchange) ++index;
+    if (index == venues_.size()) {
+        venues_.push_back(VenueQuote{exchange});
+        bid_order_.push_back(index);
+        ask_order_.push_back(index);
+    }
+
+    VenueQuote& quote = venues_[index];
+    quote.bid_price = bid_price > 0.0 ? bid_price : 0.0;
+    quote.bid_size = bid_size;
+    quote.ask_price = ask_price > 0.0 ? ask_price : 0.0;
+    quote.ask_size = ask_size;
+    quote.updated = now;
+
+    reposition(bid_order_, index, [this](uint32_t a, uint32_t b) { return bidBetter(a, b); });
+    reposition(ask_order_, index, [this](uint32_t a, uint32_t b) { return askBetter(a, b); });
+    return index;
+}
+
+const VenueQuote* VenueRanking::bestBid() const {
+    if (bid_order_.empty() || venues_[bid_order_.front()].bid_price <= 0.0) return nullptr;
+    return &venues_[bid_order_.front()];
+}
+
+const VenueQuote* VenueRanking::bestAsk() const {
+    if (ask_order_.empty() || venues_[ask_order_.front()].ask_price <= 0.0) return nullptr;
+    return &venues_[ask_order_.front()];
+}
+
+bool VenueRanking::bidBetter(uint32_t a, uint32_t b) const {
+    // Empty sides rank last
+    return venues_[a].bid_price > venues_[b].bid_price;
+}
+
+bool VenueRanking::askBetter(uint32_t a, uint32_t b) const {
+    double pa = venues_[a].ask_price, pb = venues_[b].ask_price;
+    if (pa <= 0.0) return false;
+    return pb <= 0.0 || pa < pb;
+}
+
+template <typename Better>
+void VenueRanking::reposition(std::vector<uint32_t>& order, uint32_t venue, Better better) {
+    size_t pos = 0;
+    while (order[pos] != venue) ++pos;
+    // Only this venue moved, so one directional pass of swaps restores the order
+    while (pos > 0 && better(order[pos], order[pos - 1])) {
+        std::swap(order[pos], order[pos - 1]);
+        --pos;
+    }
+    while (pos + 1 < order.size() && better(order[pos + 1], order[pos])) {
+        std::swap(order[pos], order[pos + 1]);
+        ++pos;
+    }
+}
+
+} // namespace moneybot
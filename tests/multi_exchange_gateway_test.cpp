@@ -0,0 +1,226 @@
+// Routes parent orders through MultiExchangeGateway against stubbed connectors.
+#include "multi_exchange_gateway.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace moneybot;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+bool near(double a, double b, double tolerance = 1e-9) {
+    return std::fabs(a - b) <= tolerance;
+}
+
+// Fills every child in full at its limit price and records what it was sent
+class StubConnector : public ExchangeConnector {
+public:
+    StubConnector(std::string name, std::shared_ptr<Logger> logger, std::vector<ExchangeBalance> balances = {})
+        : name_(std::move(name)), logger_(std::move(logger)), balances_(std::move(balances)) {}
+
+    void connect() override { connected_ = true; }
+    void disconnect() override { connected_ = false; }
+    bool isConnected() const override { return connected_; }
+
+    std::string placeOrder(const Order& order) override { return executeOrder(order).order_id; }
+    bool cancelOrder(const std::string&) override { return true; }
+    ChildExecution executeOrder(const Order& order) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        children_.push_back(order);
+        ChildExecution execution;
+        execution.order_id = name_ + "_" + std::to_string(children_.size());
+        OrderFill fill;
+        fill.order_id = execution.order_id;
+        fill.price = order.price;
+        fill.quantity = order.quantity;
+        execution.fills.push_back(fill);
+        return execution;
+    }
+
+    OrderBook getOrderBook(const std::string&) const override { return OrderBook(logger_); }
+    ExchangeBalance getBalance(const std::string& asset) const override {
+        for (const auto& balance : balances_) {
+            if (balance.asset == asset) return balance;
+        }
+        return ExchangeBalance{asset};
+    }
+    std::vector<ExchangeBalance> getBalances() const override { return balances_; }
+    std::vector<std::string> getAvailableSymbols() const override { return {"BTCUSDT"}; }
+
+    void setOrderBookCallback(std::function<void(const std::string&, const OrderBook&)> callback) override {
+        book_callback_ = std::move(callback);
+    }
+    void setTradeCallback(std::function<void(const Trade&)>) override {}
+
+    double getLatency() const override { return 1.0; }
+    std::string getExchangeName() const override { return name_; }
+
+    // One ask level and one bid level, as if the venue had pushed them
+    void pushBook(const std::string& symbol, double bid, double ask, double size) {
+        OrderBook book(logger_);
+        auto level = [](double price, double quantity) {
+            return nlohmann::json::array({nlohmann::json::array({std::to_string(price), std::to_string(quantity)})});
+        };
+        book.update({{"s", symbol}, {"E", 0}, {"bids", level(bid, size)}, {"asks", level(ask, size)}});
+        book_callback_(symbol, book);
+    }
+
+    std::vector<Order> children() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return children_;
+    }
+
+private:
+    std::string name_;
+    std::shared_ptr<Logger> logger_;
+    std::vector<ExchangeBalance> balances_;
+    std::atomic<bool> connected_{false};
+    std::function<void(const std::string&, const OrderBook&)> book_callback_;
+    mutable std::mutex mutex_;
+    std::vector<Order> children_;
+};
+
+ExchangeBalance balance(const std::string& asset, double available) {
+    ExchangeBalance result;
+    result.asset = asset;
+    result.available = available;
+    result.total = available;
+    return result;
+}
+
+Order marketBuy(const std::string& symbol, double quantity) {
+    Order order;
+    order.symbol = symbol;
+    order.side = OrderSide::BUY;
+    order.type = OrderType::MARKET;
+    order.quantity = quantity;
+    return order;
+}
+
+double routedTo(const StubConnector& venue) {
+    double quantity = 0.0;
+    for (const auto& child : venue.children()) quantity += child.quantity;
+    return quantity;
+}
+
+// Balances nobody has reported leave the venues uncapped
+void testRoutesWithoutKnownBalances(std::shared_ptr<Logger> logger) {
+    MultiExchangeGateway gateway({}, logger);
+    auto a = std::make_unique<StubConnector>("A", logger);
+    auto b = std::make_unique<StubConnector>("B", logger);
+    StubConnector* venue_a = a.get();
+    StubConnector* venue_b = b.get();
+    gateway.setConnector("A", std::move(a));
+    gateway.setConnector("B", std::move(b));
+    gateway.start();
+
+    venue_a->pushBook("BTCUSDT", 99.0, 100.0, 1.0);
+    venue_b->pushBook("BTCUSDT", 99.0, 100.5, 1.0);
+
+    RouteReport report = gateway.routeOrder(marketBuy("BTCUSDT", 1.5));
+    CHECK(near(report.plan.routed, 1.5));
+    CHECK(near(report.filled_quantity, 1.5));
+    CHECK(near(routedTo(*venue_a), 1.0));
+    CHECK(near(routedTo(*venue_b), 0.5));
+    gateway.stop();
+}
+
+// A reported balance caps its venue and the remainder moves to the next one
+void testBalanceCapsVenue(std::shared_ptr<Logger> logger) {
+    MultiExchangeGateway gateway({}, logger);
+    auto a = std::make_unique<StubConnector>("A", logger, std::vector<ExchangeBalance>{balance("USDT", 50.0)});
+    auto b = std::make_unique<StubConnector>("B", logger, std::vector<ExchangeBalance>{balance("USDT", 1000.0)});
+    StubConnector* venue_a = a.get();
+    StubConnector* venue_b = b.get();
+    gateway.setConnector("A", std::move(a));
+    gateway.setConnector("B", std::move(b));
+    gateway.start();
+
+    // The first reconcile runs on the gateway's timer thread
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((gateway.getBalance("A", "USDT").total == 0.0 || gateway.getBalance("B", "USDT").total == 0.0) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(near(gateway.getBalance("A", "USDT").available, 50.0));
+    CHECK(near(gateway.getTotalBalance("USDT"), 1050.0));
+
+    venue_a->pushBook("BTCUSDT", 99.0, 100.0, 1.0);
+    venue_b->pushBook("BTCUSDT", 99.0, 100.5, 1.0);
+
+    RouteReport report = gateway.routeOrder(marketBuy("BTCUSDT", 1.0));
+    CHECK(near(report.plan.routed, 1.0));
+    double spent_a = 0.0;
+    for (const auto& child : venue_a->children()) spent_a += child.quantity * child.price * (1.0 + 0.001);
+    CHECK(spent_a <= 50.0 + 1e-6);
+    CHECK(routedTo(*venue_a) > 0.0);
+    CHECK(near(routedTo(*venue_a) + routedTo(*venue_b), 1.0));
+    gateway.stop();
+}
+
+// Cycles are found on the graph worker, off the book path
+void testCycleReportedFromWorker(std::shared_ptr<Logger> logger) {
+    MultiExchangeGateway gateway({}, logger);
+    auto a = std::make_unique<StubConnector>("A", logger);
+    StubConnector* venue_a = a.get();
+    gateway.setConnector("A", std::move(a));
+
+    std::mutex mutex;
+    std::vector<ArbitrageCycle> cycles;
+    std::thread::id callback_thread;
+    gateway.setArbitrageCycleCallback([&](const ArbitrageCycle& cycle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cycles.push_back(cycle);
+        callback_thread = std::this_thread::get_id();
+    });
+    gateway.start();
+
+    // USDT -> BTC -> ETH -> USDT returns about 4% before fees
+    venue_a->pushBook("BTCUSDT", 99.99, 100.0, 10.0);
+    venue_a->pushBook("ETHBTC", 0.0499, 0.05, 100.0);
+    venue_a->pushBook("ETHUSDT", 5.2, 5.21, 100.0);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!cycles.empty() || std::chrono::steady_clock::now() >= deadline) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(cycles.size() == 1);
+        CHECK(callback_thread != std::this_thread::get_id());
+        if (!cycles.empty()) CHECK(cycles.front().legs.size() == 3);
+    }
+    CHECK(gateway.findArbitrageCycles().size() == 1);
+    gateway.stop();
+}
+
+} // namespace
+
+int main() {
+    auto logger = std::make_shared<Logger>();
+    testRoutesWithoutKnownBalances(logger);
+    testBalanceCapsVenue(logger);
+    testCycleReportedFromWorker(logger);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "multi_exchange_gateway_test passed" << std::endl;
+    return 0;
+}
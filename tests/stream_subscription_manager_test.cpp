@@ -0,0 +1,170 @@
+// Retires a StreamSubscriptionManager feed while another keeps delivering, against a
+// local TLS WebSocket server that never answers a close.
+#include "stream_subscription_manager.h"
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace moneybot;
+namespace net = boost::asio;
+namespace beast = boost::beast;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+template <typename Pred>
+bool waitFor(Pred pred, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+// Self-signed P-256 certificate for 127.0.0.1; the client does not verify it
+void useSelfSignedCertificate(net::ssl::context& ctx) {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+    SSL_CTX_use_certificate(ctx.native_handle(), cert);
+    SSL_CTX_use_PrivateKey(ctx.native_handle(), key);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+}
+
+// Combined-stream server: reads each session's SUBSCRIBE, then only writes an update
+// for every subscribed stream every few milliseconds. It never reads again, so a
+// client's close frame goes unanswered, as with a stuck peer.
+class StuckPeerServer {
+public:
+    StuckPeerServer() : ssl_ctx_(net::ssl::context::tlsv12_server), acceptor_(ioc_, {net::ip::make_address("127.0.0.1"), 0}) {
+        useSelfSignedCertificate(ssl_ctx_);
+        net::co_spawn(ioc_, accept(), net::detached);
+        thread_ = std::thread([this]() { ioc_.run(); });
+    }
+    ~StuckPeerServer() {
+        ioc_.stop();
+        thread_.join();
+    }
+
+    std::string port() const { return std::to_string(acceptor_.local_endpoint().port()); }
+    int sessionsEnded() const { return ended_.load(); }
+
+private:
+    using Stream = beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+
+    net::awaitable<void> accept() {
+        for (;;) {
+            auto socket = co_await acceptor_.async_accept(net::use_awaitable);
+            net::co_spawn(ioc_, session(std::make_shared<Stream>(std::move(socket), ssl_ctx_)), net::detached);
+        }
+    }
+
+    net::awaitable<void> session(std::shared_ptr<Stream> ws) {
+        try {
+            co_await ws->next_layer().async_handshake(net::ssl::stream_base::server, net::use_awaitable);
+            co_await ws->async_accept(net::use_awaitable);
+            beast::flat_buffer buffer;
+            co_await ws->async_read(buffer, net::use_awaitable);
+            auto subscribe = nlohmann::json::parse(beast::buffers_to_string(buffer.data()));
+            std::vector<std::string> streams = subscribe["params"].get<std::vector<std::string>>();
+            net::steady_timer timer(co_await net::this_coro::executor);
+            for (uint64_t id = 1;; ++id) {
+                for (const auto& stream : streams) {
+                    nlohmann::json update = {{"stream", stream}, {"data", {{"u", id}}}};
+                    co_await ws->async_write(net::buffer(update.dump()), net::use_awaitable);
+                }
+                timer.expires_after(std::chrono::milliseconds(2));
+                co_await timer.async_wait(net::use_awaitable);
+            }
+        } catch (const std::exception&) {
+        }
+        ++ended_;
+    }
+
+    net::io_context ioc_;
+    net::ssl::context ssl_ctx_;
+    net::ip::tcp::acceptor acceptor_;
+    std::atomic<int> ended_{0};
+    std::thread thread_;
+};
+
+// Both shards share one I/O thread; retiring one must not hold it up for the other
+void testRetiredFeedDoesNotStallOthers(std::shared_ptr<Logger> logger) {
+    StuckPeerServer server;
+    nlohmann::json config = {
+        {"exchange", {{"websocket_host", "127.0.0.1"}, {"websocket_port", server.port()},
+                      {"user_agent", "moneybot-test"},
+                      {"websocket_subscription", {{"method", "SUBSCRIBE"}, {"params", nlohmann::json::array()}, {"id", 1}}}}},
+        {"stream_sharding", {{"max_connections", 2}, {"max_streams_per_connection", 1}, {"rebalance_ms", 60000}}},
+        {"io", {{"contexts", 1}, {"pin_threads", false}}}
+    };
+    auto runtime = std::make_shared<IoRuntime>(logger, config);
+    runtime->start();
+
+    std::atomic<uint64_t> kept{0}, retired{0};
+    StreamSubscriptionManager manager(logger, runtime, config, [&](const std::string& stream, const nlohmann::json&) {
+        ++(stream == "kept@depth" ? kept : retired);
+    });
+    manager.addStreams({"kept@depth", "retired@depth"});
+    manager.start();
+    CHECK(waitFor([&]() { return kept.load() >= 10 && retired.load() >= 10; }));
+
+    // Its connection has no streams left, so the pass closes its feed
+    manager.removeStreams({"retired@depth"});
+    manager.rebalance();
+    uint64_t retired_at_close = retired.load();
+    uint64_t kept_at_close = kept.load();
+    CHECK(waitFor([&]() { return kept.load() >= kept_at_close + 50; }, std::chrono::seconds(1)));
+    CHECK(retired.load() == retired_at_close);
+
+    // The unanswered close gives up at its deadline and drops the connection
+    CHECK(waitFor([&]() { return server.sessionsEnded() == 1; }));
+    uint64_t kept_after_deadline = kept.load();
+    CHECK(waitFor([&]() { return kept.load() >= kept_after_deadline + 50; }, std::chrono::seconds(1)));
+
+    manager.stop();
+    runtime->stop();
+}
+
+} // namespace
+
+int main() {
+    auto logger = std::make_shared<Logger>();
+    testRetiredFeedDoesNotStallOthers(logger);
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "stream_subscription_manager_test passed" << std::endl;
+    return 0;
+}